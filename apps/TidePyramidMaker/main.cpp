@@ -0,0 +1,94 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "tide/core/data/TiffPyramidWriter.h"
+#include "tide/core/utils/CommandLineParser.h"
+
+#include <QCoreApplication>
+
+#include <iostream>
+
+class PyramidMakerOptions : public CommandLineParser
+{
+public:
+    PyramidMakerOptions()
+    {
+        using boost::program_options::value;
+
+        pos_desc.add("source", 1);
+        pos_desc.add("target", 1);
+        desc.add_options()("source", value<std::string>()->required(),
+                           "The source image to convert");
+        desc.add_options()("target", value<std::string>()->required(),
+                           "The target .tiff image pyramid file to create");
+        desc.add_options()("tile-size", value<uint>()->default_value(512),
+                           "Size of the tiles (multiple of 16)");
+        desc.add_options()("quality", value<int>()->default_value(90),
+                           "Quality of the JPEG compression [1-100]");
+    }
+    std::string source() const { return vm["source"].as<std::string>(); }
+    std::string target() const { return vm["target"].as<std::string>(); }
+    uint tileSize() const { return vm["tile-size"].as<uint>(); }
+    int quality() const { return vm["quality"].as<int>(); }
+};
+
+int main(int argc, char* argv[])
+{
+    COMMAND_LINE_PARSER_CHECK(PyramidMakerOptions, "tidePyramidMaker");
+
+    QCoreApplication app{argc, argv};
+
+    try
+    {
+        auto writer =
+            TiffPyramidWriter{commandLine.tileSize(), commandLine.quality()};
+        writer.setProgressCallback([](const double progress) {
+            std::cout << "\r" << int(progress * 100) << "%" << std::flush;
+        });
+        writer.write(QString::fromStdString(commandLine.source()),
+                     QString::fromStdString(commandLine.target()));
+        std::cout << std::endl;
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << std::endl << e.what() << std::endl;
+    }
+    return EXIT_FAILURE;
+}
@@ -44,6 +44,7 @@
 #include "utils/CommandLineParser.h"
 #include "utils/log.h"
 
+#include <QGuiApplication>
 #include <QThreadPool>
 
 #include <memory>
@@ -75,6 +76,9 @@ int main(int argc, char* argv[])
 
     setupEnvVariables();
 
+    // Upload the textures once for all the screens (windows) of the process
+    QGuiApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
+
     {
         auto worldComm = MPICommunicator{argc, argv};
         if (worldComm.getSize() < 2)
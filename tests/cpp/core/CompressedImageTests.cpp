@@ -0,0 +1,140 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE CompressedImageTests
+#include <boost/test/unit_test.hpp>
+
+#include "data/CompressedImage.h"
+
+#include <cstdlib> // std::abs
+
+namespace
+{
+const QSize imageSize{100, 60};
+const uint dxt1Format = 0x83F0; // GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+const int maxGradientError = 10;
+
+QImage _createGradient(const QSize& size)
+{
+    QImage image{size, QImage::Format_RGB32};
+    for (int y = 0; y < size.height(); ++y)
+    {
+        for (int x = 0; x < size.width(); ++x)
+        {
+            image.setPixel(x, y, qRgb(255 * x / size.width(),
+                                      255 * y / size.height(), 128));
+        }
+    }
+    return image;
+}
+
+int _maxError(const QImage& a, const QImage& b)
+{
+    int error = 0;
+    for (int y = 0; y < a.height(); ++y)
+    {
+        for (int x = 0; x < a.width(); ++x)
+        {
+            const auto pa = a.pixel(x, y);
+            const auto pb = b.pixel(x, y);
+            error = std::max({error, std::abs(qRed(pa) - qRed(pb)),
+                              std::abs(qGreen(pa) - qGreen(pb)),
+                              std::abs(qBlue(pa) - qBlue(pb))});
+        }
+    }
+    return error;
+}
+}
+
+BOOST_AUTO_TEST_CASE(compressed_image_has_all_mipmap_levels)
+{
+    const CompressedImage image{_createGradient(imageSize)};
+
+    BOOST_CHECK_EQUAL(image.getWidth(), imageSize.width());
+    BOOST_CHECK_EQUAL(image.getHeight(), imageSize.height());
+    BOOST_CHECK(image.getFormat() == TextureFormat::rgba);
+    BOOST_CHECK_EQUAL(image.getGLCompressedFormat(), dxt1Format);
+
+    // 100x60, 50x30, 25x15, 12x7, 6x3, 3x1, 1x1
+    BOOST_REQUIRE_EQUAL(image.getMipmapLevels(), 7);
+    BOOST_CHECK_EQUAL(image.getTextureSize(0), imageSize);
+    BOOST_CHECK_EQUAL(image.getTextureSize(1), QSize(50, 30));
+    BOOST_CHECK_EQUAL(image.getTextureSize(5), QSize(3, 1));
+    BOOST_CHECK_EQUAL(image.getTextureSize(6), QSize(1, 1));
+    BOOST_CHECK(!image.getTextureSize(7).isValid());
+
+    // 8 bytes per block of 4x4 pixels, partial blocks included
+    BOOST_CHECK_EQUAL(image.getDataSize(0), 25 * 15 * 8);
+    BOOST_CHECK_EQUAL(image.getDataSize(3), 3 * 2 * 8);
+    BOOST_CHECK_EQUAL(image.getDataSize(6), 8);
+    BOOST_CHECK(image.getData(6) != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(uniform_image_is_preserved)
+{
+    QImage source{imageSize, QImage::Format_RGB32};
+    source.fill(qRgb(200, 100, 50));
+
+    const auto decompressed = CompressedImage{source}.decompress();
+    BOOST_CHECK_EQUAL(decompressed.size(), imageSize);
+    // RGB565 endpoints
+    BOOST_CHECK_LE(_maxError(source, decompressed), 4);
+}
+
+BOOST_AUTO_TEST_CASE(gradient_image_is_close_to_original)
+{
+    const auto source = _createGradient(imageSize);
+
+    const auto decompressed = CompressedImage{source}.decompress();
+    BOOST_CHECK_LE(_maxError(source, decompressed), maxGradientError);
+}
+
+BOOST_AUTO_TEST_CASE(only_opaque_images_can_be_compressed)
+{
+    BOOST_CHECK(!CompressedImage::canCompress(QImage()));
+    BOOST_CHECK_THROW(CompressedImage{QImage()}, std::invalid_argument);
+
+    QImage image{imageSize, QImage::Format_ARGB32};
+    image.fill(qRgba(10, 20, 30, 255));
+    BOOST_CHECK(CompressedImage::canCompress(image));
+    BOOST_CHECK(CompressedImage::canCompress(_createGradient(imageSize)));
+
+    image.setPixel(5, 5, qRgba(10, 20, 30, 128));
+    BOOST_CHECK(!CompressedImage::canCompress(image));
+}
@@ -156,11 +156,16 @@ BOOST_AUTO_TEST_CASE(test_minimal_configuration_default_values)
     BOOST_CHECK_EQUAL(config.settings.touchpointsToWakeup, 1);
     BOOST_CHECK_EQUAL(config.settings.contentMaxScale, 0.0);
     BOOST_CHECK_EQUAL(config.settings.contentMaxScaleVectorial, 0.0);
+    BOOST_CHECK_EQUAL(config.settings.imageTilingThreshold, 4096);
+    BOOST_CHECK_EQUAL(config.settings.pixelStreamPipelineDepth, 2);
+    BOOST_CHECK_EQUAL(config.settings.textureUploadBudget, 24);
+    BOOST_CHECK_EQUAL(config.settings.tileCacheMaxSize, 4096);
 
     BOOST_CHECK_EQUAL(config.folders.contents, QDir::homePath());
     BOOST_CHECK_EQUAL(config.folders.sessions, QDir::homePath());
     BOOST_CHECK_EQUAL(config.folders.upload, QDir::tempPath());
     BOOST_CHECK_EQUAL(config.folders.tmp, QDir::tempPath());
+    BOOST_CHECK_EQUAL(config.folders.tileCache, QString());
 
     BOOST_CHECK_EQUAL(config.webbrowser.defaultUrl, "http://www.google.com");
 
@@ -325,6 +330,10 @@ void testReferenceConfig(const Configuration& config)
     BOOST_CHECK_EQUAL(config.settings.touchpointsToWakeup, 10);
     BOOST_CHECK_EQUAL(config.settings.contentMaxScale, 4.4);
     BOOST_CHECK_EQUAL(config.settings.contentMaxScaleVectorial, 8.8);
+    BOOST_CHECK_EQUAL(config.settings.imageTilingThreshold, 8192);
+    BOOST_CHECK_EQUAL(config.settings.pixelStreamPipelineDepth, 3);
+    BOOST_CHECK_EQUAL(config.settings.textureUploadBudget, 32);
+    BOOST_CHECK_EQUAL(config.settings.tileCacheMaxSize, 512);
 
     BOOST_CHECK_EQUAL(config.folders.contents,
                       "/nfs4/bbp.epfl.ch/visualization/DisplayWall/media");
@@ -334,6 +343,7 @@ void testReferenceConfig(const Configuration& config)
                       "/nfs4/bbp.epfl.ch/media/DisplayWall/upload");
     BOOST_CHECK_EQUAL(config.folders.tmp,
                       "/nfs4/bbp.epfl.ch/media/DisplayWall/tmp");
+    BOOST_CHECK_EQUAL(config.folders.tileCache, "/var/cache/tide");
 
     BOOST_CHECK_EQUAL(config.launcher.display, ":0");
     BOOST_CHECK_EQUAL(config.launcher.demoServiceUrl,
@@ -0,0 +1,159 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE DamageTrackerTests
+#include <boost/test/unit_test.hpp>
+
+#include "scene/DisplayGroup.h"
+#include "scene/Markers.h"
+#include "scene/Window.h"
+#include "serialization/utils.h"
+#include "tools/DamageTracker.h"
+
+#include "DummyContent.h"
+
+namespace
+{
+const QSize groupSize(4000, 1000);
+const QSize windowSize(300, 300);
+const QRect leftScreen(0, 0, 2000, 1000);
+const QRect rightScreen(2000, 0, 2000, 1000);
+
+WindowPtr makeWindow(const QPointF& position)
+{
+    auto window = std::make_shared<Window>(
+        std::make_unique<DummyContent>(windowSize));
+    window->setCoordinates(QRectF(position, windowSize));
+    return window;
+}
+}
+
+struct Fixture
+{
+    Fixture() { group->add(window); }
+    DisplayGroupPtr group{DisplayGroup::create(groupSize)};
+    WindowPtr window{makeWindow(QPointF(100, 100))};
+    DamageTracker left{leftScreen};
+    DamageTracker right{rightScreen};
+
+    void addChanges(const DisplayGroup& previous, const DisplayGroup& next)
+    {
+        left.addChanges(previous, next);
+        right.addChanges(previous, next);
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE(unchanged_group_has_no_damage, Fixture)
+{
+    const auto copy = serialization::binaryCopy(group);
+    addChanges(*group, *copy);
+
+    BOOST_CHECK(!left.isDamaged());
+    BOOST_CHECK(!right.isDamaged());
+}
+
+BOOST_FIXTURE_TEST_CASE(moved_window_only_damages_its_screen, Fixture)
+{
+    const auto previous = serialization::binaryCopy(group);
+    window->setCoordinates(QRectF(QPointF(500, 200), windowSize));
+    addChanges(*previous, *group);
+
+    BOOST_CHECK(left.isDamaged());
+    BOOST_CHECK(left.hasTransitions());
+    BOOST_CHECK(!right.isDamaged());
+}
+
+BOOST_FIXTURE_TEST_CASE(added_and_removed_windows_damage_their_area, Fixture)
+{
+    const auto previous = serialization::binaryCopy(group);
+    auto other = makeWindow(QPointF(3000, 500));
+    group->add(other);
+    addChanges(*previous, *group);
+
+    BOOST_CHECK(!left.isDamaged());
+    BOOST_CHECK(right.isDamaged());
+
+    DamageTracker tracker{leftScreen};
+    const auto next = serialization::binaryCopy(group);
+    next->remove(next->getWindow(window->getID()));
+    tracker.addChanges(*group, *next);
+    BOOST_CHECK(tracker.isDamaged());
+}
+
+BOOST_FIXTURE_TEST_CASE(focus_mode_damages_all_screens, Fixture)
+{
+    const auto previous = serialization::binaryCopy(group);
+    group->addFocusedWindow(window);
+    addChanges(*previous, *group);
+
+    BOOST_CHECK(left.isDamaged());
+    BOOST_CHECK(right.isDamaged());
+}
+
+BOOST_FIXTURE_TEST_CASE(frame_damage_is_cleared_after_rendering, Fixture)
+{
+    left.add(QRectF(10, 10, 50, 50));
+    BOOST_CHECK(left.isDamaged());
+    BOOST_CHECK(!left.hasTransitions());
+    left.clear();
+    BOOST_CHECK(!left.isDamaged());
+
+    right.add(QRectF(10, 10, 50, 50));
+    BOOST_CHECK(!right.isDamaged());
+
+    left.addScreenTransition();
+    left.clear();
+    BOOST_CHECK(left.isDamaged());
+    BOOST_CHECK(left.hasTransitions());
+}
+
+BOOST_AUTO_TEST_CASE(markers_damage_their_positions)
+{
+    auto previous = Markers::create(0);
+    auto next = Markers::create(0);
+    next->addMarker(0, QPointF(2500, 500));
+
+    DamageTracker left{leftScreen};
+    DamageTracker right{rightScreen};
+    left.addChanges(*previous, *next);
+    right.addChanges(*previous, *next);
+
+    BOOST_CHECK(!left.isDamaged());
+    BOOST_CHECK(right.isDamaged());
+}
@@ -45,9 +45,12 @@
 
 #include "datasources/DataSource.h"
 #include "datasources/DataSourceFactory.h"
+#include "datasources/ImageTiler.h"
 
 #include "DummyContent.h"
 
+#include <QTemporaryDir>
+
 namespace
 {
 const QSize contentSize(800, 600);
@@ -113,3 +116,42 @@ BOOST_AUTO_TEST_CASE(datasource_factory_throws_for_unsupported_contents)
                           std::logic_error);
     }
 }
+
+BOOST_AUTO_TEST_CASE(large_images_are_tiled)
+{
+    QTemporaryDir dir;
+    const auto uri = dir.path() + "/large.png";
+    QImage image{1500, 1000, QImage::Format_RGB32};
+    image.fill(Qt::red);
+    BOOST_REQUIRE(image.save(uri));
+
+    ImageTiler::setSizeThreshold(1024);
+
+    auto content = std::make_unique<DummyContent>(image.size(), uri);
+    content->type = ContentType::image;
+    const auto source = DataSourceFactory::create(*content);
+    BOOST_REQUIRE(dynamic_cast<ImageTiler*>(source.get()));
+
+    BOOST_CHECK_EQUAL(source->getMaxLod(), 1u);
+    BOOST_CHECK_EQUAL(source->getTilesArea(0, 0), image.size());
+    BOOST_CHECK_EQUAL(source->getTilesArea(1, 0), QSize(750, 500));
+
+    const auto visibleSet = source->computeVisibleSet(
+        QRectF(QPointF(), source->getTilesArea(0, 0)), 0, 0);
+    BOOST_CHECK_EQUAL(visibleSet.size(), 2u);
+
+    for (const auto tileId : visibleSet)
+    {
+        const auto tile = source->getTileImage(tileId, deflect::View::mono);
+        BOOST_CHECK_EQUAL(QSize(tile->getWidth(), tile->getHeight()),
+                          source->getTileRect(tileId).size());
+    }
+
+    const auto top = source->getTileImage(0, deflect::View::mono);
+    BOOST_CHECK_EQUAL(QSize(top->getWidth(), top->getHeight()),
+                      QSize(750, 500));
+
+    ImageTiler::setSizeThreshold(4096);
+    BOOST_CHECK(!dynamic_cast<ImageTiler*>(
+        DataSourceFactory::create(*content).get()));
+}
@@ -43,9 +43,12 @@
 
 #include "scene/DisplayGroup.h"
 #include "scene/Window.h"
+#include "serialization/utils.h"
 
 #include "DummyContent.h"
 
+#include <random>
+
 namespace
 {
 const QSize wallSize(1000, 1000);
@@ -56,6 +59,34 @@ ContentPtr makeDummyContent(const QString& uri = QString())
 {
     return std::make_unique<DummyContent>(QSize{WIDTH, HEIGHT}, uri);
 }
+
+WindowPtr findWindowAtBruteForce(const DisplayGroup& group, const QPointF& pos)
+{
+    const auto& windows = group.getWindows();
+    for (auto it = windows.rbegin(); it != windows.rend(); ++it)
+    {
+        const auto& window = *it;
+        const auto& coords = window->getDisplayCoordinates();
+        if (!window->isHidden() && coords.contains(pos))
+            return window;
+    }
+    return WindowPtr();
+}
+
+void checkWindowsAtAllPositions(const DisplayGroup& group)
+{
+    // Also sample positions around the group, where windows can overflow
+    const auto area = group.getCoordinates().adjusted(-500, -500, 500, 500);
+    for (auto y = area.top(); y <= area.bottom(); y += 37.5)
+    {
+        for (auto x = area.left(); x <= area.right(); x += 37.5)
+        {
+            const auto pos = QPointF{x, y};
+            BOOST_CHECK_EQUAL(group.getWindowAt(pos),
+                              findWindowAtBruteForce(group, pos));
+        }
+    }
+}
 }
 
 BOOST_AUTO_TEST_CASE(focus_window)
@@ -153,3 +184,75 @@ BOOST_AUTO_TEST_CASE(find_window_by_filename)
     BOOST_CHECK(group->findWindow("ccc"));
     BOOST_CHECK(!group->findWindow("ddd"));
 }
+
+BOOST_AUTO_TEST_CASE(get_window_by_id)
+{
+    auto window0 = std::make_shared<Window>(makeDummyContent());
+    auto window1 = std::make_shared<Window>(makeDummyContent());
+
+    auto group = DisplayGroup::create(wallSize);
+    BOOST_CHECK(!group->getWindow(window0->getID()));
+
+    group->add(window0);
+    group->add(window1);
+    BOOST_CHECK_EQUAL(group->getWindow(window0->getID()), window0);
+    BOOST_CHECK_EQUAL(group->getWindow(window1->getID()), window1);
+
+    group->remove(window0);
+    BOOST_CHECK(!group->getWindow(window0->getID()));
+    BOOST_CHECK_EQUAL(group->getWindow(window1->getID()), window1);
+
+    group->replaceWindows(WindowPtrs{window0});
+    BOOST_CHECK_EQUAL(group->getWindow(window0->getID()), window0);
+    BOOST_CHECK(!group->getWindow(window1->getID()));
+
+    group->clear();
+    BOOST_CHECK(!group->getWindow(window0->getID()));
+}
+
+BOOST_AUTO_TEST_CASE(get_window_at_position_matches_brute_force_search)
+{
+    auto group = DisplayGroup::create(QSize{3840, 2160});
+
+    std::mt19937 engine;
+    std::uniform_real_distribution<qreal> pos{-300.0, 3800.0};
+    std::uniform_real_distribution<qreal> size{10.0, 1500.0};
+    const auto randomRect = [&] {
+        return QRectF{pos(engine), pos(engine), size(engine), size(engine)};
+    };
+
+    WindowPtrs windows;
+    for (int i = 0; i < 50; ++i)
+    {
+        windows.push_back(std::make_shared<Window>(makeDummyContent()));
+        windows.back()->setCoordinates(randomRect());
+        group->add(windows.back());
+    }
+    checkWindowsAtAllPositions(*group);
+
+    for (size_t i = 0; i < windows.size(); i += 3)
+        windows[i]->setCoordinates(randomRect());
+    checkWindowsAtAllPositions(*group);
+
+    for (size_t i = 1; i < windows.size(); i += 4)
+        group->moveToFront(windows[i]);
+    checkWindowsAtAllPositions(*group);
+
+    windows[2]->setFocusedCoordinates(randomRect());
+    group->addFocusedWindow(windows[2]);
+    windows[5]->setFullscreenCoordinates(group->getCoordinates());
+    windows[5]->setMode(Window::WindowMode::FULLSCREEN);
+    windows[8]->setState(Window::HIDDEN);
+    windows[11]->setWidth(windows[11]->width() * 2.0);
+    checkWindowsAtAllPositions(*group);
+
+    for (size_t i = 0; i < windows.size(); i += 5)
+        group->remove(windows[i]);
+    checkWindowsAtAllPositions(*group);
+
+    group->setWidth(1920);
+    checkWindowsAtAllPositions(*group);
+
+    const auto copy = serialization::binaryCopy(group);
+    checkWindowsAtAllPositions(*copy);
+}
@@ -0,0 +1,96 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE FFMPEGKeyframeIndexTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "data/FFMPEGKeyframeIndex.h"
+
+namespace
+{
+const FFMPEGKeyframeIndex gopIndex{{250, 0, 500, 250, 750}};
+}
+
+BOOST_AUTO_TEST_CASE(keyframes_are_sorted_and_unique)
+{
+    BOOST_CHECK_EQUAL(gopIndex.size(), 4u);
+    BOOST_CHECK_EQUAL(gopIndex.findPrevious(0), 0);
+    BOOST_CHECK_EQUAL(gopIndex.findPrevious(800), 750);
+}
+
+BOOST_AUTO_TEST_CASE(find_previous_keyframe)
+{
+    BOOST_CHECK_EQUAL(gopIndex.findPrevious(249), 0);
+    BOOST_CHECK_EQUAL(gopIndex.findPrevious(250), 250);
+    BOOST_CHECK_EQUAL(gopIndex.findPrevious(499), 250);
+
+    const FFMPEGKeyframeIndex index{{10, 20}};
+    BOOST_CHECK_EQUAL(index.findPrevious(5), -1);
+}
+
+BOOST_AUTO_TEST_CASE(empty_index_covers_nothing)
+{
+    const FFMPEGKeyframeIndex index;
+    BOOST_CHECK_EQUAL(index.size(), 0u);
+    BOOST_CHECK(!index.covers(0));
+    BOOST_CHECK_EQUAL(index.findPrevious(100), -1);
+}
+
+BOOST_AUTO_TEST_CASE(partial_index_covers_up_to_last_keyframe)
+{
+    BOOST_CHECK(gopIndex.covers(0));
+    BOOST_CHECK(gopIndex.covers(750));
+    BOOST_CHECK(!gopIndex.covers(751));
+    BOOST_CHECK(!gopIndex.covers(-1));
+}
+
+BOOST_AUTO_TEST_CASE(decode_forward_within_group_of_pictures)
+{
+    BOOST_CHECK(!gopIndex.isSeekFaster(260, 499));
+    BOOST_CHECK(!gopIndex.isSeekFaster(250, 251));
+    BOOST_CHECK(!gopIndex.isSeekFaster(100, 100));
+}
+
+BOOST_AUTO_TEST_CASE(seek_backwards_or_across_keyframes)
+{
+    BOOST_CHECK(gopIndex.isSeekFaster(300, 299));
+    BOOST_CHECK(gopIndex.isSeekFaster(249, 250));
+    BOOST_CHECK(gopIndex.isSeekFaster(10, 700));
+}
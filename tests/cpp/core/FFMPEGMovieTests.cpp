@@ -0,0 +1,267 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE FFMPEGMovieTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "data/FFMPEGMovie.h"
+#include "data/FFMPEGPicture.h"
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+const int frameCount = 10;
+const int width = 64;
+const int height = 48;
+
+int _luma(const int frameIndex)
+{
+    return 16 + 20 * frameIndex;
+}
+
+/** Encode a short movie with B-frames, which the decoder outputs late. */
+class TestMovieWriter
+{
+public:
+    TestMovieWriter(const QString& filename)
+    {
+        const auto name = filename.toStdString();
+        avformat_alloc_output_context2(&_output, nullptr, nullptr,
+                                       name.c_str());
+        BOOST_REQUIRE(_output);
+
+        const auto codec = avcodec_find_encoder(AV_CODEC_ID_MPEG4);
+        BOOST_REQUIRE(codec);
+        _stream = avformat_new_stream(_output, nullptr);
+        _encoder = avcodec_alloc_context3(codec);
+        BOOST_REQUIRE(_stream && _encoder);
+
+        _encoder->width = width;
+        _encoder->height = height;
+        _encoder->pix_fmt = AV_PIX_FMT_YUV420P;
+        _encoder->time_base = AVRational{1, 25};
+        _encoder->framerate = AVRational{25, 1};
+        _encoder->gop_size = 5;
+        _encoder->max_b_frames = 2;
+        if (_output->oformat->flags & AVFMT_GLOBALHEADER)
+            _encoder->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+
+        BOOST_REQUIRE_EQUAL(avcodec_open2(_encoder, codec, nullptr), 0);
+        BOOST_REQUIRE_GE(
+            avcodec_parameters_from_context(_stream->codecpar, _encoder), 0);
+        _stream->time_base = _encoder->time_base;
+
+        BOOST_REQUIRE_GE(avio_open(&_output->pb, name.c_str(), AVIO_FLAG_WRITE),
+                         0);
+        BOOST_REQUIRE_GE(avformat_write_header(_output, nullptr), 0);
+    }
+
+    ~TestMovieWriter()
+    {
+        av_frame_free(&_frame);
+        avcodec_free_context(&_encoder);
+        if (_output)
+            avio_closep(&_output->pb);
+        avformat_free_context(_output);
+    }
+
+    void write(const int count)
+    {
+        _frame = av_frame_alloc();
+        _frame->format = _encoder->pix_fmt;
+        _frame->width = width;
+        _frame->height = height;
+        BOOST_REQUIRE_GE(av_frame_get_buffer(_frame, 32), 0);
+
+        for (int i = 0; i < count; ++i)
+        {
+            BOOST_REQUIRE_GE(av_frame_make_writable(_frame), 0);
+            for (int y = 0; y < height; ++y)
+                std::fill_n(_frame->data[0] + y * _frame->linesize[0], width,
+                            _luma(i));
+            for (int y = 0; y < height / 2; ++y)
+            {
+                std::fill_n(_frame->data[1] + y * _frame->linesize[1],
+                            width / 2, 128);
+                std::fill_n(_frame->data[2] + y * _frame->linesize[2],
+                            width / 2, 128);
+            }
+            _frame->pts = i;
+            _encode(_frame);
+        }
+        _encode(nullptr); // flush the delayed frames
+        BOOST_REQUIRE_EQUAL(av_write_trailer(_output), 0);
+    }
+
+private:
+    AVFormatContext* _output = nullptr;
+    AVStream* _stream = nullptr;
+    AVCodecContext* _encoder = nullptr;
+    AVFrame* _frame = nullptr;
+
+    void _encode(const AVFrame* frame)
+    {
+        BOOST_REQUIRE_EQUAL(avcodec_send_frame(_encoder, frame), 0);
+
+        AVPacket packet;
+        av_init_packet(&packet);
+        packet.data = nullptr;
+        packet.size = 0;
+        while (avcodec_receive_packet(_encoder, &packet) == 0)
+        {
+            av_packet_rescale_ts(&packet, _encoder->time_base,
+                                 _stream->time_base);
+            packet.stream_index = _stream->index;
+            BOOST_REQUIRE_EQUAL(av_interleaved_write_frame(_output, &packet),
+                                0);
+        }
+    }
+};
+
+struct TestMovie
+{
+    QTemporaryDir dir;
+    QString filename = dir.path() + "/movie.mp4";
+
+    TestMovie() { TestMovieWriter{filename}.write(frameCount); }
+};
+
+/** Times of the keyframes of a movie in seconds, relative to its start. */
+struct KeyframeTimes
+{
+    std::vector<double> decoding;
+    std::vector<double> presentation;
+};
+
+KeyframeTimes _readKeyframeTimes(const QString& filename)
+{
+    const auto name = filename.toStdString();
+    AVFormatContext* input = nullptr;
+    BOOST_REQUIRE_EQUAL(
+        avformat_open_input(&input, name.c_str(), nullptr, nullptr), 0);
+    BOOST_REQUIRE_GE(avformat_find_stream_info(input, nullptr), 0);
+
+    const auto& stream = *input->streams[0];
+    const auto timeBase = av_q2d(stream.time_base);
+    const auto start =
+        stream.start_time != int64_t(AV_NOPTS_VALUE) ? stream.start_time : 0;
+
+    KeyframeTimes times;
+    AVPacket packet;
+    av_init_packet(&packet);
+    while (av_read_frame(input, &packet) >= 0)
+    {
+        if (packet.flags & AV_PKT_FLAG_KEY)
+        {
+            times.decoding.push_back((packet.dts - start) * timeBase);
+            times.presentation.push_back((packet.pts - start) * timeBase);
+        }
+        av_packet_unref(&packet);
+    }
+    avformat_close_input(&input);
+    return times;
+}
+
+int _averageLuma(const FFMPEGPicture& picture)
+{
+    const auto data = picture.getData(0);
+    const auto size = picture.getWidth() * picture.getHeight();
+    return std::accumulate(data, data + size, 0) / size;
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(all_frames_decode_in_sequence, TestMovie)
+{
+    FFMPEGMovie movie{filename};
+    BOOST_REQUIRE_EQUAL(movie.getWidth(), uint(width));
+    BOOST_REQUIRE_EQUAL(movie.getHeight(), uint(height));
+
+    for (int i = 0; i < frameCount; ++i)
+    {
+        const auto position = i * movie.getFrameDuration();
+        BOOST_CHECK_MESSAGE(movie.getFrame(position), "frame " << i);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(final_frame_is_drained_from_decoder, TestMovie)
+{
+    FFMPEGMovie movie{filename};
+
+    const auto picture = movie.getFrame(movie.getDuration());
+    BOOST_REQUIRE(picture);
+    BOOST_CHECK_EQUAL(picture->getWidth(), width);
+    BOOST_CHECK_EQUAL(picture->getHeight(), height);
+
+    // The picture is one of the last frames, which the decoder delays
+    BOOST_CHECK_GT(_averageLuma(*picture), _luma(frameCount - 3));
+}
+
+BOOST_FIXTURE_TEST_CASE(keyframes_are_indexed_at_their_decoding_time, TestMovie)
+{
+    // With B-frames, keyframes are presented after the time they are decoded
+    const auto keyframes = _readKeyframeTimes(filename);
+    BOOST_REQUIRE_GE(keyframes.decoding.size(), 2u);
+
+    FFMPEGMovie movie{filename};
+    BOOST_REQUIRE(movie.getFrame(0.0)); // index snapshot for findKeyframe()
+
+    // Same conversion as FFMPEGVideoStream::getFrameIndex(timestamp)
+    const auto frameDuration = movie.getFrameDuration();
+    const auto decodingIndex = int64_t(keyframes.decoding[1] / frameDuration);
+    const auto presentationIndex =
+        int64_t(keyframes.presentation[1] / frameDuration);
+    BOOST_REQUIRE_LT(decodingIndex, presentationIndex);
+
+    // Known limitation: a frame presented before the keyframe, at the time it
+    // is decoded, already previews it
+    const auto position = (decodingIndex + 1.5) * frameDuration;
+    BOOST_CHECK_CLOSE(movie.findKeyframe(position), position, 1e-6);
+}
@@ -0,0 +1,177 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE FFMPEGThreadBudgetTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "data/FFMPEGThreadBudget.h"
+
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(host_cores_are_divided_between_processes)
+{
+    FFMPEGThreadBudget budget{32};
+    BOOST_CHECK_EQUAL(budget.getCoreCount(), 32u);
+
+    budget.setProcessCount(4);
+    BOOST_CHECK_EQUAL(budget.getCoreCount(), 8u);
+
+    budget.setProcessCount(64);
+    BOOST_CHECK_EQUAL(budget.getCoreCount(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(single_movie_leaves_cores_for_loading_content)
+{
+    FFMPEGThreadBudget budget{32};
+    budget.setProcessCount(4);
+
+    const auto movie = budget.add(3840, 2160);
+    BOOST_CHECK_EQUAL(budget.getThreadCount(movie),
+                      8u - FFMPEGThreadBudget::minLoadingThreads);
+}
+
+BOOST_AUTO_TEST_CASE(threads_per_movie_are_capped)
+{
+    FFMPEGThreadBudget budget{64};
+
+    const auto movie = budget.add(3840, 2160);
+    BOOST_CHECK_EQUAL(budget.getThreadCount(movie),
+                      FFMPEGThreadBudget::maxThreadsPerMovie);
+}
+
+BOOST_AUTO_TEST_CASE(cores_are_shared_in_proportion_to_resolution)
+{
+    FFMPEGThreadBudget budget{12};
+
+    const auto uhd = budget.add(3840, 2160);
+    const auto hd = budget.add(1920, 1080);
+    BOOST_CHECK_EQUAL(budget.getThreadCount(uhd), 8u);
+    BOOST_CHECK_EQUAL(budget.getThreadCount(hd), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(each_movie_gets_at_least_one_thread)
+{
+    FFMPEGThreadBudget budget{6};
+
+    const auto uhd = budget.add(3840, 2160);
+    const auto small = budget.add(320, 240);
+    BOOST_CHECK_EQUAL(budget.getThreadCount(uhd), 3u);
+    BOOST_CHECK_EQUAL(budget.getThreadCount(small), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(removing_a_movie_rebalances_the_others)
+{
+    FFMPEGThreadBudget budget{14};
+
+    const auto first = budget.add(1920, 1080);
+    const auto second = budget.add(1920, 1080);
+    const auto third = budget.add(1920, 1080);
+    BOOST_CHECK_EQUAL(budget.getThreadCount(first), 4u);
+
+    budget.remove(second);
+    BOOST_CHECK_EQUAL(budget.getThreadCount(first), 6u);
+    BOOST_CHECK_EQUAL(budget.getThreadCount(third), 6u);
+
+    budget.remove(third);
+    BOOST_CHECK_EQUAL(budget.getThreadCount(first), 12u);
+}
+
+BOOST_AUTO_TEST_CASE(inactive_movies_do_not_share_the_cores)
+{
+    FFMPEGThreadBudget budget{14};
+
+    const auto first = budget.add(1920, 1080);
+    const auto second = budget.add(1920, 1080);
+    BOOST_CHECK_EQUAL(budget.getThreadCount(first), 6u);
+
+    budget.setActive(second, false);
+    BOOST_CHECK_EQUAL(budget.getThreadCount(first), 12u);
+    BOOST_CHECK_EQUAL(budget.getThreadCount(second), 1u);
+
+    budget.setActive(second, true);
+    BOOST_CHECK_EQUAL(budget.getThreadCount(first), 6u);
+    BOOST_CHECK_EQUAL(budget.getThreadCount(second), 6u);
+}
+
+BOOST_AUTO_TEST_CASE(loading_threads_use_the_cores_left_by_decoders)
+{
+    FFMPEGThreadBudget budget{14};
+    BOOST_CHECK_EQUAL(budget.getLoadingThreadCount(), 14u);
+
+    // The thread that waits for the decoder is counted as a decoding thread
+    const auto movie = budget.add(1920, 1080);
+    BOOST_CHECK_EQUAL(budget.getLoadingThreadCount(), 3u);
+
+    budget.setActive(movie, false);
+    BOOST_CHECK_EQUAL(budget.getLoadingThreadCount(), 14u);
+
+    budget.setProcessCount(14);
+    BOOST_CHECK_EQUAL(budget.getLoadingThreadCount(),
+                      FFMPEGThreadBudget::minLoadingThreads);
+}
+
+BOOST_AUTO_TEST_CASE(loading_thread_count_changes_are_notified)
+{
+    FFMPEGThreadBudget budget{14};
+
+    std::vector<uint> counts;
+    budget.setLoadingThreadsCallback(
+        [&counts](const uint count) { counts.push_back(count); });
+    BOOST_REQUIRE_EQUAL(counts.size(), 1u);
+    BOOST_CHECK_EQUAL(counts.back(), 14u);
+
+    const auto movie = budget.add(1920, 1080);
+    BOOST_REQUIRE_EQUAL(counts.size(), 2u);
+    BOOST_CHECK_EQUAL(counts.back(), 3u);
+
+    budget.setActive(movie, true);
+    BOOST_CHECK_EQUAL(counts.size(), 2u);
+
+    budget.remove(movie);
+    BOOST_REQUIRE_EQUAL(counts.size(), 3u);
+    BOOST_CHECK_EQUAL(counts.back(), 14u);
+}
+
+BOOST_AUTO_TEST_CASE(unknown_movie_gets_one_thread)
+{
+    FFMPEGThreadBudget budget{12};
+    BOOST_CHECK_EQUAL(budget.getThreadCount(42), 1u);
+    budget.remove(42);
+}
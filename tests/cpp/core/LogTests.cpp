@@ -0,0 +1,139 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE LogTests
+#include <boost/test/unit_test.hpp>
+
+#include "utils/log.h"
+
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+/** Capture the output of the logger while in scope. */
+struct CaptureOutput
+{
+    // The logger is idle after a flush, until the next message is logged
+    CaptureOutput()
+    {
+        flush_log();
+        previous = std::cout.rdbuf(stream.rdbuf());
+    }
+    ~CaptureOutput()
+    {
+        flush_log();
+        std::cout.rdbuf(previous);
+    }
+
+    std::string get()
+    {
+        flush_log();
+        return stream.str();
+    }
+
+    size_t count(const std::string& text)
+    {
+        const auto output = get();
+        size_t n = 0;
+        for (auto pos = output.find(text); pos != std::string::npos;
+             pos = output.find(text, pos + 1))
+        {
+            ++n;
+        }
+        return n;
+    }
+
+    size_t sumSuppressed()
+    {
+        const std::string prefix = "suppressed ";
+        const auto output = get();
+        size_t sum = 0;
+        for (auto pos = output.find(prefix); pos != std::string::npos;
+             pos = output.find(prefix, pos + 1))
+        {
+            sum += std::stoul(output.substr(pos + prefix.size()));
+        }
+        return sum;
+    }
+
+    std::stringstream stream;
+    std::streambuf* previous = nullptr;
+};
+}
+
+BOOST_AUTO_TEST_CASE(testMessagesAreWritten)
+{
+    CaptureOutput output;
+    put_log(LOG_WARN, LOG_GENERAL, "message %d", 42);
+    BOOST_CHECK_EQUAL(output.count("{GENERAL} message 42"), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(testPerFacilityLevel)
+{
+    CaptureOutput output;
+    BOOST_CHECK(!set_log_level("UNKNOWN", LOG_DEBUG));
+
+    BOOST_REQUIRE(set_log_level(LOG_REST, LOG_ERROR));
+    put_log(LOG_WARN, LOG_REST, "filtered rest warning");
+    put_log(LOG_WARN, LOG_MPI, "mpi warning");
+    BOOST_CHECK_EQUAL(output.count("filtered rest warning"), 0u);
+    BOOST_CHECK_EQUAL(output.count("mpi warning"), 1u);
+
+    BOOST_REQUIRE(set_log_level(LOG_REST, LOG_VERBOSE));
+    put_log(LOG_VERBOSE, LOG_REST, "verbose rest message");
+    put_log(LOG_VERBOSE, LOG_MPI, "filtered mpi message");
+    BOOST_CHECK_EQUAL(output.count("verbose rest message"), 1u);
+    BOOST_CHECK_EQUAL(output.count("filtered mpi message"), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(testRepetitiveMessagesAreSuppressed)
+{
+    CaptureOutput output;
+    for (int i = 0; i < 100; ++i)
+        put_log(LOG_INFO, LOG_CONTENT, "repeated message %d", i);
+
+    // The number of rate limiting periods depends on timing, but each message
+    // is either written or counted in exactly one summary.
+    const auto written = output.count("{CONTENT} repeated message");
+    const auto suppressed = output.sumSuppressed();
+    BOOST_CHECK_GE(written, 10u);
+    BOOST_CHECK_GT(suppressed, 0u);
+    BOOST_CHECK_EQUAL(written + suppressed, 100u);
+}
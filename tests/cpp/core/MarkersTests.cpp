@@ -0,0 +1,111 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE MarkersTests
+#include <boost/test/unit_test.hpp>
+
+#include "scene/Markers.h"
+
+namespace
+{
+const QPointF pos0{10.0, 20.0};
+const QPointF pos1{1000.5, 2000.25};
+const QPointF pos2{30.0, 40.0};
+
+QPointF getPosition(const Markers& markers, const int row)
+{
+    const auto index = markers.index(row);
+    return {markers.data(index, Markers::XPOSITION_ROLE).toDouble(),
+            markers.data(index, Markers::YPOSITION_ROLE).toDouble()};
+}
+}
+
+BOOST_AUTO_TEST_CASE(testNoChanges)
+{
+    auto markers = Markers::create(0);
+    BOOST_CHECK(markers->takeChanges().empty());
+}
+
+BOOST_AUTO_TEST_CASE(testChangesAreAppliedToCopy)
+{
+    auto markers = Markers::create(3);
+    markers->addMarker(0, pos0);
+    markers->addMarker(1, pos0);
+    markers->updateMarker(1, pos1);
+
+    const auto changes = markers->takeChanges();
+    BOOST_CHECK_EQUAL(Markers::decodeSurfaceIndex(changes), 3u);
+    BOOST_CHECK(markers->takeChanges().empty());
+
+    auto wallMarkers = Markers::create(3);
+    const auto copy = wallMarkers->copyWithChanges(changes);
+    BOOST_CHECK_EQUAL(wallMarkers->rowCount(), 0);
+    BOOST_REQUIRE_EQUAL(copy->rowCount(), 2);
+    BOOST_CHECK_EQUAL(copy->getSurfaceIndex(), 3u);
+    BOOST_CHECK_EQUAL(getPosition(*copy, 0), pos0);
+    BOOST_CHECK_EQUAL(getPosition(*copy, 1), pos1);
+}
+
+BOOST_AUTO_TEST_CASE(testOnlyChangedMarkersAreEncoded)
+{
+    auto markers = Markers::create(0);
+    markers->addMarker(0, pos0);
+    markers->addMarker(1, pos0);
+    auto wallMarkers = Markers::create(0)->copyWithChanges(
+        markers->takeChanges());
+
+    markers->updateMarker(1, pos1);
+    markers->updateMarker(1, pos2);
+    const auto changes = markers->takeChanges();
+    const auto recordSize = changes.size() - sizeof(uint32_t);
+
+    markers->addMarker(2, pos0);
+    markers->removeMarker(2);
+    markers->removeMarker(0);
+    const auto removals = markers->takeChanges();
+    BOOST_CHECK_EQUAL(removals.size(), sizeof(uint32_t) + 2 * recordSize);
+
+    wallMarkers = wallMarkers->copyWithChanges(changes);
+    BOOST_REQUIRE_EQUAL(wallMarkers->rowCount(), 2);
+    BOOST_CHECK_EQUAL(getPosition(*wallMarkers, 1), pos2);
+
+    wallMarkers = wallMarkers->copyWithChanges(removals);
+    BOOST_REQUIRE_EQUAL(wallMarkers->rowCount(), 1);
+    BOOST_CHECK_EQUAL(getPosition(*wallMarkers, 0), pos2);
+}
@@ -0,0 +1,116 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE ObjectPoolTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "tools/ObjectPool.h"
+
+#include <thread>
+
+BOOST_AUTO_TEST_CASE(testReleasedObjectIsRecycled)
+{
+    ObjectPool<int> pool{2};
+
+    auto object = pool.acquire();
+    *object = 42;
+    const auto address = object.get();
+    object.reset();
+
+    const auto recycled = pool.acquire();
+    BOOST_CHECK_EQUAL(recycled.get(), address);
+    BOOST_CHECK_EQUAL(*recycled, 42);
+    BOOST_CHECK_EQUAL(pool.getSize(), 1);
+    BOOST_CHECK_EQUAL(pool.getHits(), 1);
+    BOOST_CHECK_EQUAL(pool.getMisses(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(testObjectInUseIsNotRecycled)
+{
+    ObjectPool<int> pool{2};
+
+    const auto object1 = pool.acquire();
+    const auto object2 = pool.acquire();
+    BOOST_CHECK_NE(object1, object2);
+    BOOST_CHECK_EQUAL(pool.getSize(), 2);
+    BOOST_CHECK_EQUAL(pool.getMisses(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(testPoolSizeIsBounded)
+{
+    ObjectPool<int> pool{1};
+
+    const auto object1 = pool.acquire();
+    pool.acquire();
+    pool.acquire();
+
+    BOOST_CHECK_EQUAL(pool.getSize(), 1);
+    BOOST_CHECK_EQUAL(pool.getHits(), 0);
+    BOOST_CHECK_EQUAL(pool.getMisses(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(testObjectReleasedByAnotherThreadIsRecycled)
+{
+    ObjectPool<std::vector<int>> pool{1};
+
+    auto object = pool.acquire();
+    const auto address = object.get();
+    std::thread{[object = std::move(object)] {
+        object->assign(1000, 42);
+    }}.join();
+
+    const auto recycled = pool.acquire();
+    BOOST_CHECK_EQUAL(recycled.get(), address);
+    BOOST_CHECK_EQUAL(recycled->size(), size_t(1000));
+    BOOST_CHECK_EQUAL(recycled->back(), 42);
+    BOOST_CHECK_EQUAL(pool.getHits(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(testObjectCanOutliveThePool)
+{
+    std::shared_ptr<int> object;
+    {
+        ObjectPool<int> pool{1};
+        object = pool.acquire();
+    }
+    *object = 42;
+    BOOST_CHECK_EQUAL(object.use_count(), 1);
+    object.reset();
+}
@@ -0,0 +1,143 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+
+#define BOOST_TEST_MODULE PDFTilerTests
+#include <boost/test/unit_test.hpp>
+
+#include "data/PDF.h"
+#include "data/QtImage.h"
+#include "datasources/PDFTiler.h"
+
+#include "MinimalGlobalQtApp.h"
+
+#include <QPainter>
+#include <QPdfWriter>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <cstdlib> // std::abs
+
+BOOST_GLOBAL_FIXTURE(MinimalGlobalQtApp);
+
+namespace
+{
+// Three tiles of 2048 pixels per row, the last one only partially covering
+// the page (904 pixels), so that each row of tiles gets a band of its own.
+const QSize imageSize{5000, 5000};
+
+void writePdf(const QString& filename)
+{
+    QPdfWriter writer{filename};
+    writer.setPageSize(QPageSize{QSizeF{100.0, 100.0}, QPageSize::Millimeter});
+    writer.setPageMargins(QMarginsF());
+
+    // A checkerboard of distinct colors and a diagonal, so that a tile cut
+    // from the wrong place in a band can not match its reference
+    QPainter painter{&writer};
+    const auto size = QSizeF{writer.width() / 10.0, writer.height() / 10.0};
+    for (int y = 0; y < 10; ++y)
+    {
+        for (int x = 0; x < 10; ++x)
+        {
+            const auto rect = QRectF{QPointF{x * size.width(),
+                                             y * size.height()},
+                                     size};
+            painter.fillRect(rect, QColor(25 * x, 25 * y, (x + y) % 2 * 255));
+        }
+    }
+    painter.setPen(QPen{Qt::black, size.width() / 10.0});
+    painter.drawLine(QPointF(0, 0), QPointF(writer.width(), writer.height()));
+}
+
+int maxChannelDifference(const Image& image, const QImage& reference)
+{
+    const auto data = image.getData();
+    const auto bytesPerLine = reference.width() * 4;
+    auto maxDiff = 0;
+    for (int y = 0; y < reference.height(); ++y)
+    {
+        const auto row = data + y * bytesPerLine;
+        const auto refRow = reference.constScanLine(y);
+        for (int i = 0; i < bytesPerLine; ++i)
+            maxDiff = std::max(maxDiff, std::abs(int(row[i]) - refRow[i]));
+    }
+    return maxDiff;
+}
+}
+
+BOOST_AUTO_TEST_CASE(testTilesCutFromBandsMatchDirectRendering)
+{
+    QTemporaryDir dir;
+    const auto filename = dir.path() + "/page.pdf";
+    writePdf(filename);
+
+    const PDFTiler tiler{filename, imageSize};
+    const auto area = tiler.getTilesArea(0, 0);
+    BOOST_REQUIRE_EQUAL(area, imageSize);
+
+    const auto tiles = tiler.computeVisibleSet(QRectF{QPointF(), area}, 0, 0);
+    BOOST_REQUIRE_EQUAL(tiles.size(), 9u);
+
+    const PDF pdf{filename};
+    const auto toNormalized =
+        QTransform::fromScale(1.0 / area.width(), 1.0 / area.height());
+
+    auto partialTiles = 0;
+    for (const auto tileId : tiles)
+    {
+        const auto tileRect = tiler.getTileRect(tileId);
+        if (!QRect(QPoint(), area).contains(tileRect))
+            ++partialTiles;
+
+        const auto tile = tiler.getTileImage(tileId, deflect::View::mono);
+        BOOST_REQUIRE(tile);
+        BOOST_REQUIRE_EQUAL(tile->getWidth(), tileRect.width());
+        BOOST_REQUIRE_EQUAL(tile->getHeight(), tileRect.height());
+
+        const auto reference = QtImage::toGlCompatibleFormat(
+            pdf.renderToImage(tileRect.size(),
+                              toNormalized.mapRect(QRectF{tileRect})));
+        BOOST_REQUIRE_EQUAL(reference.size(), tileRect.size());
+
+        // Allow for antialiasing differences at the edges of the regions
+        BOOST_CHECK_LE(maxChannelDifference(*tile, reference), 2);
+    }
+    BOOST_CHECK_EQUAL(partialTiles, 5);
+}
@@ -551,3 +551,25 @@ BOOST_AUTO_TEST_CASE(testTileSizeIsDivisorOf512)
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(testSetFrameWithSameLayoutReusesAssembler)
+{
+    SUBSAMP_LOOP
+    {
+        const auto image0 = TestImage(REF_IMAGE_SIZE, subsamp);
+        const auto image1 = TestImage(REF_IMAGE_SIZE / 2, subsamp);
+        const auto image2 = TestImage(REF_IMAGE_SIZE, subsamp);
+        const auto rowOrder = deflect::RowOrder::top_down;
+
+        PixelStreamAssembler assembler{createTestFrame(image0, rowOrder)};
+        BOOST_CHECK(assembler.setFrame(createTestFrame(image0, rowOrder)));
+        checkIndices(assembler, image0, 0);
+        checkRefImageTiles(assembler, image0, subsamp);
+
+        const auto multiChannelFrame =
+            createTestFrame(image0, image1, image2, rowOrder);
+        BOOST_CHECK(!assembler.setFrame(multiChannelFrame));
+        BOOST_CHECK(!assembler.setFrame(createTestFrame(image1, rowOrder)));
+        BOOST_CHECK(!assembler.setFrame(createTestFrame(image0, rowOrder, 32)));
+    }
+}
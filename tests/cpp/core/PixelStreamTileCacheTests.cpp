@@ -0,0 +1,128 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE PixelStreamTileCacheTests
+#include <boost/test/unit_test.hpp>
+
+#include "network/PixelStreamTileCache.h"
+
+#include <deflect/server/Frame.h>
+
+namespace
+{
+deflect::server::Tile makeTile(const int x, const QByteArray& data)
+{
+    deflect::server::Tile tile;
+    tile.x = x;
+    tile.width = 64;
+    tile.height = 64;
+    tile.format = deflect::Format::jpeg;
+    tile.imageData = data;
+    return tile;
+}
+
+deflect::server::Frame makeFrame(const QByteArray& data0,
+                                 const QByteArray& data1)
+{
+    deflect::server::Frame frame;
+    frame.uri = "stream";
+    frame.tiles.push_back(makeTile(0, data0));
+    frame.tiles.push_back(makeTile(64, data1));
+    return frame;
+}
+}
+
+BOOST_AUTO_TEST_CASE(testUnchangedTilesAreStrippedAndRestored)
+{
+    PixelStreamTileCache master;
+    PixelStreamTileCache wall;
+
+    auto frame1 = makeFrame("AAAA", "BBBB");
+    BOOST_CHECK_EQUAL(master.stripUnchangedTiles(frame1), 0u);
+    BOOST_CHECK(wall.restoreUnchangedTiles(frame1));
+
+    auto frame2 = makeFrame("AAAA", "CCCC");
+    BOOST_CHECK_EQUAL(master.stripUnchangedTiles(frame2), 1u);
+    BOOST_CHECK(frame2.tiles[0].imageData.isEmpty());
+    BOOST_CHECK_EQUAL(frame2.tiles[1].imageData.toStdString(), "CCCC");
+
+    BOOST_CHECK(wall.restoreUnchangedTiles(frame2));
+    BOOST_CHECK_EQUAL(frame2.tiles[0].imageData.toStdString(), "AAAA");
+    // The restored payload is shared with the previous frame
+    BOOST_CHECK(frame2.tiles[0].imageData.constData() ==
+                frame1.tiles[0].imageData.constData());
+}
+
+BOOST_AUTO_TEST_CASE(testTilesWithDifferentLayoutAreNotStripped)
+{
+    PixelStreamTileCache master;
+
+    auto frame1 = makeFrame("AAAA", "BBBB");
+    master.stripUnchangedTiles(frame1);
+
+    auto frame2 = makeFrame("AAAA", "BBBB");
+    frame2.tiles[0].width = 32;
+    frame2.tiles[1].format = deflect::Format::rgba;
+    BOOST_CHECK_EQUAL(master.stripUnchangedTiles(frame2), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(testRestoreFailsWithoutPreviousFrame)
+{
+    PixelStreamTileCache master;
+    PixelStreamTileCache wall;
+
+    auto frame1 = makeFrame("AAAA", "BBBB");
+    master.stripUnchangedTiles(frame1);
+
+    auto frame2 = makeFrame("AAAA", "BBBB");
+    BOOST_CHECK_EQUAL(master.stripUnchangedTiles(frame2), 2u);
+    BOOST_CHECK(!wall.restoreUnchangedTiles(frame2));
+}
+
+BOOST_AUTO_TEST_CASE(testClearTransmitsNextFrameInFull)
+{
+    PixelStreamTileCache master;
+
+    auto frame1 = makeFrame("AAAA", "BBBB");
+    master.stripUnchangedTiles(frame1);
+    master.clear();
+
+    auto frame2 = makeFrame("AAAA", "BBBB");
+    BOOST_CHECK_EQUAL(master.stripUnchangedTiles(frame2), 0u);
+}
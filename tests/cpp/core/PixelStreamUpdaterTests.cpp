@@ -0,0 +1,108 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE PixelStreamUpdaterTests
+#include <boost/test/unit_test.hpp>
+
+#include "datasources/PixelStreamUpdater.h"
+
+#include <deflect/server/Frame.h>
+
+namespace
+{
+const QString uri{"stream"};
+const int tileHeight = 32;
+
+deflect::server::FramePtr makeFrame(const int width)
+{
+    deflect::server::Tile tile;
+    tile.width = width;
+    tile.height = tileHeight;
+    tile.format = deflect::Format::rgba;
+    tile.imageData = QByteArray(width * tileHeight * 4, '\0');
+
+    auto frame = std::make_shared<deflect::server::Frame>();
+    frame->uri = uri;
+    frame->tiles.push_back(tile);
+    return frame;
+}
+
+QSize getFrameSize(const PixelStreamUpdater& updater)
+{
+    return updater.getTilesArea(0, 0);
+}
+}
+
+BOOST_AUTO_TEST_CASE(testSwapToMostRecentFrameDropsOlderFrames)
+{
+    PixelStreamUpdater updater{uri};
+    updater.setNextFrame(makeFrame(16));
+    updater.setNextFrame(makeFrame(32));
+    updater.setNextFrame(makeFrame(48));
+
+    updater.swapToFrame(2);
+    BOOST_CHECK_EQUAL(getFrameSize(updater), QSize(32, tileHeight));
+
+    updater.allowNextFrame();
+    updater.swapToFrame(3);
+    BOOST_CHECK_EQUAL(getFrameSize(updater), QSize(48, tileHeight));
+}
+
+BOOST_AUTO_TEST_CASE(testSwapIsSkippedForFramesNotQueued)
+{
+    PixelStreamUpdater updater{uri};
+    updater.setNextFrame(makeFrame(16));
+    updater.setNextFrame(makeFrame(32));
+
+    // Another process counts more frames than this one received
+    updater.swapToFrame(3);
+    BOOST_CHECK(!getFrameSize(updater).isValid());
+
+    updater.swapToFrame(2);
+    BOOST_CHECK_EQUAL(getFrameSize(updater), QSize(32, tileHeight));
+
+    // Another process counts fewer frames, the first one was already dropped
+    updater.allowNextFrame();
+    updater.swapToFrame(1);
+    BOOST_CHECK_EQUAL(getFrameSize(updater), QSize(32, tileHeight));
+
+    updater.setNextFrame(makeFrame(48));
+    updater.swapToFrame(3);
+    BOOST_CHECK_EQUAL(getFrameSize(updater), QSize(48, tileHeight));
+}
@@ -42,15 +42,47 @@
 
 #include "tools/ScreenshotAssembler.h"
 
+#include "config.h"
+
 #include "MinimalGlobalQtApp.h"
 #include "imageCompare.h"
 
+#include <QBuffer>
 #include <QColor>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QTemporaryDir>
 
 namespace
 {
 const SurfaceConfig referenceSurface{1920, 1080, 2, 1, 2, 3, 14, 12, QSizeF()};
 const QString referenceScreenshot{"./reference_screenshot.png"};
+
+QByteArray _compress(const QImage& image)
+{
+    QByteArray data;
+    QBuffer buffer{&data};
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    return data;
+}
+
+void _addScreens(ScreenshotAssembler& assembler, const SurfaceConfig& surface,
+                 const double scale = 1.0)
+{
+    const QSize screenSize{qRound(surface.getScreenWidth() * scale),
+                           qRound(surface.getScreenHeight() * scale)};
+    QImage screen{screenSize, QImage::Format_RGB32};
+
+    for (auto y = 0; y < (int)surface.screenCountY; ++y)
+    {
+        for (auto x = 0; x < (int)surface.screenCountX; ++x)
+        {
+            screen.fill(QColor{x * 64, y * 64, 128});
+            assembler.addImage(_compress(screen), {x, y});
+        }
+    }
+}
 }
 
 // Needed for relative path to resources to work
@@ -62,11 +94,9 @@ BOOST_AUTO_TEST_CASE(test_assemble_screenshot)
 
     ScreenshotAssembler assembler{surface};
 
-    QImage screenshot;
+    auto completed = 0;
     assembler.connect(&assembler, &ScreenshotAssembler::screenshotComplete,
-                      [&screenshot](const QImage image) {
-                          screenshot = image;
-                      });
+                      [&completed] { ++completed; });
 
     const QSize screenSize{(int)surface.getScreenWidth(),
                            (int)surface.getScreenHeight()};
@@ -79,17 +109,73 @@ BOOST_AUTO_TEST_CASE(test_assemble_screenshot)
         for (auto x = 0; x < (int)surface.screenCountX; ++x)
         {
             screen.fill(QColor{x * 64, y * 64, 128});
-            assembler.addImage(screen, {x, y});
+            assembler.addImage(_compress(screen), {x, y});
             const auto index = x + y * surface.screenCountX;
             if (index < screenCount - 1)
-                BOOST_CHECK(screenshot.isNull());
+                BOOST_CHECK(!assembler.isComplete());
         }
     }
 
-    BOOST_CHECK(!screenshot.isNull());
+    BOOST_CHECK(assembler.isComplete());
+    BOOST_CHECK_EQUAL(completed, 1);
+
+    const auto screenshot = assembler.assemble();
     BOOST_CHECK_EQUAL(screenshot.size(), surface.getTotalSize());
 
     QImage reference;
     BOOST_REQUIRE(reference.load(referenceScreenshot));
     BOOST_CHECK_LT(compareImages(screenshot, reference), 0.005);
 }
+
+BOOST_AUTO_TEST_CASE(test_assemble_scaled_screenshot)
+{
+    const auto& surface = referenceSurface;
+    const auto scale = 0.25;
+
+    ScreenshotAssembler assembler{surface, scale};
+    _addScreens(assembler, surface, scale);
+    BOOST_REQUIRE(assembler.isComplete());
+
+    const auto totalSize = surface.getTotalSize();
+    const QSize expectedSize{qRound(totalSize.width() * scale),
+                             qRound(totalSize.height() * scale)};
+    BOOST_CHECK_EQUAL(assembler.getSize(), expectedSize);
+
+    QImage reference;
+    BOOST_REQUIRE(reference.load(referenceScreenshot));
+    const auto scaledReference = reference.scaled(expectedSize);
+    BOOST_CHECK_LT(compareImages(assembler.assemble(), scaledReference), 0.02);
+}
+
+BOOST_AUTO_TEST_CASE(test_write_screenshot)
+{
+    const auto& surface = referenceSurface;
+
+    ScreenshotAssembler assembler{surface};
+    _addScreens(assembler, surface);
+    BOOST_REQUIRE(assembler.isComplete());
+
+    QImage reference;
+    BOOST_REQUIRE(reference.load(referenceScreenshot));
+
+    QTemporaryDir dir;
+    QStringList formats{"png"};
+#if TIDE_USE_TIFF
+    formats << "tif";
+#endif
+    for (const auto& format : formats)
+    {
+        const auto filename = dir.path() + "/screenshot." + format;
+        BOOST_REQUIRE_NO_THROW(assembler.write(filename));
+        BOOST_REQUIRE(QFileInfo{filename}.size() > 0);
+
+        // Qt's TIFF plugin is optional
+        if (!QImageReader::supportedImageFormats().contains(format.toLatin1()))
+            continue;
+
+        QImage screenshot;
+        BOOST_REQUIRE(screenshot.load(filename));
+        BOOST_CHECK_EQUAL(screenshot.size(), surface.getTotalSize());
+        BOOST_CHECK_LT(compareImages(screenshot, reference), 0.005);
+    }
+}
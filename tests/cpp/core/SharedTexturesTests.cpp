@@ -0,0 +1,224 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE SharedTexturesTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "data/QtImage.h"
+#include "qml/SharedTextures.h"
+
+#include <QImage>
+
+namespace
+{
+const QSize textureSize{64, 32};
+const uint rgba8 = 0x8058; // GL_RGBA8
+
+ImagePtr _createImage()
+{
+    return std::make_shared<QtImage>(
+        QImage{textureSize, QImage::Format_RGBA8888});
+}
+}
+
+BOOST_AUTO_TEST_CASE(uploaded_image_texture_is_shared)
+{
+    SharedTextures textures;
+    auto image = _createImage();
+    BOOST_CHECK(!textures.contains(*image));
+    BOOST_CHECK_EQUAL(textures.acquire(image, 0, false).id, 0);
+
+    textures.add(image, 0, {7, false, nullptr});
+    BOOST_CHECK(textures.contains(*image));
+
+    const auto texture = textures.acquire(image, 0, false);
+    BOOST_CHECK_EQUAL(texture.id, 7);
+    BOOST_CHECK(!texture.mipmaps);
+
+    // Other planes, other images and missing mipmaps are not shared
+    BOOST_CHECK_EQUAL(textures.acquire(image, 1, false).id, 0);
+    BOOST_CHECK_EQUAL(textures.acquire(_createImage(), 0, false).id, 0);
+    BOOST_CHECK_EQUAL(textures.acquire(image, 0, true).id, 0);
+}
+
+BOOST_AUTO_TEST_CASE(shared_texture_is_released_by_its_last_user)
+{
+    SharedTextures textures;
+    auto image = _createImage();
+    textures.add(image, 0, {7, true, nullptr});
+    BOOST_REQUIRE_EQUAL(textures.acquire(image, 0, true).id, 7);
+
+    BOOST_CHECK(!textures.claim(7));
+    BOOST_CHECK(textures.release(7));
+    BOOST_CHECK(!textures.release(7));
+
+    // Unknown textures are not used by others
+    BOOST_CHECK(!textures.release(8));
+    BOOST_CHECK(textures.claim(8));
+}
+
+BOOST_AUTO_TEST_CASE(claimed_texture_is_no_longer_shared)
+{
+    SharedTextures textures;
+    auto image = _createImage();
+    textures.add(image, 0, {7, false, nullptr});
+
+    BOOST_CHECK(textures.claim(7));
+    BOOST_CHECK(!textures.contains(*image));
+    BOOST_CHECK_EQUAL(textures.acquire(image, 0, false).id, 0);
+
+    auto nextImage = _createImage();
+    textures.add(nextImage, 0, {7, false, nullptr});
+    BOOST_CHECK_EQUAL(textures.acquire(nextImage, 0, false).id, 7);
+}
+
+BOOST_AUTO_TEST_CASE(destroyed_image_is_no_longer_shared)
+{
+    SharedTextures textures;
+    auto image = _createImage();
+    textures.add(image, 0, {7, false, nullptr});
+    image.reset();
+
+    BOOST_CHECK_EQUAL(textures.acquire(_createImage(), 0, false).id, 0);
+    BOOST_CHECK(!textures.release(7));
+}
+
+BOOST_AUTO_TEST_CASE(fences_expire_with_their_texture)
+{
+    SharedTextures textures;
+    int fences[2];
+    auto image = _createImage();
+    textures.add(image, 0, {7, false, &fences[0]});
+    BOOST_CHECK(textures.takeExpiredFences().empty());
+
+    BOOST_REQUIRE(textures.claim(7));
+    textures.add(image, 0, {7, false, &fences[1]});
+    auto expired = textures.takeExpiredFences();
+    BOOST_REQUIRE_EQUAL(expired.size(), 1);
+    BOOST_CHECK_EQUAL(expired[0], &fences[0]);
+
+    BOOST_CHECK(!textures.release(7));
+    expired = textures.takeExpiredFences();
+    BOOST_REQUIRE_EQUAL(expired.size(), 1);
+    BOOST_CHECK_EQUAL(expired[0], &fences[1]);
+}
+
+BOOST_AUTO_TEST_CASE(pooled_textures_are_reused)
+{
+    SharedTextures textures{2};
+    BOOST_CHECK_EQUAL(textures.takePooledTexture(textureSize, rgba8), 0);
+
+    BOOST_CHECK_EQUAL(textures.poolTexture(1, textureSize, rgba8), 0);
+    BOOST_CHECK_EQUAL(textures.poolTexture(2, textureSize, rgba8), 0);
+    BOOST_CHECK_EQUAL(textures.poolTexture(3, {32, 32}, rgba8), 1);
+    BOOST_CHECK_EQUAL(textures.getPooledTexturesCount(), 2);
+
+    BOOST_CHECK_EQUAL(textures.takePooledTexture(textureSize, rgba8), 2);
+    BOOST_CHECK_EQUAL(textures.takePooledTexture(textureSize, rgba8), 0);
+    const auto pooled = textures.takePooledTextures();
+    BOOST_REQUIRE_EQUAL(pooled.size(), 1);
+    BOOST_CHECK_EQUAL(pooled[0], 3);
+    BOOST_CHECK_EQUAL(textures.getPooledTexturesCount(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(uploaded_image_layer_is_shared)
+{
+    SharedTextures textures;
+    auto image = _createImage();
+    auto array = std::make_shared<TextureArray>(5, textureSize, 4);
+    BOOST_CHECK(!textures.acquireLayer(image).array);
+
+    textures.addLayer(image, {array, 2, nullptr});
+    BOOST_CHECK(textures.contains(*image));
+
+    const auto layer = textures.acquireLayer(image);
+    BOOST_CHECK_EQUAL(layer.array, array);
+    BOOST_CHECK_EQUAL(layer.index, 2);
+
+    // Layers are not textures, and other images are not shared
+    BOOST_CHECK_EQUAL(textures.acquire(image, 0, false).id, 0);
+    BOOST_CHECK(!textures.acquireLayer(_createImage()).array);
+
+    BOOST_CHECK(!textures.claimLayer(5, 2));
+    BOOST_CHECK(textures.releaseLayer(5, 2));
+    BOOST_CHECK(textures.claimLayer(5, 2));
+    BOOST_CHECK(!textures.acquireLayer(image).array);
+    BOOST_CHECK(!textures.releaseLayer(5, 2));
+}
+
+BOOST_AUTO_TEST_CASE(release_fences_are_taken_by_the_next_writer)
+{
+    SharedTextures textures{1};
+    int fences[4];
+    auto image = _createImage();
+    textures.add(image, 0, {7, false, nullptr});
+    BOOST_REQUIRE_EQUAL(textures.acquire(image, 0, false).id, 7);
+
+    // Claimed by the remaining user after the other one released it
+    BOOST_CHECK(textures.release(7, &fences[0]));
+    BOOST_REQUIRE(textures.claim(7));
+    auto released = textures.takeReleaseFences(7);
+    BOOST_REQUIRE_EQUAL(released.size(), 1);
+    BOOST_CHECK_EQUAL(released[0], &fences[0]);
+    BOOST_CHECK(textures.takeReleaseFences(7).empty());
+
+    // Taken from the pool by another user
+    BOOST_CHECK(!textures.release(7, &fences[1]));
+    BOOST_CHECK_EQUAL(textures.poolTexture(7, textureSize, rgba8), 0);
+    BOOST_CHECK_EQUAL(textures.takePooledTexture(textureSize, rgba8), 7);
+    released = textures.takeReleaseFences(7);
+    BOOST_REQUIRE_EQUAL(released.size(), 1);
+    BOOST_CHECK_EQUAL(released[0], &fences[1]);
+
+    // Deleted textures expire their release fences
+    BOOST_CHECK(!textures.release(7, &fences[2]));
+    BOOST_CHECK_EQUAL(textures.poolTexture(7, textureSize, rgba8), 0);
+    BOOST_CHECK_EQUAL(textures.poolTexture(8, textureSize, rgba8), 7);
+    BOOST_CHECK(!textures.releaseLayer(5, 1, &fences[3]));
+    BOOST_CHECK(textures.takeReleaseFences(5).empty());
+    textures.expireReleaseFences(5);
+
+    const auto expired = textures.takeExpiredFences();
+    BOOST_REQUIRE_EQUAL(expired.size(), 2);
+    BOOST_CHECK_EQUAL(expired[0], &fences[2]);
+    BOOST_CHECK_EQUAL(expired[1], &fences[3]);
+    BOOST_CHECK(textures.takeReleaseFences(7).empty());
+    BOOST_CHECK(textures.takeReleaseFences(5, 1).empty());
+}
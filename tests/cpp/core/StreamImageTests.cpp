@@ -155,3 +155,24 @@ BOOST_AUTO_TEST_CASE(testStreamImageYUV)
                                       expectedV.data() + vSize);
     }
 }
+
+BOOST_AUTO_TEST_CASE(testStreamImageWithScaleDivider)
+{
+    auto frame = createYuvTestFrame({8, 8}, 2);
+    auto& tile = frame->tiles[0];
+    tile.x = 64;
+    tile.y = 32;
+    tile.width = 30;
+    tile.height = 32;
+
+    StreamImage image(frame, 0, 4);
+
+    BOOST_CHECK_EQUAL(image.getPosition(), QPoint(16, 8));
+    BOOST_CHECK_EQUAL(image.getWidth(), 8);
+    BOOST_CHECK_EQUAL(image.getHeight(), 8);
+    BOOST_CHECK_EQUAL(image.getTextureSize(0), QSize(8, 8));
+    BOOST_CHECK_EQUAL(image.getTextureSize(1), QSize(4, 4));
+    BOOST_CHECK_EQUAL(image.getDataSize(0) + image.getDataSize(1) +
+                          image.getDataSize(2),
+                      size_t(tile.imageData.size()));
+}
@@ -132,3 +132,20 @@ BOOST_AUTO_TEST_CASE(testUpdateAndSyncAlwaysWithCallback)
     BOOST_CHECK_EQUAL(*result, *ptr);
     BOOST_CHECK_EQUAL(result.get(), ptr.get());
 }
+
+BOOST_AUTO_TEST_CASE(testPendingUpdateUntilSynchronized)
+{
+    IntPtr ptr(new int);
+    SwapSyncObject<IntPtr> syncObject;
+    BOOST_CHECK(!syncObject.hasPendingUpdate());
+
+    syncObject.update(ptr);
+    BOOST_CHECK(syncObject.hasPendingUpdate());
+
+    const auto neverSync = [](const uint64_t) { return false; };
+    BOOST_CHECK(!syncObject.sync(neverSync));
+    BOOST_CHECK(syncObject.hasPendingUpdate());
+
+    BOOST_CHECK(syncObject.sync(alwaysSync));
+    BOOST_CHECK(!syncObject.hasPendingUpdate());
+}
@@ -53,10 +53,12 @@ public:
     }
     virtual QRectF getCoord() const { return coord; }
     virtual void setCoord(const QRectF& rect) { coord = rect; }
-    virtual void uploadTexture(const Image& im) { image = &im; }
+    virtual void setScreenSize(const QSizeF& size) { screenSize = size; }
+    virtual void uploadTexture(const ImagePtr& im) { image = im.get(); }
     virtual void swap() { swapped = true; }
     TextureFormat format;
     QRectF coord;
+    QSizeF screenSize;
     const Image* image = nullptr;
     bool swapped = false;
 };
@@ -299,3 +301,71 @@ BOOST_FIXTURE_TEST_CASE(switch_texture_type_repeatedly, ImagesFixture)
         switcher.switchedTextureNodes = false;
     }
 }
+
+BOOST_FIXTURE_TEST_CASE(screen_size_is_set_before_upload, ImagesFixture)
+{
+    switcher.setScreenSize(QSizeF{640, 480});
+    updateSwitcher(images[0]);
+
+    auto& node = dynamic_cast<MockTextureNode&>(*textureNode);
+    BOOST_CHECK_EQUAL(node.screenSize, QSizeF(640, 480));
+
+    switcher.setScreenSize(QSizeF{320, 240});
+    BOOST_CHECK_EQUAL(node.screenSize, QSizeF(640, 480));
+    updateSwitcher(images[1]);
+    BOOST_CHECK_EQUAL(node.screenSize, QSizeF(320, 240));
+}
+
+BOOST_FIXTURE_TEST_CASE(screen_size_is_updated_without_upload, ImagesFixture)
+{
+    updateSwitcher(images[0]);
+    auto& node = dynamic_cast<MockTextureNode&>(*textureNode);
+    node.image = nullptr;
+
+    switcher.setScreenSize(QSizeF{320, 240});
+    switcher.update(textureNode, factory);
+    BOOST_CHECK_EQUAL(node.screenSize, QSizeF(320, 240));
+    BOOST_CHECK(!node.image);
+}
+
+BOOST_FIXTURE_TEST_CASE(deferred_upload_postpones_swap, ImagesFixture)
+{
+    updateSwitcher(images[0]);
+    auto& node = dynamic_cast<MockTextureNode&>(*textureNode);
+    node.swapped = false;
+
+    switcher.setNextImage(images[1]);
+    switcher.requestSwap();
+    for (int i = 0; i < 3; ++i)
+    {
+        switcher.update(textureNode, factory, false);
+        BOOST_CHECK_EQUAL(node.image, images[0].get());
+        BOOST_CHECK(!node.swapped);
+        BOOST_CHECK_EQUAL(switcher.getNextImage(), images[1]);
+    }
+
+    switcher.update(textureNode, factory);
+    BOOST_CHECK_EQUAL(node.image, images[1].get());
+    BOOST_CHECK(node.swapped);
+    BOOST_CHECK(!switcher.getNextImage());
+}
+
+BOOST_FIXTURE_TEST_CASE(reset_discards_pending_image_and_swap, ImagesFixture)
+{
+    updateSwitcher(images[0]);
+    switcher.setNextImage(images[1]);
+    switcher.requestSwap();
+    switcher.reset();
+    BOOST_CHECK(!switcher.getNextImage());
+
+    // The node of a reset switcher is recreated on the next image
+    textureNode.reset();
+    switcher.update(textureNode, factory);
+    BOOST_CHECK(!textureNode);
+
+    switcher.setNextImage(images[2]);
+    switcher.update(textureNode, factory);
+    auto& node = dynamic_cast<MockTextureNode&>(*textureNode);
+    BOOST_CHECK_EQUAL(node.image, images[2].get());
+    BOOST_CHECK(!node.swapped);
+}
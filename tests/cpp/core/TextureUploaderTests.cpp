@@ -0,0 +1,406 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE TextureUploaderTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "data/QtImage.h"
+#include "qml/TextureUploader.h"
+#include "qml/textureUtils.h"
+
+#include "QGuiAppFixture.h"
+
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+
+namespace
+{
+const QSize imageSize{64, 32};
+
+struct GLContextFixture : QGuiAppFixture
+{
+    std::unique_ptr<QOffscreenSurface> surface;
+    std::unique_ptr<QOpenGLContext> context;
+
+    GLContextFixture()
+    {
+        if (!app)
+            return;
+
+        surface.reset(new QOffscreenSurface);
+        surface->create();
+        context.reset(new QOpenGLContext);
+        if (!context->create() || !context->makeCurrent(surface.get()))
+            context.reset();
+    }
+
+    ~GLContextFixture()
+    {
+        if (context)
+            context->doneCurrent();
+    }
+};
+
+QImage _createImage(const QSize& size, const int seed)
+{
+    QImage image{size, QImage::Format_RGB32};
+    for (auto y = 0; y < size.height(); ++y)
+        for (auto x = 0; x < size.width(); ++x)
+            image.setPixel(x, y, qRgb((x + seed) % 256, y, seed % 256));
+    return image;
+}
+
+QImage _readTexture(const uint textureId, const QSize& size)
+{
+    auto context = QOpenGLContext::currentContext();
+    auto gl = context->functions();
+
+    GLuint fbo = 0;
+    gl->glGenFramebuffers(1, &fbo);
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    gl->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                               GL_TEXTURE_2D, textureId, 0);
+
+    // Texture rows are stored in upload order, no need to mirror the image
+    QImage image{size, QImage::Format_RGB32};
+    gl->glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    gl->glReadPixels(0, 0, size.width(), size.height(), GL_BGRA,
+                     GL_UNSIGNED_BYTE, image.bits());
+
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, context->defaultFramebufferObject());
+    gl->glDeleteFramebuffers(1, &fbo);
+    return image;
+}
+
+QImage _readTextureLayer(const TextureLayer& layer)
+{
+    using FramebufferTextureLayer = void(QOPENGLF_APIENTRYP)(GLenum, GLenum,
+                                                             GLuint, GLint,
+                                                             GLint);
+    auto context = QOpenGLContext::currentContext();
+    auto framebufferTextureLayer = reinterpret_cast<FramebufferTextureLayer>(
+        context->getProcAddress("glFramebufferTextureLayer"));
+    auto gl = context->functions();
+
+    GLuint fbo = 0;
+    gl->glGenFramebuffers(1, &fbo);
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    framebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                            layer.getArray()->getTextureId(), 0,
+                            layer.getIndex());
+
+    const auto size = layer.getArray()->getSize();
+    QImage image{size, QImage::Format_RGB32};
+    gl->glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    gl->glReadPixels(0, 0, size.width(), size.height(), GL_BGRA,
+                     GL_UNSIGNED_BYTE, image.bits());
+
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, context->defaultFramebufferObject());
+    gl->glDeleteFramebuffers(1, &fbo);
+    return image;
+}
+
+bool _uploadAndCompare(TextureUploader& uploader, const int seed)
+{
+    const auto source = _createImage(imageSize, seed);
+    const QtImage image{source};
+
+    const auto texture = uploader.acquireTexture(imageSize, GL_RGBA8);
+    uploader.upload(image, 0, texture, image.getGLPixelFormat());
+    const auto result = _readTexture(texture, imageSize) == source;
+    uploader.releaseTexture(texture, imageSize, GL_RGBA8);
+    return result;
+}
+}
+
+BOOST_FIXTURE_TEST_CASE(upload_image_to_texture, GLContextFixture)
+{
+    if (!context)
+        return;
+
+    TextureUploader uploader{3, 1024 * 1024};
+    BOOST_TEST_MESSAGE("persistent mapping: " << uploader.isPersistent());
+
+    BOOST_CHECK(_uploadAndCompare(uploader, 0));
+
+    const auto stats = uploader.endFrame();
+    BOOST_CHECK_EQUAL(stats.uploads, 1);
+    BOOST_CHECK_EQUAL(stats.bytes, imageSize.width() * imageSize.height() * 4);
+    BOOST_CHECK_EQUAL(stats.mipmapsGenerated, 1);
+    BOOST_CHECK_EQUAL(stats.mipmapsSkipped, 0);
+
+    const auto nextStats = uploader.endFrame();
+    BOOST_CHECK_EQUAL(nextStats.uploads, 0);
+    BOOST_CHECK_EQUAL(nextStats.bytes, 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(uploads_wrap_around_the_ring, GLContextFixture)
+{
+    if (!context)
+        return;
+
+    // Each segment fits two images, forcing the ring to wrap within frames
+    const auto imageBytes = imageSize.width() * imageSize.height() * 4;
+    TextureUploader uploader{2, size_t(imageBytes) * 2};
+
+    for (auto frame = 0; frame < 10; ++frame)
+    {
+        for (auto i = 0; i < 3; ++i)
+            BOOST_CHECK(_uploadAndCompare(uploader, frame * 3 + i));
+        BOOST_CHECK_EQUAL(uploader.endFrame().uploads, 3);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(upload_larger_than_segment, GLContextFixture)
+{
+    if (!context)
+        return;
+
+    TextureUploader uploader{2, 1024};
+    BOOST_CHECK(_uploadAndCompare(uploader, 42));
+    BOOST_CHECK_EQUAL(uploader.endFrame().uploads, 1);
+}
+
+BOOST_FIXTURE_TEST_CASE(upload_without_mipmaps, GLContextFixture)
+{
+    if (!context)
+        return;
+
+    TextureUploader uploader;
+    const QtImage image{_createImage(imageSize, 0)};
+    const auto texture = uploader.acquireTexture(imageSize, GL_RGBA8);
+    uploader.upload(image, 0, texture, image.getGLPixelFormat(), false);
+    uploader.releaseTexture(texture, imageSize, GL_RGBA8);
+
+    const auto stats = uploader.endFrame();
+    BOOST_CHECK_EQUAL(stats.mipmapsGenerated, 0);
+    BOOST_CHECK_EQUAL(stats.mipmapsSkipped, 1);
+}
+
+BOOST_FIXTURE_TEST_CASE(generate_mipmaps_after_upload, GLContextFixture)
+{
+    if (!context)
+        return;
+
+    TextureUploader uploader;
+    const QtImage image{_createImage(imageSize, 0)};
+    const auto texture = uploader.acquireTexture(imageSize, GL_RGBA8);
+    uploader.upload(image, 0, texture, image.getGLPixelFormat(), false);
+    uploader.generateMipmaps(texture);
+    uploader.releaseTexture(texture, imageSize, GL_RGBA8);
+
+    const auto stats = uploader.endFrame();
+    BOOST_CHECK_EQUAL(stats.mipmapsGenerated, 1);
+    BOOST_CHECK_EQUAL(stats.mipmapsSkipped, 1);
+}
+
+BOOST_AUTO_TEST_CASE(mipmaps_needed_for_static_or_minified_textures)
+{
+    using textureUtils::needMipmaps;
+    const QSize size{1000, 500};
+
+    BOOST_CHECK(needMipmaps(size, QSizeF(1000, 500), false));
+    BOOST_CHECK(needMipmaps(size, QSizeF(100, 50), false));
+
+    BOOST_CHECK(!needMipmaps(size, QSizeF(1000, 500), true));
+    BOOST_CHECK(!needMipmaps(size, QSizeF(2000, 1000), true));
+    BOOST_CHECK(!needMipmaps(size, QSizeF(500, 250), true));
+    BOOST_CHECK(needMipmaps(size, QSizeF(499, 249), true));
+    BOOST_CHECK(needMipmaps(size, QSizeF(1000, 200), true));
+
+    // Unknown screen size
+    BOOST_CHECK(needMipmaps(size, QSizeF(), true));
+}
+
+BOOST_FIXTURE_TEST_CASE(released_textures_are_reused, GLContextFixture)
+{
+    if (!context)
+        return;
+
+    TextureUploader uploader;
+
+    const auto texture = uploader.acquireTexture(imageSize, GL_RGBA8);
+    BOOST_CHECK_NE(texture, 0);
+    uploader.releaseTexture(texture, imageSize, GL_RGBA8);
+    BOOST_CHECK_EQUAL(uploader.getPooledTexturesCount(), 1);
+
+    // Different format or size
+    const auto textureR8 = uploader.acquireTexture(imageSize, GL_R8);
+    BOOST_CHECK_NE(textureR8, texture);
+    const auto otherSize = uploader.acquireTexture({32, 32}, GL_RGBA8);
+    BOOST_CHECK_NE(otherSize, texture);
+    BOOST_CHECK_EQUAL(uploader.getPooledTexturesCount(), 1);
+
+    BOOST_CHECK_EQUAL(uploader.acquireTexture(imageSize, GL_RGBA8), texture);
+    BOOST_CHECK_EQUAL(uploader.getPooledTexturesCount(), 0);
+
+    uploader.releaseTexture(texture, imageSize, GL_RGBA8);
+    uploader.releaseTexture(textureR8, imageSize, GL_R8);
+    uploader.releaseTexture(otherSize, {32, 32}, GL_RGBA8);
+}
+
+BOOST_FIXTURE_TEST_CASE(uploads_beyond_frame_budget_are_deferred,
+                        GLContextFixture)
+{
+    if (!context)
+        return;
+
+    using Priority = TextureUploader::Priority;
+
+    // Budget for two images per frame
+    const QtImage image{_createImage(imageSize, 0)};
+    TextureUploader uploader;
+    uploader.setFrameBudget(2 * image.getDataSize(0));
+
+    BOOST_CHECK(uploader.acquireBudget(image, Priority::visible));
+    BOOST_CHECK(uploader.acquireBudget(image, Priority::prefetch));
+    BOOST_CHECK(!uploader.acquireBudget(image, Priority::visible));
+    BOOST_CHECK(!uploader.acquireBudget(image, Priority::prefetch));
+    BOOST_CHECK(uploader.acquireBudget(image, Priority::dynamic));
+    BOOST_CHECK_EQUAL(uploader.endFrame().deferred, 2);
+
+    // Prefetching waits until the visible uploads have caught up
+    BOOST_CHECK(!uploader.acquireBudget(image, Priority::prefetch));
+    BOOST_CHECK(uploader.acquireBudget(image, Priority::visible));
+    BOOST_CHECK_EQUAL(uploader.endFrame().deferred, 1);
+
+    BOOST_CHECK(uploader.acquireBudget(image, Priority::prefetch));
+    BOOST_CHECK_EQUAL(uploader.endFrame().deferred, 0);
+
+    // At least one visible upload per frame, even beyond the budget
+    uploader.setFrameBudget(1);
+    BOOST_CHECK(uploader.acquireBudget(image, Priority::visible));
+    BOOST_CHECK(!uploader.acquireBudget(image, Priority::visible));
+    BOOST_CHECK_EQUAL(uploader.endFrame().deferred, 1);
+
+    // Unlimited budget
+    uploader.setFrameBudget(0);
+    for (int i = 0; i < 10; ++i)
+        BOOST_CHECK(uploader.acquireBudget(image, Priority::prefetch));
+    BOOST_CHECK_EQUAL(uploader.endFrame().deferred, 0);
+}
+
+BOOST_AUTO_TEST_CASE(texture_array_allocates_layers)
+{
+    auto array = std::make_shared<TextureArray>(0, imageSize, 2);
+    BOOST_CHECK_EQUAL(array->getUsedLayers(), 0);
+
+    auto first = std::make_unique<TextureLayer>(array, array->acquireLayer());
+    auto second = std::make_unique<TextureLayer>(array, array->acquireLayer());
+    BOOST_CHECK_EQUAL(first->getIndex(), 0);
+    BOOST_CHECK_EQUAL(second->getIndex(), 1);
+    BOOST_CHECK(array->isFull());
+    BOOST_CHECK_THROW(array->acquireLayer(), std::runtime_error);
+
+    first.reset();
+    BOOST_CHECK_EQUAL(array->getUsedLayers(), 1);
+    BOOST_CHECK_EQUAL(array->acquireLayer(), 0);
+    array->releaseLayer(0);
+}
+
+BOOST_AUTO_TEST_CASE(texture_array_tracks_outdated_mipmaps_per_layer)
+{
+    TextureArray array{0, imageSize, 4};
+    BOOST_CHECK(array.hasAlphaChannel());
+    BOOST_CHECK(array.takeOutdatedLayers().empty());
+
+    array.invalidateMipmaps(2);
+    array.invalidateMipmaps(0);
+    array.invalidateMipmaps(2);
+    array.invalidateMipmaps(3);
+    array.releaseLayer(3);
+    BOOST_CHECK((array.takeOutdatedLayers() == std::vector<uint>{2, 0}));
+    BOOST_CHECK(array.takeOutdatedLayers().empty());
+
+    // The mipmaps of compressed layers are uploaded
+    TextureArray compressed{0, imageSize, 4, GL_COMPRESSED_RGB_S3TC_DXT1_EXT};
+    BOOST_CHECK(!compressed.hasAlphaChannel());
+    compressed.invalidateMipmaps(1);
+    BOOST_CHECK(compressed.takeOutdatedLayers().empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(upload_image_to_texture_array_layer, GLContextFixture)
+{
+    if (!context)
+        return;
+
+    TextureUploader uploader;
+    if (!uploader.hasTextureArrays())
+    {
+        BOOST_TEST_MESSAGE("texture arrays not supported");
+        return;
+    }
+
+    auto first = uploader.acquireLayer(imageSize);
+    auto second = uploader.acquireLayer(imageSize);
+    auto other = uploader.acquireLayer({32, 32});
+    BOOST_CHECK_EQUAL(first->getArray(), second->getArray());
+    BOOST_CHECK_NE(first->getIndex(), second->getIndex());
+    BOOST_CHECK_NE(first->getArray(), other->getArray());
+
+    const auto source = _createImage(imageSize, 7);
+    const QtImage image{source};
+    uploader.uploadToLayer(image, *second);
+    BOOST_CHECK(_readTextureLayer(*second) == source);
+    BOOST_CHECK_THROW(uploader.uploadToLayer(image, *other),
+                      std::invalid_argument);
+
+    // Only the uploaded layer gets its mipmaps generated
+    uploader.generateMipmaps(*second->getArray());
+    uploader.generateMipmaps(*second->getArray());
+    BOOST_CHECK(_readTextureLayer(*second) == source);
+
+    auto stats = uploader.endFrame();
+    BOOST_CHECK_EQUAL(stats.uploads, 1);
+    BOOST_CHECK_EQUAL(stats.mipmapsGenerated, 1);
+    BOOST_CHECK_EQUAL(stats.textureArrays, 2);
+    BOOST_CHECK_EQUAL(stats.arrayLayers, 3);
+
+    first.reset();
+    second.reset();
+    other.reset();
+    stats = uploader.endFrame();
+    BOOST_CHECK_EQUAL(stats.arrayLayers, 0);
+}
@@ -0,0 +1,151 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE TiffPyramidWriterTests
+#include <boost/test/unit_test.hpp>
+
+#include "data/TiffPyramidReader.h"
+#include "data/TiffPyramidWriter.h"
+
+#include "MinimalGlobalQtApp.h"
+
+#include <QImage>
+#include <QPainter>
+#include <QTemporaryDir>
+
+BOOST_GLOBAL_FIXTURE(MinimalGlobalQtApp);
+
+namespace
+{
+const QSize imageSize{1000, 600};
+const QSize tileSize{256, 256};
+
+// Quadrants aligned on the tiles of the two first levels
+const QRect redArea{0, 0, 512, 256};
+const QRect greenArea{512, 0, 488, 256};
+const QRect blueArea{0, 256, 512, 344};
+const QRect whiteArea{512, 256, 488, 344};
+
+QString createSourceImage(const QTemporaryDir& dir, const char* format)
+{
+    QImage image{imageSize, QImage::Format_RGB32};
+    QPainter painter{&image};
+    painter.fillRect(redArea, Qt::red);
+    painter.fillRect(greenArea, Qt::green);
+    painter.fillRect(blueArea, Qt::blue);
+    painter.fillRect(whiteArea, Qt::white);
+    painter.end();
+    const auto path = dir.filePath(QString{"source."} + format);
+    BOOST_REQUIRE(image.save(path, format));
+    return path;
+}
+
+void checkColor(const QColor& pixel, const QColor& expected)
+{
+    BOOST_CHECK_SMALL(pixel.red() - expected.red(), 16);
+    BOOST_CHECK_SMALL(pixel.green() - expected.green(), 16);
+    BOOST_CHECK_SMALL(pixel.blue() - expected.blue(), 16);
+}
+
+void checkTileColor(const QImage& tile, const QColor& expected)
+{
+    BOOST_REQUIRE_EQUAL(tile.size(), tileSize);
+    for (const auto& pos : {QPoint{8, 8}, QPoint{128, 128}, QPoint{200, 40}})
+        checkColor(tile.pixel(pos), expected);
+}
+
+void checkPyramid(const QString& path)
+{
+    TiffPyramidReader reader{path};
+    BOOST_CHECK_EQUAL(reader.getImageSize(), imageSize);
+    BOOST_CHECK_EQUAL(reader.getTileSize(), tileSize);
+    BOOST_CHECK_EQUAL(reader.findTopPyramidLevel(), 2u);
+    BOOST_CHECK_EQUAL(reader.readSize(1), QSize(500, 300));
+    BOOST_CHECK_EQUAL(reader.readSize(2), QSize(250, 150));
+
+    checkTileColor(reader.readTile(0, 0, 0), Qt::red);
+    checkTileColor(reader.readTile(3, 0, 0), Qt::green);
+    checkTileColor(reader.readTile(1, 1, 0), Qt::blue);
+    checkTileColor(reader.readTile(2, 1, 0), Qt::white);
+
+    const auto top = reader.readTile(0, 0, 1);
+    BOOST_REQUIRE_EQUAL(top.size(), tileSize);
+    checkColor(top.pixel(64, 64), Qt::red);
+    checkColor(top.pixel(64, 192), Qt::blue);
+}
+}
+
+BOOST_AUTO_TEST_CASE(testInvalidTileSizeIsRejected)
+{
+    BOOST_CHECK_THROW(TiffPyramidWriter{100}, std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(testWritePyramidFromRegularImage)
+{
+    QTemporaryDir dir;
+    const auto source = createSourceImage(dir, "png");
+    const auto target = dir.filePath("pyramid.tif");
+
+    auto lastProgress = 0.0;
+    TiffPyramidWriter writer{uint(tileSize.width())};
+    writer.setProgressCallback(
+        [&lastProgress](const double progress) { lastProgress = progress; });
+    writer.write(source, target);
+
+    BOOST_CHECK_EQUAL(lastProgress, 1.0);
+    checkPyramid(target);
+}
+
+BOOST_AUTO_TEST_CASE(testWritePyramidFromTiffImage)
+{
+    QTemporaryDir dir;
+    const auto source = createSourceImage(dir, "tiff");
+    const auto target = dir.filePath("pyramid.tif");
+
+    TiffPyramidWriter{uint(tileSize.width())}.write(source, target);
+    checkPyramid(target);
+}
+
+BOOST_AUTO_TEST_CASE(testWriteFailsForInvalidSource)
+{
+    QTemporaryDir dir;
+    BOOST_CHECK_THROW(TiffPyramidWriter{}.write(dir.filePath("none.png"),
+                                                dir.filePath("pyramid.tif")),
+                      std::runtime_error);
+}
@@ -0,0 +1,128 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE TileDiskCacheTests
+#include <boost/test/unit_test.hpp>
+
+#include "tools/TileDiskCache.h"
+
+#include "MinimalGlobalQtApp.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+
+BOOST_GLOBAL_FIXTURE(MinimalGlobalQtApp);
+
+namespace
+{
+QImage makeImage(const QColor& color)
+{
+    QImage image{256, 256, QImage::Format_RGB32};
+    image.fill(color);
+    return image;
+}
+}
+
+BOOST_AUTO_TEST_CASE(testStoredTileCanBeLoaded)
+{
+    QTemporaryDir dir;
+    TileDiskCache cache{dir.path(), 1024 * 1024};
+
+    const auto image = makeImage(Qt::red);
+    BOOST_CHECK(cache.load("tile").isNull());
+    cache.store("tile", image);
+
+    const auto loaded = cache.load("tile");
+    BOOST_CHECK(loaded.convertToFormat(image.format()) == image);
+
+    const auto stats = cache.getStatistics();
+    BOOST_CHECK_EQUAL(stats.hits, 1u);
+    BOOST_CHECK_EQUAL(stats.misses, 1u);
+    BOOST_CHECK_GT(stats.diskUsage, 0u);
+
+    TileDiskCache otherProcessCache{dir.path(), 1024 * 1024};
+    BOOST_CHECK_EQUAL(otherProcessCache.getStatistics().diskUsage,
+                      stats.diskUsage);
+    BOOST_CHECK(!otherProcessCache.load("tile").isNull());
+}
+
+BOOST_AUTO_TEST_CASE(testKeyIdentifiesFileAndTile)
+{
+    QTemporaryDir dir;
+    const auto file = dir.path() + "/content.svg";
+    QFile{file}.open(QIODevice::WriteOnly);
+
+    const auto mono = deflect::View::mono;
+    const auto key = TileDiskCache::makeKey(file, QSize(100, 100), 0, mono);
+    BOOST_CHECK(!key.isEmpty());
+    BOOST_CHECK_EQUAL(key.toStdString(),
+                      TileDiskCache::makeKey(file, QSize(100, 100), 0, mono)
+                          .toStdString());
+    BOOST_CHECK_NE(key.toStdString(),
+                   TileDiskCache::makeKey(file, QSize(100, 100), 1, mono)
+                       .toStdString());
+    BOOST_CHECK_NE(key.toStdString(),
+                   TileDiskCache::makeKey(file, QSize(200, 200), 0, mono)
+                       .toStdString());
+
+    BOOST_CHECK(TileDiskCache::makeKey(dir.path() + "/missing.svg",
+                                       QSize(100, 100), 0, mono)
+                    .isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(testCacheIsEvictedWhenFull)
+{
+    QTemporaryDir dir;
+
+    qint64 tileSize = 0;
+    {
+        TileDiskCache cache{dir.path(), 1024 * 1024};
+        cache.store("probe", makeImage(Qt::black));
+        tileSize = cache.getStatistics().diskUsage;
+        QFile::remove(dir.path() + "/probe.png");
+    }
+
+    const auto maxSize = tileSize * 3;
+    TileDiskCache cache{dir.path(), maxSize};
+    for (int i = 0; i < 10; ++i)
+        cache.store(QString::number(i), makeImage(Qt::black));
+
+    BOOST_CHECK_LE(cache.getStatistics().diskUsage, uint64_t(maxSize));
+    BOOST_CHECK_LE(QDir{dir.path()}.entryList(QDir::Files).size(), 3);
+}
@@ -0,0 +1,108 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE TilePoolTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "qml/Tile.h"
+#include "qml/TilePool.h"
+
+#include "QGuiAppFixture.h"
+
+namespace
+{
+const QRect tileRect{0, 0, 64, 32};
+}
+
+BOOST_FIXTURE_TEST_CASE(released_tiles_are_reused, QGuiAppFixture)
+{
+    if (!app)
+        return;
+
+    TilePool pool;
+
+    auto tile = pool.acquire(1, tileRect, TextureType::static_);
+    const auto rawTile = tile.get();
+    const std::weak_ptr<Tile> weakTile = tile;
+    tile->setShowBorder(true);
+    tile->swapImage();
+    BOOST_REQUIRE(tile->isVisible());
+    BOOST_REQUIRE_EQUAL(tile->size(), QSizeF(tileRect.size()));
+
+    tile.reset();
+    BOOST_CHECK(weakTile.expired());
+    BOOST_CHECK_EQUAL(pool.getStatistics().created, 1);
+    BOOST_CHECK_EQUAL(pool.getStatistics().reused, 0);
+    BOOST_CHECK_EQUAL(pool.getStatistics().pooled, 1);
+
+    const QRect otherRect{32, 32, 16, 16};
+    auto reused = pool.acquire(2, otherRect, TextureType::dynamic);
+    BOOST_CHECK_EQUAL(reused.get(), rawTile);
+    BOOST_CHECK_EQUAL(reused->getId(), 2);
+    BOOST_CHECK(!reused->isVisible());
+    BOOST_CHECK(!reused->getShowBorder());
+    BOOST_CHECK_EQUAL(reused->size(), QSizeF());
+    BOOST_CHECK(reused->shared_from_this() == reused);
+    BOOST_CHECK_EQUAL(pool.getStatistics().created, 1);
+    BOOST_CHECK_EQUAL(pool.getStatistics().reused, 1);
+    BOOST_CHECK_EQUAL(pool.getStatistics().pooled, 0);
+
+    reused->swapImage();
+    BOOST_CHECK_EQUAL(reused->position(), QPointF(otherRect.topLeft()));
+    BOOST_CHECK_EQUAL(reused->size(), QSizeF(otherRect.size()));
+}
+
+BOOST_FIXTURE_TEST_CASE(pool_size_is_limited, QGuiAppFixture)
+{
+    if (!app)
+        return;
+
+    TilePool pool{2};
+
+    std::vector<TilePtr> tiles;
+    for (uint i = 0; i < 3; ++i)
+        tiles.push_back(pool.acquire(i, tileRect, TextureType::static_));
+    tiles.clear();
+    BOOST_CHECK_EQUAL(pool.getStatistics().created, 3);
+    BOOST_CHECK_EQUAL(pool.getStatistics().pooled, 2);
+
+    pool.clear();
+    BOOST_CHECK_EQUAL(pool.getStatistics().pooled, 0);
+}
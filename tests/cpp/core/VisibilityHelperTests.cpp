@@ -46,6 +46,8 @@
 
 #include "DummyContent.h"
 
+#include <random>
+
 namespace
 {
 const QSize groupSize(800, 600);
@@ -254,3 +256,45 @@ BOOST_FIXTURE_TEST_CASE(testHiddenWindowNotObstructingOthers, Fixture)
     BOOST_CHECK_EQUAL(helper.getVisibleArea(*window), QRectF());
     BOOST_CHECK_EQUAL(helper.getVisibleArea(*otherWindow), coord);
 }
+
+BOOST_AUTO_TEST_CASE(testVisibleAreasOfAllWindowsMatchSingleWindowQueries)
+{
+    auto group = DisplayGroup::create(groupSize);
+    std::mt19937 rng{42};
+    std::uniform_real_distribution<qreal> pos{-100.0, 800.0};
+    std::uniform_real_distribution<qreal> dim{20.0, 300.0};
+    std::uniform_int_distribution<int> kind{0, 9};
+
+    for (int i = 0; i < 300; ++i)
+    {
+        const auto type = kind(rng);
+        auto content =
+            type == 0 ? makeTransparentContent() : makeDummyContent();
+        const auto windowType =
+            type == 1 ? Window::WindowType::PANEL : Window::WindowType::DEFAULT;
+        auto window = std::make_shared<Window>(std::move(content), windowType);
+        window->setCoordinates(
+            QRectF(pos(rng), pos(rng) * 0.75, dim(rng), dim(rng)));
+        if (type == 2)
+            window->setState(Window::WindowState::HIDDEN);
+        group->add(window);
+    }
+
+    for (const auto blending : {false, true})
+    {
+        const auto helper = VisibilityHelper{*group, viewRect, blending};
+        const auto areas = helper.getVisibleAreas();
+        const auto& windows = group->getWindows();
+        BOOST_REQUIRE_EQUAL(areas.size(), windows.size());
+
+        size_t visibleCount = 0;
+        for (size_t i = 0; i < windows.size(); ++i)
+        {
+            BOOST_CHECK_EQUAL(areas[i], helper.getVisibleArea(*windows[i]));
+            if (!areas[i].isEmpty())
+                ++visibleCount;
+        }
+        BOOST_CHECK_GT(visibleCount, 0u);
+        BOOST_CHECK_LT(visibleCount, windows.size());
+    }
+}
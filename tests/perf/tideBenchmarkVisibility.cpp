@@ -0,0 +1,176 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "scene/DisplayGroup.h"
+#include "scene/ImageContent.h"
+#include "scene/Window.h"
+#include "tools/VisibilityHelper.h"
+#include "utils/CommandLineParser.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+// Example way to run this program:
+// ./tideBenchmarkVisibility --iterations 100
+//
+// Prints the average time of one visibility pass for scenes of 50, 200 and
+// 500 windows, using per-window queries and the single-pass spatial index.
+
+namespace
+{
+const QSize wallSize(7680, 3240);
+const QRect screenRect(QPoint(1920, 1080), QSize(1920, 1080));
+const QSizeF thumbnailSize(400, 300);
+
+class Timer
+{
+public:
+    using clock = std::chrono::high_resolution_clock;
+
+    void start() { _startTime = clock::now(); }
+    float elapsedMs() const
+    {
+        const auto now = clock::now();
+        return std::chrono::duration<float, std::milli>{now - _startTime}
+            .count();
+    }
+
+private:
+    clock::time_point _startTime;
+};
+
+namespace po = boost::program_options;
+
+class BenchmarkOptions : public CommandLineParser
+{
+public:
+    BenchmarkOptions()
+    {
+        // clang-format off
+        desc.add_options()
+            ("iterations,i", po::value<size_t>()->default_value(100u),
+             "number of visibility passes per scene")
+        ;
+        // clang-format on
+    }
+    size_t iterations() const { return vm["iterations"].as<size_t>(); }
+};
+
+/** Thumbnails laid out like a folder load, with some random overlaps. */
+DisplayGroupPtr makeScene(const size_t windowsCount)
+{
+    auto group = DisplayGroup::create(wallSize);
+    std::mt19937 rng{0};
+    std::uniform_real_distribution<qreal> jitter{-150.0, 150.0};
+
+    const auto columns = int(wallSize.width() / thumbnailSize.width());
+    for (size_t i = 0; i < windowsCount; ++i)
+    {
+        const auto col = int(i) % columns;
+        const auto row = int(i) / columns;
+        const auto x = col * thumbnailSize.width() + jitter(rng);
+        const auto y = row * thumbnailSize.height() / 4 + jitter(rng);
+
+        auto content = std::make_unique<ImageContent>("thumbnail.png");
+        auto window = std::make_shared<Window>(std::move(content));
+        window->setCoordinates(QRectF(QPointF(x, y), thumbnailSize));
+        group->add(window);
+    }
+    return group;
+}
+
+float benchmarkPerWindow(const DisplayGroup& group, const size_t iterations)
+{
+    const auto helper = VisibilityHelper{group, screenRect, false};
+    Timer timer;
+    timer.start();
+    size_t visible = 0;
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        for (const auto& window : group.getWindows())
+            visible += !helper.getVisibleArea(*window).isEmpty();
+    }
+    const auto elapsed = timer.elapsedMs() / iterations;
+    if (visible == 0)
+        std::cerr << "warning: no visible window" << std::endl;
+    return elapsed;
+}
+
+float benchmarkAllWindows(const DisplayGroup& group, const size_t iterations)
+{
+    const auto helper = VisibilityHelper{group, screenRect, false};
+    Timer timer;
+    timer.start();
+    size_t visible = 0;
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        for (const auto& area : helper.getVisibleAreas())
+            visible += !area.isEmpty();
+    }
+    const auto elapsed = timer.elapsedMs() / iterations;
+    if (visible == 0)
+        std::cerr << "warning: no visible window" << std::endl;
+    return elapsed;
+}
+}
+
+/**
+ * Compare the cost of computing the visible areas of all windows with
+ * individual queries versus a single pass using a spatial index.
+ */
+int main(int argc, char** argv)
+{
+    COMMAND_LINE_PARSER_CHECK(BenchmarkOptions, "tideBenchmarkVisibility");
+
+    const auto iterations = std::max(commandLine.iterations(), size_t(1));
+
+    std::cout << "Windows | Per-window [ms] | All windows [ms]" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    for (const auto windowsCount : {50u, 200u, 500u})
+    {
+        const auto group = makeScene(windowsCount);
+        std::cout << std::setw(7) << windowsCount << " | " << std::setw(15)
+                  << benchmarkPerWindow(*group, iterations) << " | "
+                  << std::setw(16) << benchmarkAllWindows(*group, iterations)
+                  << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
@@ -40,6 +40,7 @@
 #include "config.h"
 #include "types.h"
 
+#include "data/TileCacheStatistics.h"
 #include "network/MessageHeader.h"
 #include "scene/Window.h"
 
@@ -70,6 +71,7 @@ struct MetaTypeRegistration
         qRegisterMetaType<QUuid>("QUuid");
         qRegisterMetaType<ScreenLockPtr>("ScreenLockPtr");
         qRegisterMetaType<std::string>("std::string");
+        qRegisterMetaType<TileCacheStatistics>("TileCacheStatistics");
         qRegisterMetaType<TilePtr>("TilePtr");
         qRegisterMetaType<TileWeakPtr>("TileWeakPtr");
         qRegisterMetaTypeStreamOperators<QUuid>("QUuid");
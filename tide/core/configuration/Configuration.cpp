@@ -237,6 +237,14 @@ void Configuration::_loadXml()
     parser.get(uri.arg("content", "maxScale"), settings.contentMaxScale);
     parser.get(uri.arg("content", "maxScaleVectorial"),
                settings.contentMaxScaleVectorial);
+    parser.get(uri.arg("content", "tilingThreshold"),
+               settings.imageTilingThreshold);
+    parser.get(uri.arg("pixelstream", "pipelineDepth"),
+               settings.pixelStreamPipelineDepth);
+    parser.get(uri.arg("textures", "uploadBudget"),
+               settings.textureUploadBudget);
+    parser.get(uri.arg("tilecache", "directory"), folders.tileCache);
+    parser.get(uri.arg("tilecache", "maxSize"), settings.tileCacheMaxSize);
 }
 
 bool Configuration::_saveJson(const QString& filename) const
@@ -81,6 +81,9 @@ public:
 
         /** Directory for saving session contents uploaded via web interface. */
         QString upload;
+
+        /** Directory for caching rendered tiles on wall hosts (optional). */
+        QString tileCache;
     } folders;
 
     struct Global
@@ -132,6 +135,18 @@ public:
 
         /** Maximum scaling factor for vectorial contents. */
         double contentMaxScaleVectorial = 0.0;
+
+        /** Images larger than this (width or height) are tiled by the walls. */
+        uint imageTilingThreshold = 4096;
+
+        /** Maximum number of frames in flight for each pixel stream. */
+        uint pixelStreamPipelineDepth = 2;
+
+        /** Static content uploaded per frame per screen in MB, 0: no limit. */
+        uint textureUploadBudget = 24;
+
+        /** Maximum size of the tile cache on each wall host in MB. */
+        uint tileCacheMaxSize = 4096;
     } settings;
 
     struct Webbrowser
@@ -0,0 +1,474 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "CompressedImage.h"
+
+#include <QOpenGLFunctions> // GL_RGBA
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring> // std::memcpy
+#include <limits>
+
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+
+namespace
+{
+const int blockSize = 4;
+const int blockBytes = 8;
+const int powerIterations = 4;
+
+using Block = std::array<QRgb, blockSize * blockSize>;
+using Palette = std::array<QRgb, 4>;
+
+uint _getMipmapLevels(const QSize& size)
+{
+    uint levels = 1;
+    for (auto extent = std::max(size.width(), size.height()); extent > 1;
+         extent /= 2)
+    {
+        ++levels;
+    }
+    return levels;
+}
+
+QSize _getLevelSize(const QSize& size, const uint level)
+{
+    return {std::max(1, size.width() >> level),
+            std::max(1, size.height() >> level)};
+}
+
+size_t _getBlocksCount(const QSize& size)
+{
+    return size_t((size.width() + blockSize - 1) / blockSize) *
+           size_t((size.height() + blockSize - 1) / blockSize);
+}
+
+uint16_t _toRgb565(const float r, const float g, const float b)
+{
+    const auto quantize = [](const float value, const int max) {
+        const auto v = std::round(std::min(std::max(value, 0.f), 255.f) *
+                                  max / 255.f);
+        return uint16_t(v);
+    };
+    return uint16_t(quantize(r, 31) << 11 | quantize(g, 63) << 5 |
+                    quantize(b, 31));
+}
+
+QRgb _fromRgb565(const uint16_t color)
+{
+    const int r = (color >> 11) & 31;
+    const int g = (color >> 5) & 63;
+    const int b = color & 31;
+    return qRgb((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2));
+}
+
+Palette _getPalette(const uint16_t c0, const uint16_t c1)
+{
+    const auto p0 = _fromRgb565(c0);
+    const auto p1 = _fromRgb565(c1);
+    const auto mix = [&](const int w0, const int w1) {
+        const auto sum = w0 + w1;
+        return qRgb((qRed(p0) * w0 + qRed(p1) * w1) / sum,
+                    (qGreen(p0) * w0 + qGreen(p1) * w1) / sum,
+                    (qBlue(p0) * w0 + qBlue(p1) * w1) / sum);
+    };
+    // The second mode (c0 <= c1) has 3 colors and transparent black
+    if (c0 > c1)
+        return {{p0, p1, mix(2, 1), mix(1, 2)}};
+    return {{p0, p1, mix(1, 1), qRgb(0, 0, 0)}};
+}
+
+int _distance(const QRgb a, const QRgb b)
+{
+    const auto dr = qRed(a) - qRed(b);
+    const auto dg = qGreen(a) - qGreen(b);
+    const auto db = qBlue(a) - qBlue(b);
+    return dr * dr + dg * dg + db * db;
+}
+
+/**
+ * Find the endpoints of a block along the principal axis of its colors, which
+ * is the line that best fits them in the RGB space.
+ */
+void _findEndpoints(const Block& block, uint16_t& c0, uint16_t& c1)
+{
+    float mean[3] = {0.f, 0.f, 0.f};
+    for (const auto pixel : block)
+    {
+        mean[0] += qRed(pixel);
+        mean[1] += qGreen(pixel);
+        mean[2] += qBlue(pixel);
+    }
+    for (auto& m : mean)
+        m /= block.size();
+
+    // Covariance matrix: rr, rg, rb, gg, gb, bb
+    float cov[6] = {0.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+    for (const auto pixel : block)
+    {
+        const auto r = qRed(pixel) - mean[0];
+        const auto g = qGreen(pixel) - mean[1];
+        const auto b = qBlue(pixel) - mean[2];
+        cov[0] += r * r;
+        cov[1] += r * g;
+        cov[2] += r * b;
+        cov[3] += g * g;
+        cov[4] += g * b;
+        cov[5] += b * b;
+    }
+
+    float axis[3] = {1.f, 1.f, 1.f};
+    for (int i = 0; i < powerIterations; ++i)
+    {
+        const float next[3] = {
+            cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2],
+            cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2],
+            cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2]};
+        const auto norm = std::max({std::abs(next[0]), std::abs(next[1]),
+                                    std::abs(next[2])});
+        if (norm < 1e-6f)
+            break;
+        for (int c = 0; c < 3; ++c)
+            axis[c] = next[c] / norm;
+    }
+
+    auto minPixel = block[0];
+    auto maxPixel = block[0];
+    auto minDot = std::numeric_limits<float>::max();
+    auto maxDot = std::numeric_limits<float>::lowest();
+    for (const auto pixel : block)
+    {
+        const auto dot = qRed(pixel) * axis[0] + qGreen(pixel) * axis[1] +
+                         qBlue(pixel) * axis[2];
+        if (dot < minDot)
+        {
+            minDot = dot;
+            minPixel = pixel;
+        }
+        if (dot > maxDot)
+        {
+            maxDot = dot;
+            maxPixel = pixel;
+        }
+    }
+
+    // Move the endpoints inwards, where the interpolated colors fit better
+    const auto inset = [](const int low, const int high) {
+        return (high - low) / 16.f;
+    };
+    const auto insetR = inset(qRed(minPixel), qRed(maxPixel));
+    const auto insetG = inset(qGreen(minPixel), qGreen(maxPixel));
+    const auto insetB = inset(qBlue(minPixel), qBlue(maxPixel));
+    c0 = _toRgb565(qRed(maxPixel) - insetR, qGreen(maxPixel) - insetG,
+                   qBlue(maxPixel) - insetB);
+    c1 = _toRgb565(qRed(minPixel) + insetR, qGreen(minPixel) + insetG,
+                   qBlue(minPixel) + insetB);
+
+    // Keep the four colors mode
+    if (c0 < c1)
+        std::swap(c0, c1);
+}
+
+uint32_t _findIndices(const Block& block, const uint16_t c0, const uint16_t c1,
+                      int& error)
+{
+    error = 0;
+    if (c0 == c1)
+    {
+        const auto color = _fromRgb565(c0);
+        for (const auto pixel : block)
+            error += _distance(pixel, color);
+        return 0;
+    }
+
+    const auto palette = _getPalette(c0, c1);
+    uint32_t indices = 0;
+    for (size_t i = 0; i < block.size(); ++i)
+    {
+        uint32_t best = 0;
+        auto bestDistance = _distance(block[i], palette[0]);
+        for (uint32_t j = 1; j < palette.size(); ++j)
+        {
+            const auto distance = _distance(block[i], palette[j]);
+            if (distance < bestDistance)
+            {
+                best = j;
+                bestDistance = distance;
+            }
+        }
+        indices |= best << (2 * i);
+        error += bestDistance;
+    }
+    return indices;
+}
+
+/**
+ * Fit the endpoints to the pixels for the given indices, by least squares.
+ * @return false if the indices do not determine the endpoints.
+ */
+bool _refineEndpoints(const Block& block, const uint32_t indices, uint16_t& c0,
+                      uint16_t& c1)
+{
+    // Weights of the endpoints for each index of the four colors mode
+    const float weights[4][2] = {
+        {1.f, 0.f}, {0.f, 1.f}, {2.f / 3.f, 1.f / 3.f}, {1.f / 3.f, 2.f / 3.f}};
+
+    float aa = 0.f, ab = 0.f, bb = 0.f;
+    float ax[3] = {0.f, 0.f, 0.f};
+    float bx[3] = {0.f, 0.f, 0.f};
+    for (size_t i = 0; i < block.size(); ++i)
+    {
+        const auto& w = weights[(indices >> (2 * i)) & 3];
+        const float pixel[3] = {float(qRed(block[i])), float(qGreen(block[i])),
+                                float(qBlue(block[i]))};
+        aa += w[0] * w[0];
+        ab += w[0] * w[1];
+        bb += w[1] * w[1];
+        for (int c = 0; c < 3; ++c)
+        {
+            ax[c] += w[0] * pixel[c];
+            bx[c] += w[1] * pixel[c];
+        }
+    }
+
+    const auto det = aa * bb - ab * ab;
+    if (std::abs(det) < 1e-6f)
+        return false;
+
+    float a[3];
+    float b[3];
+    for (int c = 0; c < 3; ++c)
+    {
+        a[c] = (ax[c] * bb - bx[c] * ab) / det;
+        b[c] = (bx[c] * aa - ax[c] * ab) / det;
+    }
+    c0 = _toRgb565(a[0], a[1], a[2]);
+    c1 = _toRgb565(b[0], b[1], b[2]);
+    if (c0 < c1)
+        std::swap(c0, c1);
+    return true;
+}
+
+void _compressBlock(const Block& block, uint8_t* output)
+{
+    uint16_t c0 = 0;
+    uint16_t c1 = 0;
+    _findEndpoints(block, c0, c1);
+
+    int error = 0;
+    auto indices = _findIndices(block, c0, c1, error);
+
+    uint16_t refined0 = c0;
+    uint16_t refined1 = c1;
+    if (c0 != c1 && _refineEndpoints(block, indices, refined0, refined1))
+    {
+        int refinedError = 0;
+        const auto refinedIndices =
+            _findIndices(block, refined0, refined1, refinedError);
+        if (refinedError < error)
+        {
+            c0 = refined0;
+            c1 = refined1;
+            indices = refinedIndices;
+        }
+    }
+
+    // Little-endian layout of the block
+    output[0] = uint8_t(c0 & 0xff);
+    output[1] = uint8_t(c0 >> 8);
+    output[2] = uint8_t(c1 & 0xff);
+    output[3] = uint8_t(c1 >> 8);
+    for (int i = 0; i < 4; ++i)
+        output[4 + i] = uint8_t(indices >> (8 * i));
+}
+
+QByteArray _compress(const QImage& image)
+{
+    QByteArray blocks(int(_getBlocksCount(image.size()) * blockBytes),
+                      Qt::Uninitialized);
+    auto output = reinterpret_cast<uint8_t*>(blocks.data());
+
+    const auto maxX = image.width() - 1;
+    const auto maxY = image.height() - 1;
+    Block block;
+    for (int by = 0; by <= maxY; by += blockSize)
+    {
+        for (int bx = 0; bx <= maxX; bx += blockSize)
+        {
+            // Blocks on the borders repeat the last row and column of pixels
+            for (int y = 0; y < blockSize; ++y)
+            {
+                const auto line = reinterpret_cast<const QRgb*>(
+                    image.constScanLine(std::min(by + y, maxY)));
+                for (int x = 0; x < blockSize; ++x)
+                    block[y * blockSize + x] = line[std::min(bx + x, maxX)];
+            }
+            _compressBlock(block, output);
+            output += blockBytes;
+        }
+    }
+    return blocks;
+}
+
+QImage _decompress(const QByteArray& blocks, const QSize& size)
+{
+    QImage image{size, QImage::Format_RGB32};
+    auto input = reinterpret_cast<const uint8_t*>(blocks.constData());
+
+    for (int by = 0; by < size.height(); by += blockSize)
+    {
+        for (int bx = 0; bx < size.width(); bx += blockSize)
+        {
+            const auto c0 = uint16_t(input[0] | input[1] << 8);
+            const auto c1 = uint16_t(input[2] | input[3] << 8);
+            uint32_t indices = 0;
+            std::memcpy(&indices, input + 4, sizeof(indices));
+            const auto palette = _getPalette(c0, c1);
+
+            const auto height = std::min(blockSize, size.height() - by);
+            const auto width = std::min(blockSize, size.width() - bx);
+            for (int y = 0; y < height; ++y)
+            {
+                auto line = reinterpret_cast<QRgb*>(image.scanLine(by + y));
+                for (int x = 0; x < width; ++x)
+                {
+                    const auto i = y * blockSize + x;
+                    line[bx + x] = palette[(indices >> (2 * i)) & 3];
+                }
+            }
+            input += blockBytes;
+        }
+    }
+    return image;
+}
+}
+
+CompressedImage::CompressedImage(const QImage& image)
+    : _size{image.size()}
+{
+    if (image.isNull())
+        throw std::invalid_argument("cannot compress a null image");
+
+    auto level = image.convertToFormat(QImage::Format_RGB32);
+    const auto levels = _getMipmapLevels(_size);
+    for (uint i = 0; i < levels; ++i)
+    {
+        if (i > 0)
+        {
+            level = level.scaled(_getLevelSize(_size, i), Qt::IgnoreAspectRatio,
+                                 Qt::SmoothTransformation);
+        }
+        _levels.push_back(_compress(level));
+    }
+}
+
+bool CompressedImage::canCompress(const QImage& image)
+{
+    if (image.isNull())
+        return false;
+    if (!image.hasAlphaChannel())
+        return true;
+
+    // Formats with an alpha channel are often used for opaque images too
+    const auto argb = image.convertToFormat(QImage::Format_ARGB32);
+    for (int y = 0; y < argb.height(); ++y)
+    {
+        const auto line = reinterpret_cast<const QRgb*>(argb.constScanLine(y));
+        for (int x = 0; x < argb.width(); ++x)
+        {
+            if (qAlpha(line[x]) != 255)
+                return false;
+        }
+    }
+    return true;
+}
+
+int CompressedImage::getWidth() const
+{
+    return _size.width();
+}
+
+int CompressedImage::getHeight() const
+{
+    return _size.height();
+}
+
+QSize CompressedImage::getTextureSize(const uint level) const
+{
+    return level < _levels.size() ? _getLevelSize(_size, level) : QSize();
+}
+
+const uint8_t* CompressedImage::getData(const uint level) const
+{
+    return reinterpret_cast<const uint8_t*>(_levels.at(level).constData());
+}
+
+size_t CompressedImage::getDataSize(const uint level) const
+{
+    return level < _levels.size() ? size_t(_levels[level].size()) : 0;
+}
+
+TextureFormat CompressedImage::getFormat() const
+{
+    return TextureFormat::rgba;
+}
+
+uint CompressedImage::getGLPixelFormat() const
+{
+    return GL_RGBA;
+}
+
+uint CompressedImage::getGLCompressedFormat() const
+{
+    return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+}
+
+uint CompressedImage::getMipmapLevels() const
+{
+    return uint(_levels.size());
+}
+
+QImage CompressedImage::decompress() const
+{
+    return _decompress(_levels.front(), _size);
+}
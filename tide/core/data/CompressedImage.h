@@ -0,0 +1,111 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef COMPRESSEDIMAGE_H
+#define COMPRESSEDIMAGE_H
+
+#include "Image.h"
+
+#include <QByteArray>
+#include <QImage>
+
+#include <vector>
+
+/**
+ * An opaque image compressed in BC1 (S3TC DXT1) blocks for the GPU.
+ *
+ * BC1 stores each block of 4x4 pixels in 8 bytes, which is 8 times less than
+ * uncompressed RGBA for the texture memory and the uploads. OpenGL can not
+ * generate the mipmaps of compressed textures, so they are computed and
+ * compressed along with the image. The texture planes of the image are the
+ * levels of its mipmap chain, down to 1x1 pixels.
+ */
+class CompressedImage : public Image
+{
+public:
+    /**
+     * Compress an image and its mipmaps.
+     * @param image the source image, its alpha channel is ignored.
+     * @throw std::invalid_argument if the image is null.
+     */
+    explicit CompressedImage(const QImage& image);
+
+    /** @return true if an image is opaque and can be compressed. */
+    static bool canCompress(const QImage& image);
+
+    /** @copydoc Image::getWidth */
+    int getWidth() const final;
+
+    /** @copydoc Image::getHeight */
+    int getHeight() const final;
+
+    /** @return the dimensions of the given mipmap level. */
+    QSize getTextureSize(uint level = 0) const final;
+
+    /** @return the compressed blocks of the given mipmap level. */
+    const uint8_t* getData(uint level = 0) const final;
+
+    /** @return the size of the compressed blocks of the given mipmap level. */
+    size_t getDataSize(uint level = 0) const final;
+
+    /** @copydoc Image::getFormat */
+    TextureFormat getFormat() const final;
+
+    /** @return the OpenGL format of the decompressed texels. */
+    uint getGLPixelFormat() const final;
+
+    /** @copydoc Image::getGLCompressedFormat */
+    uint getGLCompressedFormat() const final;
+
+    /** @copydoc Image::getMipmapLevels */
+    uint getMipmapLevels() const final;
+
+    /**
+     * Decompress the full resolution level, for the OpenGL implementations
+     * which do not support the compressed format.
+     * @return the decompressed image in RGB32 format.
+     */
+    QImage decompress() const;
+
+private:
+    QSize _size;
+    std::vector<QByteArray> _levels;
+};
+
+#endif
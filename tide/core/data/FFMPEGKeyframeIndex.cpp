@@ -0,0 +1,77 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "FFMPEGKeyframeIndex.h"
+
+#include <algorithm>
+#include <iterator>
+
+FFMPEGKeyframeIndex::FFMPEGKeyframeIndex(std::vector<int64_t> keyframes)
+    : _keyframes{std::move(keyframes)}
+{
+    std::sort(_keyframes.begin(), _keyframes.end());
+    _keyframes.erase(std::unique(_keyframes.begin(), _keyframes.end()),
+                     _keyframes.end());
+}
+
+size_t FFMPEGKeyframeIndex::size() const
+{
+    return _keyframes.size();
+}
+
+bool FFMPEGKeyframeIndex::covers(const int64_t frameIndex) const
+{
+    return !_keyframes.empty() && frameIndex >= _keyframes.front() &&
+           frameIndex <= _keyframes.back();
+}
+
+int64_t FFMPEGKeyframeIndex::findPrevious(const int64_t frameIndex) const
+{
+    const auto it = std::upper_bound(_keyframes.begin(), _keyframes.end(),
+                                     frameIndex);
+    if (it == _keyframes.begin())
+        return -1;
+    return *std::prev(it);
+}
+
+bool FFMPEGKeyframeIndex::isSeekFaster(const int64_t from,
+                                       const int64_t to) const
+{
+    return to < from || findPrevious(to) > from;
+}
@@ -0,0 +1,100 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef FFMPEGKEYFRAMEINDEX_H
+#define FFMPEGKEYFRAMEINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Sorted frame indices of the keyframes of a video stream.
+ *
+ * The index may be partial, for instance when the container has no index and
+ * keyframes are only discovered while demuxing. It is authoritative up to its
+ * last keyframe, beyond which its answers are unknown.
+ *
+ * The frame indices derive from the decoding timestamps (DTS) of the index
+ * entries of the demuxer, the same timeline as seeking and the decoded frames
+ * of FFMPEGMovie (see FFMPEGFrame::getTimestamp()). With B-frames, a keyframe
+ * is thus indexed up to the reordering delay of the encoder before the frame
+ * at which it is presented.
+ */
+class FFMPEGKeyframeIndex
+{
+public:
+    /** Create an empty index. */
+    FFMPEGKeyframeIndex() = default;
+
+    /**
+     * Create an index.
+     * @param keyframes the frame indices of the keyframes, in any order
+     */
+    explicit FFMPEGKeyframeIndex(std::vector<int64_t> keyframes);
+
+    /** @return the number of keyframes in the index. */
+    size_t size() const;
+
+    /** @return true if the index can tell the keyframe before a frame. */
+    bool covers(int64_t frameIndex) const;
+
+    /**
+     * Find the keyframe to decode from to reach a frame.
+     * @param frameIndex the frame to reach
+     * @return the last keyframe at or before frameIndex, -1 if not indexed
+     */
+    int64_t findPrevious(int64_t frameIndex) const;
+
+    /**
+     * Check if seeking is faster than decoding forward to reach a frame.
+     *
+     * Seeking is needed to go backwards, and faster to go forwards if a
+     * keyframe lies between the two frames.
+     * @param from the last frame decoded
+     * @param to the frame to reach, must be covered by the index
+     * @return true if the decoder should seek
+     */
+    bool isSeekFaster(int64_t from, int64_t to) const;
+
+private:
+    std::vector<int64_t> _keyframes;
+};
+
+#endif
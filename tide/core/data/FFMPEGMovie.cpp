@@ -48,6 +48,7 @@ extern "C"
 }
 
 #include "FFMPEGFrame.h"
+#include "FFMPEGKeyframeIndex.h"
 #include "FFMPEGPicture.h"
 #include "FFMPEGUtils.h"
 #include "FFMPEGVideoStream.h"
@@ -132,6 +133,7 @@ FFMPEGMovie::FFMPEGMovie(const QString& uri)
                   "non-optimal.",
                   uri.toStdString().c_str(), fmt);
     }
+    _updateKeyframes();
 }
 
 FFMPEGMovie::~FFMPEGMovie() = default;
@@ -166,6 +168,11 @@ double FFMPEGMovie::getFrameDuration() const
     return _videoStream->getFrameDuration();
 }
 
+void FFMPEGMovie::setActive(const bool active)
+{
+    _videoStream->setActive(active);
+}
+
 PicturePtr FFMPEGMovie::getFrame(double posInSeconds)
 {
     posInSeconds = std::max(0.0, std::min(posInSeconds, getDuration()));
@@ -178,15 +185,59 @@ PicturePtr FFMPEGMovie::getFrame(double posInSeconds)
     int64_t frameIndexCurr = _frameLastDecode;
     _frameLastDecode = _frameIndex;
 
-    // Seek back for loop or forward if too far away
-    const auto streamDelta = frameIndex - frameIndexCurr;
-    if (streamDelta < 0 || std::abs(streamDelta) > MIN_SEEK_DELTA_FRAMES)
+    // Seek back for loop or forward if faster than decoding
+    if (_isSeekFaster(frameIndexCurr, frameIndex))
     {
         if (!_videoStream->seekToNearestFullframe(frameIndex))
             return nullptr;
     }
 
-    const auto targetTimestamp = _videoStream->getTimestamp(frameIndex);
+    auto picture = _decode(_videoStream->getTimestamp(frameIndex));
+    _updateKeyframes();
+    return picture;
+}
+
+double FFMPEGMovie::findKeyframe(double posInSeconds) const
+{
+    posInSeconds = std::max(0.0, std::min(posInSeconds, getDuration()));
+    const auto frameDuration = _videoStream->getFrameDuration();
+    const auto target = std::max(0.0, posInSeconds - frameDuration);
+    const auto frameIndex = _videoStream->getFrameIndex(target);
+
+    std::shared_ptr<const FFMPEGKeyframeIndex> keyframes;
+    {
+        const std::lock_guard<std::mutex> lock(_keyframesMutex);
+        keyframes = _keyframes;
+    }
+    if (!keyframes || !keyframes->covers(frameIndex))
+        return -1.0;
+
+    // Middle of the interval where getFrame() returns the keyframe, which is
+    // shifted by one frame duration
+    const auto keyframe = keyframes->findPrevious(frameIndex);
+    return std::min((keyframe + 1.5) * frameDuration, getDuration());
+}
+
+bool FFMPEGMovie::_isSeekFaster(const int64_t from, const int64_t to)
+{
+    const auto keyframes = _videoStream->getKeyframeIndex();
+    if (keyframes->covers(to))
+        return keyframes->isSeekFaster(from, to);
+
+    // Without index, seek if the target is more than a few frames away
+    const auto streamDelta = to - from;
+    return streamDelta < 0 || std::abs(streamDelta) > MIN_SEEK_DELTA_FRAMES;
+}
+
+void FFMPEGMovie::_updateKeyframes()
+{
+    auto keyframes = _videoStream->getKeyframeIndex();
+    const std::lock_guard<std::mutex> lock(_keyframesMutex);
+    _keyframes = std::move(keyframes);
+}
+
+PicturePtr FFMPEGMovie::_decode(const int64_t targetTimestamp)
+{
     if (targetTimestamp == AV_NOPTS_VALUE)
         return nullptr;
 
@@ -214,9 +265,25 @@ PicturePtr FFMPEGMovie::getFrame(double posInSeconds)
         }
     }
 
-    // handle (rare) EOF case
+    // At the end of the stream the last frames are still held by the decoder
+    // (reordering of B-frames, frame threading) and must be drained. If none
+    // reaches the target, which happens when the number of frames was
+    // overestimated, the last one is the closest.
     if (avReadStatus < 0)
-        picture = PicturePtr();
+    {
+        auto drained = std::make_shared<FFMPEGFrame>();
+        while (_videoStream->drain(*drained))
+        {
+            std::swap(frame, drained);
+            if (frame->getTimestamp() >= targetTimestamp)
+                break;
+        }
+        if (frame->getAVFrame().data[0])
+        {
+            picture = std::make_shared<FFMPEGPicture>(
+                FFMPEGUtils::convertToYUV(frame));
+        }
+    }
 
     return picture;
 }
@@ -44,6 +44,9 @@
 
 #include "types.h"
 
+#include <memory>
+#include <mutex>
+
 /**
  * Read and play movies using the FFMPEG library.
  */
@@ -77,6 +80,14 @@ public:
     /** Get the duration of a frame in seconds. */
     double getFrameDuration() const;
 
+    /**
+     * Set if the movie is visible and playing.
+     *
+     * Only active movies share the decoding threads of the process; the new
+     * thread count of a movie is applied at its next seek.
+     */
+    void setActive(bool active);
+
     /**
      * Get a frame at the given position in seconds.
      *
@@ -86,12 +97,32 @@ public:
      */
     PicturePtr getFrame(double posInSeconds);
 
+    /**
+     * Find the keyframe preceding the given position, for fast previews.
+     *
+     * Unless the container has an index, only the keyframes demuxed by the
+     * previous calls to getFrame() are known, so the result may differ between
+     * processes that played different parts of the movie. Threadsafe.
+     *
+     * @param posInSeconds request position in seconds; clamped if out-of-bounds
+     * @return a position for getFrame() to decode only the keyframe, or a
+     *         negative value if the keyframes of the position are not indexed
+     */
+    double findKeyframe(double posInSeconds) const;
+
 private:
     AVFormatContextPtr _avFormatContext;
     std::unique_ptr<FFMPEGVideoStream> _videoStream;
     int64_t _frameIndex = 0;
     int64_t _frameLastDecode = 0;
     double _streamPosition = 0.0;
+
+    mutable std::mutex _keyframesMutex;
+    std::shared_ptr<const FFMPEGKeyframeIndex> _keyframes;
+
+    bool _isSeekFaster(int64_t from, int64_t to);
+    void _updateKeyframes();
+    PicturePtr _decode(int64_t targetTimestamp);
 };
 
 #endif
@@ -0,0 +1,199 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "FFMPEGThreadBudget.h"
+
+#include "utils/log.h"
+
+#include <QThread>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+namespace
+{
+uint _getThreadCountOverride()
+{
+    const auto envStr = getenv("TIDE_FFMPEG_THREADS");
+    if (!envStr || std::string(envStr).empty())
+        return 0;
+    try
+    {
+        return std::max(std::stoi(envStr), 0);
+    }
+    catch (...)
+    {
+        print_log(LOG_WARN, LOG_AV, "Could not parse TIDE_FFMPEG_THREADS: %s",
+                  envStr);
+        return 0;
+    }
+}
+} // namespace
+
+constexpr uint FFMPEGThreadBudget::maxThreadsPerMovie;
+constexpr uint FFMPEGThreadBudget::minLoadingThreads;
+
+FFMPEGThreadBudget& FFMPEGThreadBudget::instance()
+{
+    static FFMPEGThreadBudget budget(std::max(QThread::idealThreadCount(), 1));
+    return budget;
+}
+
+FFMPEGThreadBudget::FFMPEGThreadBudget(const uint coreCount)
+    : _hostCoreCount{std::max(coreCount, 1u)}
+    , _threadCountOverride{_getThreadCountOverride()}
+{
+}
+
+void FFMPEGThreadBudget::setProcessCount(const uint count)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _processCount = std::max(count, 1u);
+    _notify(lock);
+}
+
+uint FFMPEGThreadBudget::getCoreCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _getCoreCount();
+}
+
+uint FFMPEGThreadBudget::add(const uint width, const uint height)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    const auto pixels = std::max(size_t(width) * size_t(height), size_t(1));
+    const auto id = _nextId++;
+    _movies[id] = Movie{pixels, true};
+    _activePixels += pixels;
+    _notify(lock);
+    return id;
+}
+
+void FFMPEGThreadBudget::remove(const uint id)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    const auto it = _movies.find(id);
+    if (it == _movies.end())
+        return;
+    if (it->second.active)
+        _activePixels -= it->second.pixels;
+    _movies.erase(it);
+    _notify(lock);
+}
+
+void FFMPEGThreadBudget::setActive(const uint id, const bool active)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    const auto it = _movies.find(id);
+    if (it == _movies.end() || it->second.active == active)
+        return;
+    auto& movie = it->second;
+    movie.active = active;
+    if (active)
+        _activePixels += movie.pixels;
+    else
+        _activePixels -= movie.pixels;
+    _notify(lock);
+}
+
+uint FFMPEGThreadBudget::getThreadCount(const uint id) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto it = _movies.find(id);
+    if (it == _movies.end())
+        return _threadCountOverride > 0 ? _threadCountOverride : 1;
+    return _getThreadCount(it->second);
+}
+
+uint FFMPEGThreadBudget::getLoadingThreadCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _getLoadingThreadCount();
+}
+
+void FFMPEGThreadBudget::setLoadingThreadsCallback(
+    LoadingThreadsCallback callback)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _loadingThreadsCallback = std::move(callback);
+    _notify(lock);
+}
+
+uint FFMPEGThreadBudget::_getCoreCount() const
+{
+    return std::max(_hostCoreCount / _processCount, 1u);
+}
+
+uint FFMPEGThreadBudget::_getThreadCount(const Movie& movie) const
+{
+    if (_threadCountOverride > 0)
+        return _threadCountOverride;
+
+    if (!movie.active)
+        return 1;
+
+    const auto cores = std::max(_getCoreCount(), minLoadingThreads + 1) -
+                       minLoadingThreads;
+    const auto share = double(cores) * movie.pixels / _activePixels;
+    return std::min(std::max(uint(share), 1u), maxThreadsPerMovie);
+}
+
+uint FFMPEGThreadBudget::_getLoadingThreadCount() const
+{
+    // Content loading threads calling the decoders only wait for them
+    int available = _getCoreCount();
+    for (const auto& movie : _movies)
+    {
+        if (movie.second.active)
+            available -= int(_getThreadCount(movie.second)) - 1;
+    }
+    return std::max(available, int(minLoadingThreads));
+}
+
+void FFMPEGThreadBudget::_notify(std::unique_lock<std::mutex>& lock)
+{
+    if (!_loadingThreadsCallback)
+        return;
+
+    const auto callback = _loadingThreadsCallback;
+    const auto count = _getLoadingThreadCount();
+    lock.unlock();
+    callback(count);
+}
@@ -0,0 +1,147 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef FFMPEGTHREADBUDGET_H
+#define FFMPEGTHREADBUDGET_H
+
+#include "types.h"
+
+#include <functional>
+#include <map>
+#include <mutex>
+
+/**
+ * Share the cores of a process between movie decoding and content loading.
+ *
+ * The cores of the host are divided between the wall processes running on it.
+ * A few of the process cores are kept for the asynchronous loading of content,
+ * the others are shared by the decoders of the visible, playing movies. Each
+ * movie receives a part proportional to its resolution, with at least one and
+ * at most maxThreadsPerMovie threads; inactive movies get a single thread.
+ * Decoders apply their current share the next time they seek, and the loading
+ * thread pool is given the cores that the decoders leave. The
+ * TIDE_FFMPEG_THREADS environment variable overrides the budget with a fixed
+ * thread count for all movies.
+ */
+class FFMPEGThreadBudget
+{
+public:
+    /** Frame threading in FFMPEG does not scale beyond this thread count. */
+    static constexpr uint maxThreadsPerMovie = 16;
+
+    /** Cores of the process that are kept for loading content. */
+    static constexpr uint minLoadingThreads = 2;
+
+    /** Called with the number of threads available for loading content. */
+    using LoadingThreadsCallback = std::function<void(uint)>;
+
+    /** @return the budget shared by all the movies of the process. */
+    static FFMPEGThreadBudget& instance();
+
+    /**
+     * Create a budget.
+     * @param coreCount the number of cores of the host
+     */
+    explicit FFMPEGThreadBudget(uint coreCount);
+
+    /**
+     * Set the number of processes that share the cores of the host.
+     * @param count of processes on the host, minimum 1
+     */
+    void setProcessCount(uint count);
+
+    /** @return the number of cores available to the process. */
+    uint getCoreCount() const;
+
+    /**
+     * Add an active movie to the budget.
+     * @param width of the movie frames
+     * @param height of the movie frames
+     * @return a unique identifier for the movie
+     */
+    uint add(uint width, uint height);
+
+    /** Remove a movie from the budget, releasing its threads to the others. */
+    void remove(uint id);
+
+    /**
+     * Set if a movie is active, i.e. visible and playing.
+     * @param id of the movie
+     * @param active true to share the decoding threads with the movie
+     */
+    void setActive(uint id, bool active);
+
+    /** @return the current number of decoding threads of a movie. */
+    uint getThreadCount(uint id) const;
+
+    /**
+     * @return the number of threads for loading content, which includes the
+     *         threads waiting for the decoders of the active movies.
+     */
+    uint getLoadingThreadCount() const;
+
+    /**
+     * Set a callback to apply the loading thread count when it changes.
+     * The callback is also called immediately with the current count.
+     */
+    void setLoadingThreadsCallback(LoadingThreadsCallback callback);
+
+private:
+    struct Movie
+    {
+        size_t pixels;
+        bool active;
+    };
+
+    mutable std::mutex _mutex;
+    const uint _hostCoreCount;
+    uint _processCount = 1;
+    uint _threadCountOverride = 0;
+    uint _nextId = 0;
+    std::map<uint, Movie> _movies;
+    size_t _activePixels = 0;
+    LoadingThreadsCallback _loadingThreadsCallback;
+
+    uint _getCoreCount() const;
+    uint _getThreadCount(const Movie& movie) const;
+    uint _getLoadingThreadCount() const;
+    void _notify(std::unique_lock<std::mutex>& lock);
+};
+
+#endif
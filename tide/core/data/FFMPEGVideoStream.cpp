@@ -41,14 +41,17 @@
 
 #include "FFMPEGFrame.h"
 #include "FFMPEGPicture.h"
+#include "FFMPEGThreadBudget.h"
 #include "utils/log.h"
 
-#include <cstdlib>
 #include <sstream>
 #include <stdexcept>
 
 // FFMPEG 4.0
 #define HAS_FFMPEG_4_API (LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(58, 18, 100))
+// FFMPEG 4.4
+#define HAS_INDEX_ENTRY_API \
+    (LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(58, 65, 100))
 
 extern "C"
 {
@@ -59,13 +62,26 @@ FFMPEGVideoStream::FFMPEGVideoStream(AVFormatContext& avFormatContext)
     : _avFormatContext{avFormatContext}
 {
     _findVideoStream();
-    _openVideoStreamDecoder();
-    _generateSeekingParameters();
+    const auto& codecpar = *_videoStream->codecpar;
+    _budgetId = FFMPEGThreadBudget::instance().add(codecpar.width,
+                                                   codecpar.height);
+    try
+    {
+        _openVideoStreamDecoder();
+        _generateSeekingParameters();
+    }
+    catch (...)
+    {
+        avcodec_free_context(&_videoCodecContext);
+        FFMPEGThreadBudget::instance().remove(_budgetId);
+        throw;
+    }
 }
 
 FFMPEGVideoStream::~FFMPEGVideoStream()
 {
     avcodec_free_context(&_videoCodecContext);
+    FFMPEGThreadBudget::instance().remove(_budgetId);
 }
 
 bool FFMPEGVideoStream::decode(AVPacket& packet, FFMPEGFrame& frame)
@@ -101,6 +117,41 @@ bool FFMPEGVideoStream::_decodeToAvFrame(AVPacket& packet, FFMPEGFrame& frame)
     }
 
     errCode = avcodec_receive_frame(_videoCodecContext, &frame.getAVFrame());
+    // Frame threading delays the output by one frame per thread
+    if (errCode == AVERROR(EAGAIN))
+        return false;
+    if (errCode < 0)
+    {
+        print_log(LOG_ERROR, LOG_AV,
+                  "avcodec_receive_frame returned error code '%i' : "
+                  "'%s' in '%s'",
+                  errCode, _getAvError(errCode).c_str(), _getFilename());
+        return false;
+    }
+    return true;
+}
+
+bool FFMPEGVideoStream::drain(FFMPEGFrame& frame)
+{
+    if (!_draining)
+    {
+        // An empty packet puts the decoder in draining mode
+        const int errCode = avcodec_send_packet(_videoCodecContext, nullptr);
+        if (errCode < 0 && errCode != AVERROR_EOF)
+        {
+            print_log(LOG_ERROR, LOG_AV,
+                      "avcodec_send_packet returned error code '%i' : "
+                      "'%s' in '%s'",
+                      errCode, _getAvError(errCode).c_str(), _getFilename());
+            return false;
+        }
+        _draining = true;
+    }
+
+    const int errCode =
+        avcodec_receive_frame(_videoCodecContext, &frame.getAVFrame());
+    if (errCode == AVERROR_EOF)
+        return false;
     if (errCode < 0)
     {
         print_log(LOG_ERROR, LOG_AV,
@@ -208,10 +259,72 @@ bool FFMPEGVideoStream::seekToNearestFullframe(const int64_t frameIndex)
         return false;
     }
 
+    if (_isThreadCountOutdated())
+    {
+        // The thread count is fixed once the codec is open; reopen it to
+        // rebalance, which is equivalent to a flush after a seek.
+        const auto previousThreadCount = _threadCount;
+        avcodec_free_context(&_videoCodecContext);
+        try
+        {
+            _openVideoStreamDecoder();
+        }
+        catch (const std::runtime_error& e)
+        {
+            print_log(LOG_ERROR, LOG_AV, "could not reopen codec: %s in: '%s'",
+                      e.what(), _getFilename());
+            return false;
+        }
+        print_log(LOG_VERBOSE, LOG_AV, "decoding threads: %u -> %u in: '%s'",
+                  previousThreadCount, _threadCount, _getFilename());
+        _draining = false;
+        return true;
+    }
+
     avcodec_flush_buffers(_videoCodecContext);
+    _draining = false;
     return true;
 }
 
+std::shared_ptr<const FFMPEGKeyframeIndex> FFMPEGVideoStream::getKeyframeIndex()
+{
+#if HAS_INDEX_ENTRY_API
+    const auto count = avformat_index_get_entries_count(_videoStream);
+#else
+    const auto count = _videoStream->nb_index_entries;
+#endif
+    // Demuxers keep the entries sorted, rebuild when some were inserted
+    if (_keyframeIndex && count == _indexedEntriesCount)
+        return _keyframeIndex;
+
+    std::vector<int64_t> keyframes;
+    for (int i = 0; i < count; ++i)
+    {
+#if HAS_INDEX_ENTRY_API
+        const auto& entry = *avformat_index_get_entry(_videoStream, i);
+#else
+        const auto& entry = _videoStream->index_entries[i];
+#endif
+        if (entry.flags & AVINDEX_KEYFRAME)
+            keyframes.push_back(getFrameIndex(entry.timestamp));
+    }
+    _keyframeIndex =
+        std::make_shared<const FFMPEGKeyframeIndex>(std::move(keyframes));
+    _indexedEntriesCount = count;
+    return _keyframeIndex;
+}
+
+void FFMPEGVideoStream::setActive(const bool active)
+{
+    FFMPEGThreadBudget::instance().setActive(_budgetId, active);
+}
+
+bool FFMPEGVideoStream::_isThreadCountOutdated() const
+{
+    return FFMPEGThreadBudget::instance().getThreadCount(_budgetId) !=
+           _threadCount;
+}
+
 void FFMPEGVideoStream::_findVideoStream()
 {
     for (unsigned int i = 0; i < _avFormatContext.nb_streams; ++i)
@@ -243,30 +356,11 @@ void FFMPEGVideoStream::_openVideoStreamDecoder()
     if (error < 0)
         throw std::runtime_error("Could not init context from parameters");
 
-    { // Set threading from environment variable
-        const auto envStr = getenv("TIDE_FFMPEG_THREADS");
-        const std::string threadsStr = envStr != nullptr ? envStr : "";
-        size_t threadCount = 0;
-
-        if (!threadsStr.empty())
-        {
-            try
-            {
-                threadCount = std::stoi(threadsStr);
-            }
-            catch (...)
-            {
-                print_log(LOG_WARN, LOG_AV,
-                          "Could not parse TIDE_FFMPEG_THREADS: %s",
-                          threadsStr.c_str());
-            }
-        }
-
-        if (threadCount > 0)
-        {
-            _videoCodecContext->thread_count = threadCount;
-            _videoCodecContext->thread_type = FF_THREAD_FRAME;
-        }
+    _threadCount = FFMPEGThreadBudget::instance().getThreadCount(_budgetId);
+    if (_threadCount > 1)
+    {
+        _videoCodecContext->thread_count = _threadCount;
+        _videoCodecContext->thread_type = FF_THREAD_FRAME;
     }
 
     const int ret = avcodec_open2(_videoCodecContext, codec, NULL);
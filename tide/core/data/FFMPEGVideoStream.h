@@ -41,6 +41,7 @@
 #define FFMPEGVIDEOSTREAM_H
 
 #include "FFMPEGDefines.h"
+#include "FFMPEGKeyframeIndex.h"
 
 extern "C"
 {
@@ -52,6 +53,8 @@ extern "C"
 
 #include "types.h"
 
+#include <memory>
+
 /** A video stream from an FFMPEG file. */
 class FFMPEGVideoStream
 {
@@ -75,6 +78,15 @@ public:
      */
     bool decode(AVPacket& packet, FFMPEGFrame& frame);
 
+    /**
+     * Get the next frame still held by the decoder at the end of the stream.
+     *
+     * Draining ends at the next seek.
+     * @param frame The frame to store the decoded frame
+     * @return True on success, false if no frames are left
+     */
+    bool drain(FFMPEGFrame& frame);
+
     /** Get the width of the video stream. */
     unsigned int getWidth() const;
 
@@ -108,9 +120,29 @@ public:
     /** Convert a timestamp to a time in seconds */
     double getPositionInSec(int64_t timestamp) const;
 
-    /** Seek to the nearest full frame in the video. */
+    /**
+     * Seek to the nearest full frame in the video.
+     *
+     * The decoder is also reopened if its thread count is outdated.
+     */
     bool seekToNearestFullframe(int64_t frameIndex);
 
+    /**
+     * Get the index of the keyframes of the stream.
+     *
+     * The index is read from the container when it provides one, otherwise it
+     * grows as keyframes are discovered while demuxing. A new index is
+     * created whenever it grows, previous ones remain valid. Keyframes are
+     * indexed by decoding timestamp, see FFMPEGKeyframeIndex.
+     */
+    std::shared_ptr<const FFMPEGKeyframeIndex> getKeyframeIndex();
+
+    /**
+     * Set if the stream is visible and playing, which gives it a share of the
+     * decoding threads at its next seek; see FFMPEGThreadBudget.
+     */
+    void setActive(bool active);
+
 private:
     AVFormatContext& _avFormatContext;
 
@@ -118,6 +150,14 @@ private:
     // ptr to _avFormatContext->streams[i]; don't free
     AVStream* _videoStream = nullptr;
 
+    std::shared_ptr<const FFMPEGKeyframeIndex> _keyframeIndex;
+    int _indexedEntriesCount = 0;
+
+    uint _budgetId = 0;
+    uint _threadCount = 0;
+
+    bool _draining = false;
+
     // used for seeking
     int64_t _numFrames = 0;
     double _frameDuration = 0.0;
@@ -130,6 +170,8 @@ private:
     bool _isVideoPacket(const AVPacket& packet) const;
     bool _decodeToAvFrame(AVPacket& packet, FFMPEGFrame& frame);
 
+    bool _isThreadCountOutdated() const;
+
     const char* _getFilename() const;
 };
 
@@ -49,6 +49,8 @@
  * Valid image formats are:
  * - RGBA: 1 texture plane, 32 bits per pixel (in any GL-compatible arrangement)
  * - YUV: 3 texture planes, 8 bits per pixel
+ * - Compressed RGBA: 1 texture plane per mipmap level, in the block format
+ *   given by getGLCompressedFormat()
  *
  * Derived classes must comply with this requirement.
  */
@@ -100,6 +102,15 @@ public:
     /** @return the OpenGL pixel format of the image data. */
     virtual uint getGLPixelFormat() const = 0;
 
+    /**
+     * @return the OpenGL internal format of block-compressed image data, or 0
+     *         if the data is not compressed.
+     */
+    virtual uint getGLCompressedFormat() const { return 0; }
+
+    /** @return the number of mipmap levels of compressed image data. */
+    virtual uint getMipmapLevels() const { return 1; }
+
     /** @return true if generateGpuImage must be called from render thread. */
     virtual bool isGpuImage() const { return false; }
     /**
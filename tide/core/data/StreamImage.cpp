@@ -44,20 +44,30 @@
 
 #include <cassert>
 
-StreamImage::StreamImage(deflect::server::FramePtr frame, const uint tileIndex)
+namespace
+{
+int _scaled(const int size, const uint divider)
+{
+    return (size + int(divider) - 1) / int(divider);
+}
+}
+
+StreamImage::StreamImage(deflect::server::FramePtr frame, const uint tileIndex,
+                         const uint scaleDivider)
     : _frame{frame}
     , _tileIndex{tileIndex}
+    , _scaleDivider{scaleDivider}
 {
 }
 
 int StreamImage::getWidth() const
 {
-    return _frame->tiles.at(_tileIndex).width;
+    return _scaled(_frame->tiles.at(_tileIndex).width, _scaleDivider);
 }
 
 int StreamImage::getHeight() const
 {
-    return _frame->tiles.at(_tileIndex).height;
+    return _scaled(_frame->tiles.at(_tileIndex).height, _scaleDivider);
 }
 
 deflect::RowOrder StreamImage::getRowOrder() const
@@ -121,8 +131,8 @@ ColorSpace StreamImage::getColorSpace() const
 
 QPoint StreamImage::getPosition() const
 {
-    return QPoint(_frame->tiles.at(_tileIndex).x,
-                  _frame->tiles.at(_tileIndex).y);
+    return QPoint(_frame->tiles.at(_tileIndex).x / _scaleDivider,
+                  _frame->tiles.at(_tileIndex).y / _scaleDivider);
 }
 
 void StreamImage::copy(const StreamImage& image, const QPoint& position)
@@ -45,12 +45,16 @@
 
 /**
  * Image wrapper for a pixel stream image.
+ *
+ * The image of a tile decoded at a reduced resolution is smaller than the tile
+ * by a factor of scaleDivider (rounded up), see ScaledTileDecoder.
  */
 class StreamImage : public YUVImage
 {
 public:
     /** Constructor, stores the given deflect frame. */
-    StreamImage(deflect::server::FramePtr frame, uint tileIndex);
+    StreamImage(deflect::server::FramePtr frame, uint tileIndex,
+                uint scaleDivider = 1);
 
     /** @copydoc Image::getWidth */
     int getWidth() const final;
@@ -70,7 +74,7 @@ public:
     /** @copydoc Image::getColorSpace */
     ColorSpace getColorSpace() const final;
 
-    /** @return the position of the image in the stream. */
+    /** @return the position of the image in the (scaled) stream. */
     QPoint getPosition() const;
 
     /** Copy another image of the same format at the given position. */
@@ -79,6 +83,7 @@ public:
 private:
     const deflect::server::FramePtr _frame;
     const uint _tileIndex;
+    const uint _scaleDivider;
 
     void _copy(const StreamImage& image, uint texture, const QPoint& position);
     uint8_t* _getData(const uint texture);
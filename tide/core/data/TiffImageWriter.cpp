@@ -0,0 +1,113 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "TiffImageWriter.h"
+
+#include <QImage>
+
+#include <tiffio.h>
+
+#include <stdexcept>
+
+namespace
+{
+const qint64 bigTiffThreshold = qint64(4) * 1024 * 1024 * 1024;
+const uint32 rowsPerStrip = 64;
+}
+
+struct TiffImageWriter::Impl
+{
+    TIFF* tif = nullptr;
+    QSize size;
+    int row = 0;
+};
+
+TiffImageWriter::TiffImageWriter(const QString& filename, const QSize& size)
+    : _impl{new Impl}
+{
+    if (size.isEmpty())
+        throw std::runtime_error("invalid image size");
+
+    const auto bytes = qint64(size.width()) * size.height() * 3;
+    const auto mode = bytes > bigTiffThreshold ? "w8" : "w";
+    _impl->tif = TIFFOpen(filename.toLocal8Bit().constData(), mode);
+    if (!_impl->tif)
+        throw std::runtime_error("could not open " + filename.toStdString());
+    _impl->size = size;
+
+    auto tif = _impl->tif;
+    TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, uint32(size.width()));
+    TIFFSetField(tif, TIFFTAG_IMAGELENGTH, uint32(size.height()));
+    TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, 8);
+    TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, 3);
+    TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+    TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_RGB);
+    TIFFSetField(tif, TIFFTAG_COMPRESSION, COMPRESSION_ADOBE_DEFLATE);
+    TIFFSetField(tif, TIFFTAG_PREDICTOR, PREDICTOR_HORIZONTAL);
+    TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, rowsPerStrip);
+    TIFFSetField(tif, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
+}
+
+TiffImageWriter::~TiffImageWriter()
+{
+    TIFFClose(_impl->tif);
+}
+
+void TiffImageWriter::write(const QImage& band)
+{
+    if (band.width() != _impl->size.width() ||
+        _impl->row + band.height() > _impl->size.height())
+    {
+        throw std::runtime_error("image band does not fit in the image");
+    }
+
+    const auto rgb = band.convertToFormat(QImage::Format_RGB888);
+    for (auto y = 0; y < rgb.height(); ++y, ++_impl->row)
+    {
+        // libtiff does not modify the buffer, the cast avoids a deep copy
+        auto data = const_cast<uchar*>(rgb.constScanLine(y));
+        if (TIFFWriteScanline(_impl->tif, data, uint32(_impl->row), 0) < 0)
+            throw std::runtime_error("error writing TIFF image row");
+    }
+}
+
+int TiffImageWriter::getRowsWritten() const
+{
+    return _impl->row;
+}
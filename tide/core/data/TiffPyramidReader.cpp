@@ -160,9 +160,25 @@ struct TiffPyramidReader::Impl
     void readTileData(const QPoint& tileCoord, void* buffer)
     {
         validate(tileCoord);
+        setJpegColorMode();
         TIFFReadTile(tif.get(), buffer, tileCoord.x(), tileCoord.y(), 0, 0);
     }
 
+    // JPEG-compressed YCbCr tiles are stored subsampled; let libjpeg convert
+    // them to RGB. This pseudo-tag is reset when changing directory.
+    void setJpegColorMode()
+    {
+        uint16_t compression = COMPRESSION_NONE;
+        uint16_t photometric = PHOTOMETRIC_RGB;
+        TIFFGetFieldDefaulted(tif.get(), TIFFTAG_COMPRESSION, &compression);
+        TIFFGetField(tif.get(), TIFFTAG_PHOTOMETRIC, &photometric);
+        if (compression == COMPRESSION_JPEG &&
+            photometric == PHOTOMETRIC_YCBCR)
+        {
+            TIFFSetField(tif.get(), TIFFTAG_JPEGCOLORMODE, JPEGCOLORMODE_RGB);
+        }
+    }
+
     void validate(const QPoint& tileCoord)
     {
         if (!TIFFCheckTile(tif.get(), tileCoord.x(), tileCoord.y(), 0, 0))
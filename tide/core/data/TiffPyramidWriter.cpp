@@ -0,0 +1,565 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "TiffPyramidWriter.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageReader>
+
+#include <tiffio.h>
+
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// Number of blocks of rows buffered between two levels of the pyramid
+const size_t maxQueuedBlocks = 2;
+
+// The size of the compressed file is not known in advance, use BigTIFF as soon
+// as the uncompressed data could exceed the 4 GB limit of classic TIFF files.
+const qint64 bigTiffThreshold = qint64(4) * 1024 * 1024 * 1024;
+
+struct TIFFDeleter
+{
+    void operator()(TIFF* file) { TIFFClose(file); }
+};
+using TIFFPtr = std::unique_ptr<TIFF, TIFFDeleter>;
+
+TIFFPtr _open(const QString& filename, const char* mode)
+{
+    TIFFPtr tif{TIFFOpen(filename.toLocal8Bit().constData(), mode)};
+    if (!tif)
+        throw std::runtime_error("could not open " + filename.toStdString());
+    return tif;
+}
+
+uint _computeLevelsCount(const QSize& imageSize, const uint tileSize)
+{
+    // Same as LodTools: the top level fits in a single tile
+    uint count = 1;
+    auto maxDim = uint(std::max(imageSize.width(), imageSize.height()));
+    while (maxDim > tileSize)
+    {
+        maxDim = maxDim >> 1;
+        ++count;
+    }
+    return count;
+}
+
+QSize _getLevelSize(const QSize& imageSize, const uint lod)
+{
+    return QSize(std::max(imageSize.width() >> lod, 1),
+                 std::max(imageSize.height() >> lod, 1));
+}
+
+bool _isTiff(const QString& filename)
+{
+    const auto suffix = QFileInfo{filename}.suffix().toLower();
+    return suffix == "tif" || suffix == "tiff";
+}
+
+/** Read blocks of rows of the source image in RGB32 format. */
+class SourceReader
+{
+public:
+    virtual ~SourceReader() = default;
+    virtual QSize getSize() const = 0;
+    virtual QImage read(int y, int rows) = 0;
+};
+
+/** Stream any TIFF image supported by the RGBA interface of libtiff. */
+class TiffSourceReader : public SourceReader
+{
+public:
+    explicit TiffSourceReader(const QString& filename)
+        : _tif{_open(filename, "r")}
+    {
+        char message[1024] = {0};
+        if (!TIFFRGBAImageOK(_tif.get(), message) ||
+            !TIFFRGBAImageBegin(&_image, _tif.get(), 0, message))
+        {
+            throw std::runtime_error("unsupported TIFF image: " +
+                                     std::string(message));
+        }
+        _image.req_orientation = ORIENTATION_TOPLEFT;
+    }
+
+    ~TiffSourceReader() { TIFFRGBAImageEnd(&_image); }
+
+    QSize getSize() const final
+    {
+        return QSize(int(_image.width), int(_image.height));
+    }
+
+    QImage read(const int y, const int rows) final
+    {
+        const auto width = int(_image.width);
+        _raster.resize(size_t(width) * rows);
+
+        _image.row_offset = y;
+        _image.col_offset = 0;
+        if (!TIFFRGBAImageGet(&_image, _raster.data(), width, rows))
+            throw std::runtime_error("could not read source image");
+
+        QImage block{width, rows, QImage::Format_RGB32};
+        for (int row = 0; row < rows; ++row)
+        {
+            const auto src = _raster.data() + size_t(row) * width;
+            auto dst = reinterpret_cast<QRgb*>(block.scanLine(row));
+            for (int x = 0; x < width; ++x)
+                dst[x] = qRgb(TIFFGetR(src[x]), TIFFGetG(src[x]),
+                              TIFFGetB(src[x]));
+        }
+        return block;
+    }
+
+private:
+    TIFFPtr _tif;
+    TIFFRGBAImage _image;
+    std::vector<uint32> _raster;
+};
+
+/** Fallback for the other formats, which Qt can only decode in full. */
+class QtSourceReader : public SourceReader
+{
+public:
+    explicit QtSourceReader(const QString& filename)
+    {
+        QImageReader reader{filename};
+        _image = reader.read();
+        if (_image.isNull())
+            throw std::runtime_error("could not read source image: " +
+                                     reader.errorString().toStdString());
+    }
+
+    QSize getSize() const final { return _image.size(); }
+
+    QImage read(const int y, const int rows) final
+    {
+        const auto rect = QRect(0, y, _image.width(), rows);
+        return _image.copy(rect).convertToFormat(QImage::Format_RGB32);
+    }
+
+private:
+    QImage _image;
+};
+
+std::unique_ptr<SourceReader> _createReader(const QString& filename)
+{
+    if (_isTiff(filename))
+        return std::make_unique<TiffSourceReader>(filename);
+    return std::make_unique<QtSourceReader>(filename);
+}
+
+/** Blocking queue of blocks of rows, a null image marks the end. */
+class BlockQueue
+{
+public:
+    void push(QImage block)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notFull.wait(lock,
+                      [this] { return _blocks.size() < maxQueuedBlocks; });
+        _blocks.push_back(std::move(block));
+        _notEmpty.notify_one();
+    }
+
+    QImage pop()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notEmpty.wait(lock, [this] { return !_blocks.empty(); });
+        auto block = std::move(_blocks.front());
+        _blocks.pop_front();
+        _notFull.notify_one();
+        return block;
+    }
+
+private:
+    std::mutex _mutex;
+    std::condition_variable _notFull;
+    std::condition_variable _notEmpty;
+    std::deque<QImage> _blocks;
+};
+
+/**
+ * Write one level of the pyramid to a temporary TIFF file.
+ *
+ * The level receives blocks of rows from the level beneath it (or the source)
+ * and forwards each completed row of tiles, downsampled by two, to the next
+ * level.
+ */
+class LevelWriter
+{
+public:
+    LevelWriter(const QString& filename, const QSize& size, const uint tileSize,
+                const int quality, const char* mode)
+        : _filename{filename}
+        , _size{size}
+        , _tileSize{int(tileSize)}
+        , _tif{_open(filename, mode)}
+        , _rows{size.width(), int(tileSize), QImage::Format_RGB32}
+        , _tile(size_t(tileSize) * tileSize * 3)
+    {
+        auto tif = _tif.get();
+        TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, uint32(size.width()));
+        TIFFSetField(tif, TIFFTAG_IMAGELENGTH, uint32(size.height()));
+        TIFFSetField(tif, TIFFTAG_TILEWIDTH, uint32(tileSize));
+        TIFFSetField(tif, TIFFTAG_TILELENGTH, uint32(tileSize));
+        TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, 8);
+        TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, 3);
+        TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+        TIFFSetField(tif, TIFFTAG_COMPRESSION, COMPRESSION_JPEG);
+        TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_YCBCR);
+        // Pseudo-tags of the JPEG codec, must be set after the compression
+        TIFFSetField(tif, TIFFTAG_JPEGCOLORMODE, JPEGCOLORMODE_RGB);
+        TIFFSetField(tif, TIFFTAG_JPEGQUALITY, quality);
+
+        _rows.fill(Qt::black);
+    }
+
+    void setNext(LevelWriter* next) { _next = next; }
+    BlockQueue& getInput() { return _input; }
+    const QString& getFilename() const { return _filename; }
+    const std::string& getError() const { return _error; }
+
+    /** Process the input until the end marker, always forwarding it. */
+    void run()
+    {
+        for (auto block = _input.pop(); !block.isNull(); block = _input.pop())
+        {
+            if (_error.empty())
+                _tryOrSetError([this, &block] { _append(block); });
+        }
+        if (_error.empty())
+            _tryOrSetError([this] { _finish(); });
+
+        if (_next)
+            _next->getInput().push(QImage());
+    }
+
+private:
+    const QString _filename;
+    const QSize _size;
+    const int _tileSize;
+    TIFFPtr _tif;
+
+    QImage _rows;
+    int _rowCount = 0;
+    int _tileRow = 0;
+    std::vector<uchar> _tile;
+
+    LevelWriter* _next = nullptr;
+    int _forwardedRows = 0;
+    BlockQueue _input;
+    std::string _error;
+
+    template <typename F>
+    void _tryOrSetError(F&& func)
+    {
+        try
+        {
+            func();
+        }
+        catch (const std::runtime_error& e)
+        {
+            _error = e.what();
+        }
+    }
+
+    void _append(const QImage& block)
+    {
+        if (block.width() != _size.width())
+            throw std::runtime_error("unexpected block width");
+
+        int line = 0;
+        while (line < block.height())
+        {
+            const auto count =
+                std::min(block.height() - line, _tileSize - _rowCount);
+            for (int i = 0; i < count; ++i)
+                std::memcpy(_rows.scanLine(_rowCount + i),
+                            block.constScanLine(line + i),
+                            size_t(_rows.bytesPerLine()));
+            line += count;
+            _rowCount += count;
+
+            if (_rowCount == _tileSize)
+                _writeTileRow();
+        }
+    }
+
+    void _finish()
+    {
+        if (_rowCount > 0)
+            _writeTileRow();
+
+        if (_tileRow * _tileSize < _size.height())
+            throw std::runtime_error("missing image rows");
+
+        if (!TIFFWriteDirectory(_tif.get()))
+            throw std::runtime_error("could not write TIFF directory");
+        _tif.reset();
+    }
+
+    void _writeTileRow()
+    {
+        const auto y = _tileRow * _tileSize;
+        for (int x = 0; x < _size.width(); x += _tileSize)
+        {
+            _copyTile(x);
+            const auto index = TIFFComputeTile(_tif.get(), x, y, 0, 0);
+            if (TIFFWriteEncodedTile(_tif.get(), index, _tile.data(),
+                                     tmsize_t(_tile.size())) < 0)
+            {
+                throw std::runtime_error("could not write tile");
+            }
+        }
+        _forward();
+
+        ++_tileRow;
+        _rowCount = 0;
+        _rows.fill(Qt::black);
+    }
+
+    void _copyTile(const int x)
+    {
+        // Tiles at the borders are padded with black pixels
+        const auto width = std::min(_tileSize, _size.width() - x);
+        std::fill(_tile.begin(), _tile.end(), 0);
+        for (int row = 0; row < _rowCount; ++row)
+        {
+            const auto src =
+                reinterpret_cast<const QRgb*>(_rows.constScanLine(row)) + x;
+            auto dst = _tile.data() + size_t(row) * _tileSize * 3;
+            for (int i = 0; i < width; ++i)
+            {
+                *dst++ = uchar(qRed(src[i]));
+                *dst++ = uchar(qGreen(src[i]));
+                *dst++ = uchar(qBlue(src[i]));
+            }
+        }
+    }
+
+    void _forward()
+    {
+        if (!_next)
+            return;
+
+        // The last levels of very elongated images still need one row
+        const auto nextSize = _next->_size;
+        const auto rows = std::min(std::max(_rowCount / 2, 1),
+                                   nextSize.height() - _forwardedRows);
+        if (rows <= 0)
+            return;
+
+        const auto block = _rows.copy(0, 0, _size.width(), _rowCount);
+        _next->getInput().push(
+            block
+                .scaled(QSize(nextSize.width(), rows), Qt::IgnoreAspectRatio,
+                        Qt::SmoothTransformation)
+                .convertToFormat(QImage::Format_RGB32));
+        _forwardedRows += rows;
+    }
+};
+
+using LevelWriters = std::vector<std::unique_ptr<LevelWriter>>;
+
+void _copyDirectory(TIFF* in, TIFF* out)
+{
+    uint32 width = 0, height = 0, tileWidth = 0, tileHeight = 0;
+    TIFFGetField(in, TIFFTAG_IMAGEWIDTH, &width);
+    TIFFGetField(in, TIFFTAG_IMAGELENGTH, &height);
+    TIFFGetField(in, TIFFTAG_TILEWIDTH, &tileWidth);
+    TIFFGetField(in, TIFFTAG_TILELENGTH, &tileHeight);
+
+    TIFFSetField(out, TIFFTAG_IMAGEWIDTH, width);
+    TIFFSetField(out, TIFFTAG_IMAGELENGTH, height);
+    TIFFSetField(out, TIFFTAG_TILEWIDTH, tileWidth);
+    TIFFSetField(out, TIFFTAG_TILELENGTH, tileHeight);
+    TIFFSetField(out, TIFFTAG_BITSPERSAMPLE, 8);
+    TIFFSetField(out, TIFFTAG_SAMPLESPERPIXEL, 3);
+    TIFFSetField(out, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+    TIFFSetField(out, TIFFTAG_COMPRESSION, COMPRESSION_JPEG);
+    TIFFSetField(out, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_YCBCR);
+
+    uint16 subsamplingX = 0, subsamplingY = 0;
+    TIFFGetFieldDefaulted(in, TIFFTAG_YCBCRSUBSAMPLING, &subsamplingX,
+                          &subsamplingY);
+    TIFFSetField(out, TIFFTAG_YCBCRSUBSAMPLING, subsamplingX, subsamplingY);
+
+    uint32 tablesSize = 0;
+    void* tables = nullptr;
+    if (TIFFGetField(in, TIFFTAG_JPEGTABLES, &tablesSize, &tables))
+        TIFFSetField(out, TIFFTAG_JPEGTABLES, tablesSize, tables);
+
+    // The tiles are already compressed, copy them as-is
+    uint64* byteCounts = nullptr;
+    TIFFGetField(in, TIFFTAG_TILEBYTECOUNTS, &byteCounts);
+
+    std::vector<uchar> buffer;
+    for (ttile_t tile = 0; tile < TIFFNumberOfTiles(in); ++tile)
+    {
+        const auto size = tmsize_t(byteCounts[tile]);
+        buffer.resize(size_t(size));
+        if (TIFFReadRawTile(in, tile, buffer.data(), size) != size ||
+            TIFFWriteRawTile(out, tile, buffer.data(), size) != size)
+        {
+            throw std::runtime_error("could not copy tile");
+        }
+    }
+    if (!TIFFWriteDirectory(out))
+        throw std::runtime_error("could not write TIFF directory");
+}
+
+void _merge(const LevelWriters& levels, const QString& target,
+            const char* mode)
+{
+    auto out = _open(target, mode);
+    for (const auto& level : levels)
+        _copyDirectory(_open(level->getFilename(), "r").get(), out.get());
+}
+}
+
+TiffPyramidWriter::TiffPyramidWriter(const uint tileSize, const int quality)
+    : _tileSize{tileSize}
+    , _quality{quality}
+{
+    if (tileSize == 0 || tileSize % 16 != 0)
+        throw std::invalid_argument("tile size must be a multiple of 16");
+}
+
+void TiffPyramidWriter::setProgressCallback(
+    std::function<void(double)> callback)
+{
+    _progressCallback = std::move(callback);
+}
+
+void TiffPyramidWriter::write(const QString& source,
+                              const QString& target) const
+{
+    auto reader = _createReader(source);
+    const auto size = reader->getSize();
+    if (size.isEmpty())
+        throw std::runtime_error("source image is empty");
+
+    const auto rawSize = qint64(size.width()) * size.height() * 3;
+    const auto mode = rawSize > bigTiffThreshold ? "w8" : "w";
+
+    LevelWriters levels;
+    const auto removeTemporaryFiles = [&levels] {
+        for (const auto& level : levels)
+            QFile::remove(level->getFilename());
+    };
+
+    try
+    {
+        const auto levelsCount = _computeLevelsCount(size, _tileSize);
+        for (uint lod = 0; lod < levelsCount; ++lod)
+        {
+            const auto filename = QString("%1.%2.tmp").arg(target).arg(lod);
+            const auto levelSize = _getLevelSize(size, lod);
+            levels.emplace_back(std::make_unique<LevelWriter>(
+                filename, levelSize, _tileSize, _quality, mode));
+            if (lod > 0)
+                levels[lod - 1]->setNext(levels[lod].get());
+        }
+    }
+    catch (const std::runtime_error&)
+    {
+        removeTemporaryFiles();
+        throw;
+    }
+
+    std::vector<std::thread> threads;
+    for (auto& level : levels)
+        threads.emplace_back([&level] { level->run(); });
+
+    std::string error;
+    try
+    {
+        const auto blockHeight = int(_tileSize);
+        for (int y = 0; y < size.height(); y += blockHeight)
+        {
+            const auto rows = std::min(blockHeight, size.height() - y);
+            levels.front()->getInput().push(reader->read(y, rows));
+            if (_progressCallback)
+                _progressCallback(double(y + rows) / size.height());
+        }
+    }
+    catch (const std::runtime_error& e)
+    {
+        error = e.what();
+    }
+    levels.front()->getInput().push(QImage());
+
+    for (auto& thread : threads)
+        thread.join();
+    reader.reset();
+
+    for (const auto& level : levels)
+    {
+        if (error.empty())
+            error = level->getError();
+    }
+
+    if (error.empty())
+    {
+        try
+        {
+            _merge(levels, target, mode);
+        }
+        catch (const std::runtime_error& e)
+        {
+            error = e.what();
+            QFile::remove(target);
+        }
+    }
+    removeTemporaryFiles();
+
+    if (!error.empty())
+        throw std::runtime_error("pyramid creation failed: " + error);
+}
@@ -0,0 +1,89 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef TIFFPYRAMIDWRITER_H
+#define TIFFPYRAMIDWRITER_H
+
+#include <QString>
+
+#include <functional>
+
+/**
+ * Writer for TIFF image pyramid files, as read by TiffPyramidReader.
+ *
+ * The source image is read in strips of tile rows and each level of the
+ * pyramid is downsampled from the one beneath it and compressed in its own
+ * thread, so that the memory usage does not depend on the height of the
+ * image. Each level is a directory of JPEG-compressed RGB tiles.
+ *
+ * TIFF sources are streamed with libtiff, other formats are decoded once with
+ * Qt's image readers which do not support reading strips of an image.
+ */
+class TiffPyramidWriter
+{
+public:
+    /**
+     * Create a writer.
+     * @param tileSize of the pyramid, must be a multiple of 16
+     * @param quality of the JPEG compression [1-100]
+     * @throw std::invalid_argument if the tile size is invalid
+     */
+    TiffPyramidWriter(uint tileSize = 512, int quality = 90);
+
+    /**
+     * Set a callback to monitor the progress of write().
+     * @param callback called with the fraction [0-1] of the source image read
+     */
+    void setProgressCallback(std::function<void(double)> callback);
+
+    /**
+     * Convert an image to a TIFF image pyramid.
+     * @param source the image file to convert
+     * @param target the TIFF pyramid file to create, overwritten if it exists
+     * @throw std::runtime_error if the conversion failed
+     */
+    void write(const QString& source, const QString& target) const;
+
+private:
+    const uint _tileSize;
+    const int _quality;
+    std::function<void(double)> _progressCallback;
+};
+
+#endif
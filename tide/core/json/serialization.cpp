@@ -200,7 +200,8 @@ QJsonObject serialize(const Configuration& config)
         {"folders", QJsonObject{{"contents", config.folders.contents},
                                 {"sessions", config.folders.sessions},
                                 {"tmp", config.folders.tmp},
-                                {"upload", config.folders.upload}}},
+                                {"upload", config.folders.upload},
+                                {"tileCache", config.folders.tileCache}}},
         {"global",
          QJsonObject{{"swapsync", serialize(config.global.swapsync)}}},
         {"launcher",
@@ -220,7 +221,16 @@ QJsonObject serialize(const Configuration& config)
                       static_cast<int>(config.settings.inactivityTimeout)},
                      {"contentMaxScale", config.settings.contentMaxScale},
                      {"contentMaxScaleVectorial",
-                      config.settings.contentMaxScaleVectorial}}},
+                      config.settings.contentMaxScaleVectorial},
+                     {"imageTilingThreshold",
+                      static_cast<int>(config.settings.imageTilingThreshold)},
+                     {"pixelStreamPipelineDepth",
+                      static_cast<int>(
+                          config.settings.pixelStreamPipelineDepth)},
+                     {"textureUploadBudget",
+                      static_cast<int>(config.settings.textureUploadBudget)},
+                     {"tileCacheMaxSize",
+                      static_cast<int>(config.settings.tileCacheMaxSize)}}},
         {"webbrowser", QJsonObject{{"defaultUrl", config.webbrowser.defaultUrl},
                                    {"defaultSize",
                                     serialize(config.webbrowser.defaultSize)}}},
@@ -423,6 +433,7 @@ bool deserialize(const QJsonObject& object, Configuration& config)
     deserialize(foldersObj["sessions"], config.folders.sessions);
     deserialize(foldersObj["tmp"], config.folders.tmp);
     deserialize(foldersObj["upload"], config.folders.upload);
+    deserialize(foldersObj["tileCache"], config.folders.tileCache);
 
     const auto globalObj = object["global"].toObject();
     deserialize(globalObj["swapsync"], config.global.swapsync);
@@ -448,6 +459,14 @@ bool deserialize(const QJsonObject& object, Configuration& config)
                 config.settings.contentMaxScale);
     deserialize(settingsObj["contentMaxScaleVectorial"],
                 config.settings.contentMaxScaleVectorial);
+    deserialize(settingsObj["imageTilingThreshold"],
+                config.settings.imageTilingThreshold);
+    deserialize(settingsObj["pixelStreamPipelineDepth"],
+                config.settings.pixelStreamPipelineDepth);
+    deserialize(settingsObj["textureUploadBudget"],
+                config.settings.textureUploadBudget);
+    deserialize(settingsObj["tileCacheMaxSize"],
+                config.settings.tileCacheMaxSize);
 
     const auto webbrowserObj = object["webbrowser"].toObject();
     deserialize(webbrowserObj["defaultUrl"], config.webbrowser.defaultUrl);
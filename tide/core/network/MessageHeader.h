@@ -57,9 +57,11 @@ enum class MessageType
     START_PROCESS,
     IMAGE,
     COUNTDOWN_STATUS,
+    PIXELSTREAM_OPEN,
     PIXELSTREAM_CLOSE,
     LOCK,
-    CONFIG
+    CONFIG,
+    TILE_CACHE_STATISTICS
 };
 
 /** Fixed-size message header. */
@@ -0,0 +1,127 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "PixelStreamTileCache.h"
+
+#include <deflect/server/Frame.h>
+
+namespace
+{
+auto _makeKey(const deflect::server::Tile& tile)
+{
+    return std::make_tuple(uint(tile.channel), tile.view, int(tile.x),
+                           int(tile.y));
+}
+
+bool _hasSameLayout(const deflect::server::Tile& a,
+                    const deflect::server::Tile& b)
+{
+    return a.width == b.width && a.height == b.height &&
+           a.format == b.format && a.rowOrder == b.rowOrder;
+}
+}
+
+size_t PixelStreamTileCache::stripUnchangedTiles(
+    deflect::server::Frame& frame)
+{
+    ++_frameIndex;
+
+    size_t count = 0;
+    for (auto& tile : frame.tiles)
+    {
+        auto& entry = _tiles[_makeKey(tile)];
+        entry.frameIndex = _frameIndex;
+
+        if (_hasSameLayout(entry.tile, tile) &&
+            entry.tile.imageData == tile.imageData)
+        {
+            tile.imageData = QByteArray();
+            ++count;
+        }
+        else
+            entry.tile = tile;
+    }
+    _removeMissingTiles(frame.tiles.size());
+    return count;
+}
+
+bool PixelStreamTileCache::restoreUnchangedTiles(
+    deflect::server::Frame& frame)
+{
+    ++_frameIndex;
+
+    bool complete = true;
+    for (auto& tile : frame.tiles)
+    {
+        auto& entry = _tiles[_makeKey(tile)];
+        entry.frameIndex = _frameIndex;
+
+        if (!tile.imageData.isEmpty())
+            entry.tile = tile;
+        else if (_hasSameLayout(entry.tile, tile))
+            tile.imageData = entry.tile.imageData;
+        else
+            complete = false;
+    }
+    _removeMissingTiles(frame.tiles.size());
+    return complete;
+}
+
+void PixelStreamTileCache::clear()
+{
+    _tiles.clear();
+}
+
+void PixelStreamTileCache::_removeMissingTiles(const size_t frameTilesCount)
+{
+    // Forget the tiles which are no longer part of the stream's layout. This
+    // must be deterministic for the cache on the master and on the walls to
+    // remain identical.
+    if (_tiles.size() == frameTilesCount)
+        return;
+
+    auto it = _tiles.begin();
+    while (it != _tiles.end())
+    {
+        if (it->second.frameIndex == _frameIndex)
+            ++it;
+        else
+            it = _tiles.erase(it);
+    }
+}
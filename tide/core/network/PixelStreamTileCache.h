@@ -0,0 +1,95 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef PIXELSTREAMTILECACHE_H
+#define PIXELSTREAMTILECACHE_H
+
+#include "types.h"
+
+#include <deflect/server/Tile.h>
+
+#include <map>
+#include <tuple>
+
+/**
+ * Keep the last tiles of a pixel stream to transmit only those that changed.
+ *
+ * The master strips the payload of the tiles which are identical to the ones
+ * of the previous frame at the same (channel, view, position). The walls then
+ * restore the payload from the previous frame that they received, sharing the
+ * same buffer which allows them to detect unchanged tiles cheaply.
+ *
+ * Both sides must observe the same sequence of frames, clear() must be called
+ * to start a new sequence.
+ */
+class PixelStreamTileCache
+{
+public:
+    /**
+     * Remove the payload of the tiles that have not changed since the previous
+     * frame passed to this function.
+     * @param frame to process
+     * @return the number of tiles which were stripped.
+     */
+    size_t stripUnchangedTiles(deflect::server::Frame& frame);
+
+    /**
+     * Restore the payload of the tiles stripped by stripUnchangedTiles().
+     * @param frame to process
+     * @return false if some tiles could not be restored.
+     */
+    bool restoreUnchangedTiles(deflect::server::Frame& frame);
+
+    /** Clear the cache, the next frame will be transmitted in full. */
+    void clear();
+
+private:
+    using Key = std::tuple<uint, deflect::View, int, int>;
+    struct Entry
+    {
+        deflect::server::Tile tile;
+        uint64_t frameIndex = 0;
+    };
+    std::map<Key, Entry> _tiles;
+    uint64_t _frameIndex = 0;
+
+    void _removeMissingTiles(size_t frameTilesCount);
+};
+
+#endif
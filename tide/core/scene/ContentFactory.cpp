@@ -67,8 +67,19 @@
 
 namespace
 {
+// Larger images are tiled by the walls, except for stereo images
 const QSize maxTextureSize(16384, 16384);
 
+bool _isOpenable(const ImageReader& imageReader)
+{
+    if (!imageReader.isStereo())
+        return true;
+
+    const auto size = imageReader.getSize();
+    return size.width() <= maxTextureSize.width() &&
+           size.height() <= maxTextureSize.height();
+}
+
 ContentType _getContentTypeForFile(const QString& uri)
 {
     const auto extension = QFileInfo(uri).suffix().toLower();
@@ -104,15 +115,12 @@ ContentType _getContentTypeForFile(const QString& uri)
     const auto imageReader = ImageReader(uri);
     if (imageReader.isValid())
     {
-        const auto size = imageReader.getSize();
-
-        if (size.width() <= maxTextureSize.width() &&
-            size.height() <= maxTextureSize.height())
+        if (_isOpenable(imageReader))
             return ContentType::image;
 
         throw load_error(
-            "Image is too big to open. Try converting it to a TIFF image "
-            "pyramid using Tide's 'pyramidify' tool.");
+            "Stereo image is too big to open. Try converting it to a TIFF "
+            "image pyramid using Tide's 'pyramidify' tool.");
     }
 
     throw load_error("Unsupported content type.");
@@ -175,12 +183,7 @@ ContentPtr ContentFactory::createErrorContent(const Content& content)
 bool ContentFactory::isValidImageFile(const QString& uri)
 {
     const auto imageReader = ImageReader{uri};
-    if (!imageReader.isValid())
-        return false;
-
-    const auto size = imageReader.getSize();
-    return size.width() <= maxTextureSize.width() &&
-           size.height() <= maxTextureSize.height();
+    return imageReader.isValid() && _isOpenable(imageReader);
 }
 
 ContentPtr ContentFactory::createErrorContent(const QString& uri)
@@ -45,8 +45,22 @@
 #include "utils/compilerMacros.h"
 #include "utils/log.h"
 
+#include <algorithm>
+#include <cmath>
+
 IMPLEMENT_SERIALIZE_FOR_XML(DisplayGroup)
 
+namespace
+{
+// Size of the cells of the hit testing grid, a fraction of a typical window
+const qreal cellSize = 512.0;
+
+int _toCell(const qreal pos, const int cellsCount)
+{
+    return qBound(0, int(std::floor(pos / cellSize)), cellsCount - 1);
+}
+}
+
 DisplayGroupPtr DisplayGroup::create(const QSizeF& size)
 {
     return DisplayGroupPtr{new DisplayGroup{size}};
@@ -55,6 +69,12 @@ DisplayGroupPtr DisplayGroup::create(const QSizeF& size)
 DisplayGroup::DisplayGroup(const QSizeF& size_)
 {
     _coordinates.setSize(size_);
+    _rebuildCells();
+
+    connect(this, &DisplayGroup::widthChanged, this,
+            &DisplayGroup::_rebuildCells);
+    connect(this, &DisplayGroup::heightChanged, this,
+            &DisplayGroup::_rebuildCells);
 }
 
 DisplayGroup::~DisplayGroup()
@@ -73,6 +93,9 @@ void DisplayGroup::add(WindowPtr window)
     const auto empty = isEmpty();
 
     _windows.push_back(window);
+    _windowsById[window->getID()] = window;
+    _zIndicesDirty = true;
+    _addToCells(window);
     _watchChanges(*window);
 
     if (window->isPanel())
@@ -111,6 +134,9 @@ void DisplayGroup::remove(WindowPtr window)
 
     removeFocusedWindow(*it);
     _windows.erase(it);
+    _windowsById.erase(window->getID());
+    _zIndicesDirty = true;
+    _removeFromCells(*window);
 
     // disconnect any existing connections with the window
     disconnect(window.get(), 0, this, 0);
@@ -138,6 +164,7 @@ void DisplayGroup::moveToFront(WindowPtr window)
     // move it to end of the list (last item rendered is on top)
     _windows.erase(it);
     _windows.push_back(window);
+    _zIndicesDirty = true;
 
     emit(windowMovedToFront(window));
     _sendDisplayGroup();
@@ -155,12 +182,8 @@ const WindowPtrs& DisplayGroup::getWindows() const
 
 WindowPtr DisplayGroup::getWindow(const QUuid& id) const
 {
-    for (const auto& window : _windows)
-    {
-        if (window->getID() == id)
-            return window;
-    }
-    return WindowPtr();
+    const auto it = _windowsById.find(id);
+    return it != _windowsById.end() ? it->second : WindowPtr();
 }
 
 WindowPtr DisplayGroup::findWindow(const QString& filename) const
@@ -173,6 +196,34 @@ WindowPtr DisplayGroup::findWindow(const QString& filename) const
     return WindowPtr();
 }
 
+WindowPtr DisplayGroup::getWindowAt(const QPointF& position) const
+{
+    if (_cells.empty())
+        return WindowPtr();
+
+    const auto x = _toCell(position.x(), _cellsCount.width());
+    const auto y = _toCell(position.y(), _cellsCount.height());
+    const auto& cell = _cells[size_t(y * _cellsCount.width() + x)];
+
+    WindowPtr topmostWindow;
+    int topmostZindex = -1;
+    for (const auto& window : cell)
+    {
+        if (window->isHidden() ||
+            !window->getDisplayCoordinates().contains(position))
+        {
+            continue;
+        }
+        const auto zIndex = getZindex(window->getID());
+        if (zIndex > topmostZindex)
+        {
+            topmostWindow = window;
+            topmostZindex = zIndex;
+        }
+    }
+    return topmostWindow;
+}
+
 void DisplayGroup::replaceWindows(WindowPtrs windows)
 {
     clear();
@@ -212,11 +263,9 @@ void DisplayGroup::clear()
 
 int DisplayGroup::getZindex(const QUuid& id) const
 {
-    const auto it = std::find_if(_windows.begin(), _windows.end(),
-                                 [&id](const auto& window) {
-                                     return window->getID() == id;
-                                 });
-    return it == _windows.end() ? -1 : it - _windows.begin();
+    _updateZindices();
+    const auto it = _zIndices.find(id);
+    return it == _zIndices.end() ? -1 : it->second;
 }
 
 bool DisplayGroup::hasFocusedWindows() const
@@ -340,6 +389,14 @@ void DisplayGroup::_watchChanges(Window& window)
     connect(&window, &Window::contentModified, this,
             &DisplayGroup::_sendDisplayGroup);
 
+    // The display coordinates also change with the mode, see modified()
+    const auto updateCells = [this, &window] { _updateCells(window); };
+    connect(&window, &Window::modified, this, updateCells);
+    connect(&window, &Window::xChanged, this, updateCells);
+    connect(&window, &Window::yChanged, this, updateCells);
+    connect(&window, &Window::widthChanged, this, updateCells);
+    connect(&window, &Window::heightChanged, this, updateCells);
+
     if (window.isPanel())
         connect(&window, &Window::hiddenChanged, this,
                 &DisplayGroup::hasVisiblePanelsChanged);
@@ -347,3 +404,96 @@ void DisplayGroup::_watchChanges(Window& window)
         connect(&window, &Window::selectedChanged, this,
                 &DisplayGroup::selectedUrisChanged);
 }
+
+void DisplayGroup::_rebuildIndex()
+{
+    _windowsById.clear();
+    for (const auto& window : _windows)
+        _windowsById[window->getID()] = window;
+    _zIndicesDirty = true;
+    _rebuildCells();
+}
+
+void DisplayGroup::_rebuildCells()
+{
+    const auto size = _coordinates.size();
+    _cellsCount = QSize{std::max(1, int(std::ceil(size.width() / cellSize))),
+                        std::max(1, int(std::ceil(size.height() / cellSize)))};
+    _cells.assign(size_t(_cellsCount.width() * _cellsCount.height()), {});
+    _windowCells.clear();
+    for (const auto& window : _windows)
+        _addToCells(window);
+}
+
+void DisplayGroup::_updateZindices() const
+{
+    if (!_zIndicesDirty)
+        return;
+
+    _zIndices.clear();
+    for (size_t i = 0; i < _windows.size(); ++i)
+        _zIndices[_windows[i]->getID()] = int(i);
+    _zIndicesDirty = false;
+}
+
+QRect DisplayGroup::_getCellsRange(const QRectF& rect) const
+{
+    const auto left = _toCell(rect.left(), _cellsCount.width());
+    const auto top = _toCell(rect.top(), _cellsCount.height());
+    const auto right = _toCell(rect.right(), _cellsCount.width());
+    const auto bottom = _toCell(rect.bottom(), _cellsCount.height());
+    return QRect{QPoint{left, top}, QPoint{right, bottom}};
+}
+
+std::vector<WindowPtr>& DisplayGroup::_getCell(const int x, const int y)
+{
+    return _cells[size_t(y * _cellsCount.width() + x)];
+}
+
+void DisplayGroup::_addToCells(const WindowPtr& window)
+{
+    const auto range = _getCellsRange(window->getDisplayCoordinates());
+    for (int y = range.top(); y <= range.bottom(); ++y)
+        for (int x = range.left(); x <= range.right(); ++x)
+            _getCell(x, y).push_back(window);
+    _windowCells[window->getID()] = range;
+}
+
+void DisplayGroup::_removeFromCells(const Window& window)
+{
+    const auto it = _windowCells.find(window.getID());
+    if (it == _windowCells.end())
+        return;
+
+    const auto& range = it->second;
+    for (int y = range.top(); y <= range.bottom(); ++y)
+    {
+        for (int x = range.left(); x <= range.right(); ++x)
+        {
+            auto& cell = _getCell(x, y);
+            cell.erase(std::remove_if(cell.begin(), cell.end(),
+                                      [&window](const WindowPtr& w) {
+                                          return w.get() == &window;
+                                      }),
+                       cell.end());
+        }
+    }
+    _windowCells.erase(it);
+}
+
+void DisplayGroup::_updateCells(const Window& window)
+{
+    const auto it = _windowCells.find(window.getID());
+    if (it != _windowCells.end() &&
+        it->second == _getCellsRange(window.getDisplayCoordinates()))
+    {
+        return;
+    }
+
+    const auto windowPtr = getWindow(window.getID());
+    if (!windowPtr)
+        return;
+
+    _removeFromCells(window);
+    _addToCells(windowPtr);
+}
@@ -49,6 +49,8 @@
 
 #include <QUuid>
 
+#include <map>
+
 /**
  * The different versions of the xml serialized display group.
  */
@@ -108,6 +110,14 @@ public:
     /** Find a single window based on its filename. */
     WindowPtr findWindow(const QString& filename) const;
 
+    /**
+     * Get the window displayed at a given position.
+     * @param position in pixel units.
+     * @return the window with the highest z index whose display coordinates
+     *         contain the position, excluding hidden windows; or nullptr.
+     */
+    WindowPtr getWindowAt(const QPointF& position) const;
+
     /**
      * Replace the windows by a new list.
      * @param windows the list of windows to set.
@@ -214,6 +224,8 @@ private:
         ar & _fullscreenWindow;
         ar & _panels;
         // clang-format on
+        if (Archive::is_loading::value)
+            _rebuildIndex();
     }
 
     /** Serialize for saving to an xml file */
@@ -247,6 +259,7 @@ private:
             // Make sure windows are not in an undefined state
             window->setState(Window::NONE);
         }
+        _rebuildIndex();
     }
 
     /** Saving to xml. */
@@ -259,10 +272,39 @@ private:
     void _sendDisplayGroup();
     void _watchChanges(Window& window);
 
+    void _rebuildIndex();
+    void _rebuildCells();
+
+    void _updateZindices() const;
+
+    QRect _getCellsRange(const QRectF& rect) const;
+    std::vector<WindowPtr>& _getCell(int x, int y);
+    void _addToCells(const WindowPtr& window);
+    void _removeFromCells(const Window& window);
+    void _updateCells(const Window& window);
+
     WindowPtrs _windows;
     WindowSet _focusedWindows;
     WindowPtr _fullscreenWindow;
     WindowSet _panels;
+
+    /** Lookup table for the windows, kept in sync with _windows. */
+    std::map<QUuid, WindowPtr> _windowsById;
+
+    /** Z indices of the windows, rebuilt lazily when the order changes. */
+    mutable std::map<QUuid, int> _zIndices;
+    mutable bool _zIndicesDirty = true;
+
+    /**
+     * Uniform grid over the group for hit testing. Each cell lists the windows
+     * whose display coordinates overlap it; windows beyond the edges of the
+     * group are listed in the border cells.
+     */
+    std::vector<std::vector<WindowPtr>> _cells;
+    QSize _cellsCount;
+
+    /** Range of cells covered by each window, kept in sync with _cells. */
+    std::map<QUuid, QRect> _windowCells;
 };
 
 BOOST_CLASS_VERSION(DisplayGroup, FIRST_DISPLAYGROUP_VERSION)
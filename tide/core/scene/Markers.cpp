@@ -39,6 +39,34 @@
 
 #include "Markers.h"
 
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+struct EncodedMarker
+{
+    int32_t id;
+    float x;
+    float y;
+};
+
+template <typename T>
+void _append(std::string& data, const T& value)
+{
+    data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T _read(const std::string& data, const size_t offset)
+{
+    T value;
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    return value;
+}
+}
+
 MarkersPtr Markers::create(const size_t surfaceIndex)
 {
     return MarkersPtr{new Markers{surfaceIndex}};
@@ -92,6 +120,7 @@ void Markers::addMarker(const int id, const QPointF& position)
     beginInsertRows(QModelIndex(), markerIndex, markerIndex);
     _markers.push_back(Marker(id, position));
     endInsertRows();
+    _changedIds.insert(id);
     emit(updated(shared_from_this()));
 }
 
@@ -103,6 +132,7 @@ void Markers::updateMarker(const int id, const QPointF& position)
         return;
 
     it->second = position;
+    _changedIds.insert(id);
     emit(updated(shared_from_this()));
 
     const int markerIndex = it - _markers.begin();
@@ -120,9 +150,69 @@ void Markers::removeMarker(const int id)
     beginRemoveRows(QModelIndex(), markerIndex, markerIndex);
     _markers.erase(it);
     endRemoveRows();
+    _changedIds.insert(id);
     emit(updated(shared_from_this()));
 }
 
+std::string Markers::takeChanges()
+{
+    std::string changes;
+    if (_changedIds.empty())
+        return changes;
+
+    changes.reserve(sizeof(uint32_t) +
+                    _changedIds.size() * sizeof(EncodedMarker));
+    _append(changes, uint32_t(_surfaceIndex));
+
+    const auto removed = std::numeric_limits<float>::quiet_NaN();
+    for (const auto id : _changedIds)
+    {
+        const auto it = _findMarker(id);
+        if (it == _markers.end())
+            _append(changes, EncodedMarker{id, removed, removed});
+        else
+            _append(changes, EncodedMarker{id, float(it->second.x()),
+                                           float(it->second.y())});
+    }
+    _changedIds.clear();
+    return changes;
+}
+
+MarkersPtr Markers::copyWithChanges(const std::string& changes) const
+{
+    auto markers = Markers::create(_surfaceIndex);
+    markers->_markers = _markers;
+    if (changes.size() < sizeof(uint32_t))
+        return markers;
+
+    const auto count =
+        (changes.size() - sizeof(uint32_t)) / sizeof(EncodedMarker);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto offset = sizeof(uint32_t) + i * sizeof(EncodedMarker);
+        const auto marker = _read<EncodedMarker>(changes, offset);
+        auto it = markers->_findMarker(marker.id);
+        if (std::isnan(marker.x))
+        {
+            if (it != markers->_markers.end())
+                markers->_markers.erase(it);
+        }
+        else if (it == markers->_markers.end())
+            markers->_markers.emplace_back(marker.id,
+                                           QPointF{marker.x, marker.y});
+        else
+            it->second = QPointF{marker.x, marker.y};
+    }
+    return markers;
+}
+
+size_t Markers::decodeSurfaceIndex(const std::string& changes)
+{
+    if (changes.size() < sizeof(uint32_t))
+        return 0;
+    return _read<uint32_t>(changes, 0);
+}
+
 Markers::MarkersVector::iterator Markers::_findMarker(const int id)
 {
     auto it = std::find_if(_markers.begin(), _markers.end(),
@@ -47,6 +47,8 @@
 #include <QAbstractListModel>
 #include <QPointF>
 
+#include <set>
+
 /**
  * Store Markers to display user interaction.
  */
@@ -77,6 +79,26 @@ public:
     void updateMarker(int id, const QPointF& position);
     void removeMarker(int id);
 
+    /**
+     * Get a compact encoding of the markers changed since the last call.
+     *
+     * The changes are encoded as raw (id, x, y) records, removed markers having
+     * a NaN position. They are used to broadcast incremental updates to the
+     * wall processes without the overhead of a full serialization.
+     * @return the encoded changes, or an empty string if nothing changed.
+     */
+    std::string takeChanges();
+
+    /**
+     * Create a copy of these markers with the given changes applied.
+     * @param changes encoded by takeChanges() for the same surface.
+     * @return the updated markers.
+     */
+    MarkersPtr copyWithChanges(const std::string& changes) const;
+
+    /** @return the surface index of changes encoded by takeChanges(). */
+    static size_t decodeSurfaceIndex(const std::string& changes);
+
 signals:
     void updated(MarkersPtr markers);
 
@@ -102,6 +124,7 @@ private:
 
     size_t _surfaceIndex = 0;
     MarkersVector _markers;
+    std::set<int> _changedIds;
 };
 
 #endif
@@ -41,6 +41,7 @@
 #ifndef SERIALIZATION_QTTYPES_H
 #define SERIALIZATION_QTTYPES_H
 
+#include <QByteArray>
 #include <QColor>
 #include <QImage>
 #include <QRectF>
@@ -88,6 +89,29 @@ void serialize(Archive& ar, QString& s, const unsigned int version)
     split_free(ar, s, version);
 }
 
+template <class Archive>
+void save(Archive& ar, const QByteArray& data, const unsigned int)
+{
+    const int size = data.size();
+    ar << make_nvp("size", size);
+    ar << make_nvp("data", make_array(data.constData(), size));
+}
+
+template <class Archive>
+void load(Archive& ar, QByteArray& data, const unsigned int)
+{
+    int size = 0;
+    ar >> make_nvp("size", size);
+    data.resize(size);
+    ar >> make_nvp("data", make_array(data.data(), size));
+}
+
+template <class Archive>
+void serialize(Archive& ar, QByteArray& data, const unsigned int version)
+{
+    split_free(ar, data, version);
+}
+
 template <class Archive>
 void serialize(Archive& ar, QUuid& uuid, const unsigned int /*version*/)
 {
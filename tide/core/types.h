@@ -117,6 +117,7 @@ class DisplayGroup;
 class DisplayGroupController;
 class DisplayGroupRenderer;
 class FFMPEGFrame;
+class FFMPEGKeyframeIndex;
 class FFMPEGMovie;
 class FFMPEGPicture;
 class FFMPEGVideoStream;
@@ -149,6 +150,7 @@ struct SurfaceConfig;
 class SwapSynchronizer;
 class TestPattern;
 class Tile;
+class TileCacheMonitor;
 struct WallConfiguration;
 class WallSurfaceRenderer;
 class WallToWallChannel;
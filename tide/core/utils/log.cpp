@@ -47,9 +47,20 @@
 #include <QDateTime>
 #include <QString>
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <stdarg.h>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 
 #if TIDE_ENABLE_MOVIE_SUPPORT
@@ -67,13 +78,486 @@ extern "C" {
 namespace
 {
 const size_t MAX_LOG_LENGTH = 1024;
+const size_t MAX_ID_LENGTH = 32;
+const size_t QUEUE_SIZE = 2048; // must be a power of two
 
-std::string getTimestamp()
+// Rate limiting of repetitive messages (identical except for numbers)
+const size_t MAX_REPEATS_PER_PERIOD = 10;
+const qint64 REPEAT_PERIOD_MS = 1000;
+
+const char* const FACILITIES[] = {LOG_AV,    LOG_CONTENT, LOG_GENERAL, LOG_JS,
+                                  LOG_MPI,   LOG_PDF,     LOG_POWER,   LOG_QT,
+                                  LOG_REST,  LOG_STREAM,  LOG_TIFF};
+const size_t FACILITIES_COUNT = sizeof(FACILITIES) / sizeof(FACILITIES[0]);
+
+std::atomic<int> globalLevel{LOG_THRESHOLD};
+// Stored as level + 1 so that the (zero) default means "use global level"
+std::array<std::atomic<int>, FACILITIES_COUNT> facilityLevels;
+
+int _findFacility(const std::string& facility)
+{
+    for (size_t i = 0; i < FACILITIES_COUNT; ++i)
+    {
+        if (facility == FACILITIES[i])
+            return i;
+    }
+    return -1;
+}
+
+bool _isEnabled(const int level, const std::string& facility)
+{
+    const auto index = _findFacility(facility);
+    const auto facilityLevel = index >= 0 ? facilityLevels[index].load() : 0;
+    if (facilityLevel > 0)
+        return level >= facilityLevel - 1;
+    return level >= globalLevel.load();
+}
+
+bool _setFacilityLevel(const std::string& facility, const int level)
+{
+    const auto index = _findFacility(facility);
+    if (index < 0)
+        return false;
+    facilityLevels[index] = level + 1;
+    return true;
+}
+
+int _parseLevel(const std::string& level)
+{
+    const char* const names[] = {"verbose", "debug", "info",
+                                 "warn",    "error", "fatal"};
+    for (int i = LOG_VERBOSE; i <= LOG_FATAL; ++i)
+    {
+        if (level == names[i])
+            return i;
+    }
+    return std::stoi(level);
+}
+
+/**
+ * Parse the TIDE_LOG_LEVEL environment variable.
+ *
+ * Format: "[level][,FACILITY=level]...", where level is either a number or
+ * one of verbose, debug, info, warn, error, fatal. Example: "warn,MPI=debug".
+ */
+void _parseEnvironment()
+{
+    const auto envStr = getenv("TIDE_LOG_LEVEL");
+    if (!envStr)
+        return;
+
+    std::stringstream stream{envStr};
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        try
+        {
+            const auto pos = item.find('=');
+            if (pos == std::string::npos)
+                globalLevel = _parseLevel(item);
+            else if (!_setFacilityLevel(item.substr(0, pos),
+                                        _parseLevel(item.substr(pos + 1))))
+                throw std::invalid_argument("unknown facility");
+        }
+        catch (...)
+        {
+            std::cerr << "Could not parse TIDE_LOG_LEVEL: " << item
+                      << std::endl;
+        }
+    }
+}
+
+qint64 _now()
+{
+    return QDateTime::currentMSecsSinceEpoch();
+}
+
+struct Record
+{
+    int level = LOG_INFO;
+    qint64 timestamp = 0;
+    char id[MAX_ID_LENGTH];
+    char facility[MAX_ID_LENGTH];
+    char message[MAX_LOG_LENGTH];
+
+    void set(const int level_, const std::string& facility_,
+             const char* format, va_list ap)
+    {
+        level = level_;
+        timestamp = _now();
+        strncpy(id, logger_id.c_str(), MAX_ID_LENGTH - 1);
+        id[MAX_ID_LENGTH - 1] = '\0';
+        strncpy(facility, facility_.c_str(), MAX_ID_LENGTH - 1);
+        facility[MAX_ID_LENGTH - 1] = '\0';
+        vsnprintf(message, MAX_LOG_LENGTH, format, ap);
+    }
+
+    void set(const int level_, const std::string& facility_,
+             const char* format, ...)
+    {
+        va_list ap;
+        va_start(ap, format);
+        set(level_, facility_, format, ap);
+        va_end(ap);
+    }
+};
+
+void _write(const Record& record, std::ostream& out)
 {
-    return QDateTime::currentDateTime()
-        .toString("hh:mm:ss dd/MM/yy")
-        .toStdString();
+    const auto time = QDateTime::fromMSecsSinceEpoch(record.timestamp)
+                          .toString("hh:mm:ss dd/MM/yy")
+                          .toStdString();
+    if (record.id[0] == '\0')
+        out << "{" << time << "}";
+    else
+        out << "{" << record.id << ": " << time << "}";
+
+    out << "{" << record.level << "}"
+        << "{" << record.facility << "} " << record.message << '\n';
 }
+
+void _write(const Record& record)
+{
+    _write(record, record.level < LOG_ERROR ? std::cout : std::cerr);
+}
+
+/**
+ * Bounded lock-free multi-producer / single-consumer queue of log records.
+ *
+ * Based on Dmitry Vyukov's bounded MPMC queue: each slot has a sequence
+ * number which tells producers and the consumer whether it is free or ready.
+ */
+class RecordQueue
+{
+public:
+    RecordQueue()
+        : _slots(QUEUE_SIZE)
+    {
+        for (size_t i = 0; i < QUEUE_SIZE; ++i)
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    /** @return false if the queue is full; never blocks. */
+    template <typename Fill>
+    bool tryPush(Fill&& fill)
+    {
+        auto pos = _enqueuePos.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        for (;;)
+        {
+            slot = &_slots[pos & (QUEUE_SIZE - 1)];
+            const auto seq = slot->sequence.load(std::memory_order_acquire);
+            const auto diff = intptr_t(seq) - intptr_t(pos);
+            if (diff == 0)
+            {
+                if (_enqueuePos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+                return false;
+            else
+                pos = _enqueuePos.load(std::memory_order_relaxed);
+        }
+        fill(slot->record);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Consume the next record, only from the draining thread. */
+    template <typename Consume>
+    bool tryPop(Consume&& consume)
+    {
+        auto& slot = _slots[_dequeuePos & (QUEUE_SIZE - 1)];
+        const auto seq = slot.sequence.load(std::memory_order_acquire);
+        if (seq != _dequeuePos + 1)
+            return false;
+
+        consume(slot.record);
+        slot.sequence.store(_dequeuePos + QUEUE_SIZE,
+                            std::memory_order_release);
+        ++_dequeuePos;
+        _consumed.store(_dequeuePos, std::memory_order_release);
+        return true;
+    }
+
+    size_t getEnqueuedCount() const { return _enqueuePos.load(); }
+    size_t getConsumedCount() const { return _consumed.load(); }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        Record record;
+    };
+    std::vector<Slot> _slots;
+    std::atomic<size_t> _enqueuePos{0};
+    std::atomic<size_t> _consumed{0};
+    size_t _dequeuePos = 0;
+};
+
+/** Suppress repetitive messages in the draining thread. */
+class RateLimiter
+{
+public:
+    /** @return true if the record should be written. */
+    bool accept(const Record& record)
+    {
+        auto& entry = _entries[_getKey(record)];
+        if (record.timestamp - entry.periodStart >= REPEAT_PERIOD_MS)
+        {
+            _writeSummary(entry);
+            entry.periodStart = record.timestamp;
+            entry.count = 0;
+        }
+        if (++entry.count <= MAX_REPEATS_PER_PERIOD)
+        {
+            entry.last = record;
+            return true;
+        }
+        ++entry.suppressed;
+        return false;
+    }
+
+    /** @return true if some messages are tracked for a period. */
+    bool hasEntries() const { return !_entries.empty(); }
+
+    /** Write the summaries of suppressed messages and forget old ones. */
+    void flush(const bool all)
+    {
+        const auto now = _now();
+        for (auto it = _entries.begin(); it != _entries.end();)
+        {
+            auto& entry = it->second;
+            if (all || now - entry.periodStart >= REPEAT_PERIOD_MS)
+            {
+                _writeSummary(entry);
+                it = _entries.erase(it);
+            }
+            else
+                ++it;
+        }
+    }
+
+private:
+    struct Entry
+    {
+        qint64 periodStart = 0;
+        size_t count = 0;
+        size_t suppressed = 0;
+        Record last;
+    };
+    std::map<std::string, Entry> _entries;
+
+    static std::string _getKey(const Record& record)
+    {
+        std::string key = record.facility;
+        key.reserve(key.size() + strlen(record.message));
+        for (const char* c = record.message; *c; ++c)
+        {
+            if (*c < '0' || *c > '9')
+                key.push_back(*c);
+        }
+        return key;
+    }
+
+    static void _writeSummary(Entry& entry)
+    {
+        if (entry.suppressed == 0)
+            return;
+
+        auto summary = entry.last;
+        snprintf(summary.message, MAX_LOG_LENGTH,
+                 "suppressed %zu message(s) similar to: %.900s",
+                 entry.suppressed, entry.last.message);
+        summary.timestamp = _now();
+        _write(summary);
+        entry.suppressed = 0;
+    }
+};
+
+/**
+ * Write the log records asynchronously from a background thread.
+ *
+ * Logging threads only format the message into a free slot of a lock-free
+ * queue. If the queue is full the message is dropped and counted instead of
+ * waiting for the background thread.
+ */
+class AsyncLogger
+{
+public:
+    static AsyncLogger& instance()
+    {
+        // Intentionally leaked to remain usable during static destruction
+        static auto logger = new AsyncLogger;
+        return *logger;
+    }
+
+    void log(const int level, const std::string& facility, const char* format,
+             va_list ap)
+    {
+        if (!_running.load(std::memory_order_acquire) || level >= LOG_FATAL)
+        {
+            // Fatal messages are written synchronously before aborting
+            flush();
+            Record record;
+            record.set(level, facility, format, ap);
+            _write(record);
+            std::cout.flush();
+            return;
+        }
+
+        if (!_queue.tryPush([&](Record& record) {
+                record.set(level, facility, format, ap);
+            }))
+        {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        _wakeUp();
+    }
+
+    void flush()
+    {
+        if (!_running.load(std::memory_order_acquire))
+            return;
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        const auto request = ++_flushRequested;
+        _wakeCondition.notify_one();
+        _flushedCondition.wait(lock,
+                               [&] { return _flushCompleted >= request; });
+    }
+
+private:
+    RecordQueue _queue;
+    RateLimiter _rateLimiter;
+    std::atomic<bool> _running{false};
+    std::atomic<bool> _stop{false};
+    std::atomic<size_t> _dropped{0};
+    std::thread _thread;
+
+    // The draining thread sleeps until messages are pushed or flushed
+    std::mutex _mutex;
+    std::condition_variable _wakeCondition;
+    std::condition_variable _flushedCondition;
+    std::atomic<bool> _waiting{false};
+    size_t _flushRequested = 0;
+    size_t _flushCompleted = 0;
+
+    AsyncLogger()
+    {
+        _parseEnvironment();
+
+        _thread = std::thread([this] { _run(); });
+        _running = true;
+        std::atexit([] { instance()._shutdown(); });
+    }
+
+    void _shutdown()
+    {
+        if (!_running.exchange(false))
+            return;
+        {
+            const std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wakeCondition.notify_one();
+        _thread.join();
+    }
+
+    void _wakeUp()
+    {
+        // Only lock when the draining thread sleeps, which it does after
+        // setting _waiting and checking the queue again under the mutex
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!_waiting.load())
+            return;
+        const std::lock_guard<std::mutex> lock(_mutex);
+        _wakeCondition.notify_one();
+    }
+
+    bool _hasWork() const
+    {
+        return _stop.load() || _flushRequested > _flushCompleted ||
+               _queue.getConsumedCount() < _queue.getEnqueuedCount() ||
+               _dropped.load() > 0;
+    }
+
+    void _wait()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _waiting = true;
+        const auto hasWork = [this] { return _hasWork(); };
+        // Wake up periodically only to write the summaries of suppressed
+        // messages when their period ends
+        if (_rateLimiter.hasEntries())
+        {
+            const auto period = std::chrono::milliseconds{REPEAT_PERIOD_MS};
+            _wakeCondition.wait_for(lock, period, hasWork);
+        }
+        else
+            _wakeCondition.wait(lock, hasWork);
+        _waiting = false;
+    }
+
+    void _run()
+    {
+        auto lastRateLimiterFlush = _now();
+        for (;;)
+        {
+            const auto stopping = _stop.load();
+            size_t flushRequested = 0;
+            {
+                const std::lock_guard<std::mutex> lock(_mutex);
+                flushRequested = _flushRequested;
+            }
+
+            _drain();
+
+            const auto now = _now();
+            const auto flushAll = stopping || flushRequested > _flushCompleted;
+            if (flushAll || now - lastRateLimiterFlush >= REPEAT_PERIOD_MS)
+            {
+                _rateLimiter.flush(flushAll);
+                lastRateLimiterFlush = now;
+            }
+            std::cout.flush();
+            std::cerr.flush();
+
+            if (flushRequested > _flushCompleted)
+            {
+                const std::lock_guard<std::mutex> lock(_mutex);
+                _flushCompleted = flushRequested;
+                _flushedCondition.notify_all();
+            }
+            if (stopping)
+                return;
+
+            _wait();
+        }
+    }
+
+    void _drain()
+    {
+        while (_queue.tryPop([this](const Record& record) {
+            if (_rateLimiter.accept(record))
+                _write(record);
+        }))
+        {
+        }
+
+        if (const auto dropped = _dropped.exchange(0))
+        {
+            Record record;
+            record.set(LOG_WARN, LOG_GENERAL,
+                       "dropped %zu log message(s), the log queue was full",
+                       dropped);
+            _write(record);
+        }
+    }
+};
 }
 
 std::string logger_id = "";
@@ -81,28 +565,31 @@ std::string logger_id = "";
 void put_log(const int level, const std::string& facility, const char* format,
              ...)
 {
-    if (level < LOG_THRESHOLD)
+    auto& logger = AsyncLogger::instance();
+    if (!_isEnabled(level, facility))
         return;
 
-    char log_string[MAX_LOG_LENGTH];
     va_list ap;
     va_start(ap, format);
-    vsnprintf(log_string, MAX_LOG_LENGTH, format, ap);
+    logger.log(level, facility, format, ap);
     va_end(ap);
+}
 
-    std::stringstream message;
-    if (logger_id.empty())
-        message << "{" << getTimestamp() << "}";
-    else
-        message << "{" << logger_id << ": " << getTimestamp() << "}";
+void set_log_level(const int level)
+{
+    AsyncLogger::instance(); // apply the environment settings first
+    globalLevel = level;
+}
 
-    message << "{" << level << "}"
-            << "{" << facility << "} " << log_string;
+bool set_log_level(const std::string& facility, const int level)
+{
+    AsyncLogger::instance(); // apply the environment settings first
+    return _setFacilityLevel(facility, level);
+}
 
-    if (level < LOG_ERROR)
-        std::cout << message.str() << std::endl;
-    else
-        std::cerr << message.str() << std::endl;
+void flush_log()
+{
+    AsyncLogger::instance().flush();
 }
 
 #if TIDE_ENABLE_MOVIE_SUPPORT
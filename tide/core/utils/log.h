@@ -65,9 +65,34 @@
 #define LOG_TIFF "TIFF"
 
 extern std::string logger_id;
+
+/**
+ * Log a message.
+ *
+ * The message is formatted in the calling thread and written asynchronously
+ * by a background thread; this call never blocks (except for LOG_FATAL).
+ * Repetitive messages are rate-limited and summarized with a suppressed count.
+ */
 extern void put_log(const int level, const std::string& facility,
                     const char* format, ...);
 
+/**
+ * Set the minimum level of the messages to log for all facilities.
+ *
+ * The initial levels can also be set with the TIDE_LOG_LEVEL environment
+ * variable, for instance TIDE_LOG_LEVEL="warn,MPI=debug".
+ */
+extern void set_log_level(int level);
+
+/**
+ * Set the minimum level of the messages to log for a single facility.
+ * @return false if the facility is unknown.
+ */
+extern bool set_log_level(const std::string& facility, int level);
+
+/** Wait until all pending log messages have been written. */
+extern void flush_log();
+
 extern void avMessageLoger(void*, int level, const char* format, va_list varg);
 extern void qtMessageLogger(QtMsgType type, const QMessageLogContext& context,
                             const QString& msg);
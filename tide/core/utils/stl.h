@@ -59,6 +59,19 @@ T set_difference(const T& v1, const T& v2)
     return diff;
 }
 
+/**
+ * @return a copy of the elements from the first (sorted) container which are
+ *         also found in the second (sorted) container.
+ */
+template <class T>
+T set_intersection(const T& v1, const T& v2)
+{
+    T intersection;
+    std::set_intersection(v1.begin(), v1.end(), v2.begin(), v2.end(),
+                          std::inserter(intersection, intersection.begin()));
+    return intersection;
+}
+
 /**
  * Optimal implementation of bool contains(container, value).
  * Uses container.find() if available, else uses generic std::find().
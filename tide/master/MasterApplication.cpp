@@ -65,18 +65,23 @@
 #if TIDE_ENABLE_REST_INTERFACE
 #include "rest/RestInterface.h"
 #include "tools/ActivityLogger.h"
+#include "tools/TileCacheMonitor.h"
 #endif
 
 #include <deflect/qt/QuickRenderer.h>
 #include <deflect/server/Server.h>
 
 #include <QQuickRenderControl>
+#include <QtConcurrent>
 #include <stdexcept>
 
 namespace
 {
 const QUrl QML_OFFSCREEN_ROOT_COMPONENT("qrc:/qml/master/OffscreenRoot.qml");
 
+// Coalesce marker updates to at most one broadcast per (60 Hz) wall frame
+const int markersBroadcastIntervalMs = 16;
+
 std::unique_ptr<deflect::server::Server> _createDeflectServer()
 {
     try
@@ -111,6 +116,7 @@ MasterApplication::MasterApplication(int& argc_, char** argv_,
     , _restInterface{new RestInterface{_config->master.webservicePort, _options,
                                        _session, *_config}}
     , _logger{new ActivityLogger}
+    , _tileCacheMonitor{new TileCacheMonitor}
 #endif
     , _appController{new AppController{_session, *_lock, *_deflectServer,
                                        *_options, *_config}}
@@ -138,6 +144,8 @@ MasterApplication::MasterApplication(int& argc_, char** argv_,
 MasterApplication::~MasterApplication()
 {
     _deflectServer.reset();
+    _markersBroadcastTimer.stop();
+    _screenshotWriting.waitForFinished();
 
     // Make sure the send quit happens after any pending send operation;
     // If a send operation is not matched by a receive, the MPI connection
@@ -267,6 +275,7 @@ void MasterApplication::_connectRestInterface()
 {
     _logger->monitor(*_scene);
     _restInterface->exposeStatistics(*_logger);
+    _restInterface->exposeStatistics(*_tileCacheMonitor);
 
     connect(_lock.get(), &ScreenLock::lockChanged,
             [this](const bool locked) { _restInterface->lock(locked); });
@@ -274,6 +283,10 @@ void MasterApplication::_connectRestInterface()
     connect(_appController.get(), &AppController::screenStateChanged,
             _logger.get(), &ActivityLogger::logScreenStateChanged);
 
+    connect(_masterFromWallChannel.get(),
+            &MasterFromWallChannel::receivedTileCacheStatistics,
+            _tileCacheMonitor.get(), &TileCacheMonitor::update);
+
     const auto& appRemoteController = _restInterface->getAppRemoteController();
 
     connect(&appRemoteController, &AppRemoteController::open,
@@ -340,11 +353,15 @@ void MasterApplication::_setupMPIConnections()
         _masterToWallChannel->sendAsync(std::move(lock));
     });
 
-    connect(_markers.get(), &Markers::updated, _masterToWallChannel.get(),
-            [this](MarkersPtr markers) {
-                _masterToWallChannel->sendAsync(std::move(markers));
-            },
-            Qt::DirectConnection);
+    _markersBroadcastTimer.setSingleShot(true);
+    _markersBroadcastTimer.setInterval(markersBroadcastIntervalMs);
+    connect(_markers.get(), &Markers::updated, [this] {
+        if (!_markersBroadcastTimer.isActive())
+            _markersBroadcastTimer.start();
+    });
+    connect(&_markersBroadcastTimer, &QTimer::timeout, [this] {
+        _masterToWallChannel->sendAsync(_markers);
+    });
 
     connect(_masterFromWallChannel.get(),
             &MasterFromWallChannel::receivedRequestFrame, _deflectServer.get(),
@@ -353,6 +370,13 @@ void MasterApplication::_setupMPIConnections()
     connect(_deflectServer.get(), &deflect::server::Server::receivedFrame,
             _masterToWallChannel.get(), &MasterToWallChannel::sendFrame);
 
+    connect(_masterFromWallChannel.get(),
+            &MasterFromWallChannel::pixelStreamOpen,
+            _masterToWallChannel.get(), &MasterToWallChannel::resetPixelStream);
+
+    connect(_deflectServer.get(), &deflect::server::Server::pixelStreamClosed,
+            _masterToWallChannel.get(), &MasterToWallChannel::resetPixelStream);
+
     connect(_masterFromWallChannel.get(),
             &MasterFromWallChannel::pixelStreamClose, _appController.get(),
             &AppController::terminateStream);
@@ -365,27 +389,43 @@ void MasterApplication::_setupMPIConnections()
 }
 
 void MasterApplication::_takeScreenshot(const uint surfaceIndex,
-                                        const QString filename)
+                                        const QString filename,
+                                        const double scale)
 {
     // Don't interrupt an ongoing screenshot operation
     if (_screenshotAssembler && !_screenshotAssembler->isComplete())
         return;
+    if (_screenshotWriting.isRunning())
+        return;
 
-    if (surfaceIndex >= _config->surfaces.size())
+    if (surfaceIndex >= _config->surfaces.size() || !(scale > 0.0))
         return;
 
     _screenshotAssembler.reset(
-        new ScreenshotAssembler(_config->surfaces[surfaceIndex]));
+        new ScreenshotAssembler(_config->surfaces[surfaceIndex], scale));
 
     connect(_masterFromWallChannel.get(),
             &MasterFromWallChannel::receivedScreenshot,
             _screenshotAssembler.get(), &ScreenshotAssembler::addImage);
 
-    connect(_screenshotAssembler.get(),
-            &ScreenshotAssembler::screenshotComplete,
-            [filename](const QImage screenshot) { screenshot.save(filename); });
-
-    _masterToWallChannel->sendRequestScreenshot();
+    // Writing a large screenshot takes time, don't block the application
+    auto assembler = _screenshotAssembler.get();
+    connect(assembler, &ScreenshotAssembler::screenshotComplete, this,
+            [this, assembler, filename] {
+                _screenshotWriting = QtConcurrent::run([assembler, filename] {
+                    try
+                    {
+                        assembler->write(filename);
+                    }
+                    catch (const std::runtime_error& e)
+                    {
+                        print_log(LOG_ERROR, LOG_GENERAL,
+                                  "screenshot failed: %s", e.what());
+                    }
+                });
+            });
+
+    _masterToWallChannel->sendRequestScreenshot(scale);
 }
 
 bool MasterApplication::notify(QObject* receiver, QEvent* event)
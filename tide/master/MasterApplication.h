@@ -47,7 +47,9 @@
 #include <deflect/qt/OffscreenQuickView.h>
 
 #include <QApplication>
+#include <QFuture>
 #include <QThread>
+#include <QTimer>
 
 class AppController;
 class MarkersUpdater;
@@ -105,6 +107,7 @@ private:
     Session _session;
     ScreenLockPtr _lock;
     MarkersPtr _markers;
+    QTimer _markersBroadcastTimer;
     OptionsPtr _options;
 
     std::unique_ptr<MasterWindow> _masterWindow;
@@ -115,9 +118,11 @@ private:
 #if TIDE_ENABLE_REST_INTERFACE
     std::unique_ptr<RestInterface> _restInterface;
     std::unique_ptr<ActivityLogger> _logger;
+    std::unique_ptr<TileCacheMonitor> _tileCacheMonitor;
 #endif
     std::unique_ptr<AppController> _appController;
     std::unique_ptr<ScreenshotAssembler> _screenshotAssembler;
+    QFuture<void> _screenshotWriting;
     std::unique_ptr<MarkersUpdater> _markersUpdater;
 
     void _validateConfig();
@@ -134,7 +139,7 @@ private:
 #endif
     void _setupMPIConnections();
 
-    void _takeScreenshot(uint surfaceIndex, QString filename);
+    void _takeScreenshot(uint surfaceIndex, QString filename, double scale);
 
     bool notify(QObject* receiver, QEvent* event) final;
     void _handle(const QTouchEvent* event);
@@ -79,15 +79,24 @@ void MasterFromWallChannel::processMessages()
         }
         case MessageType::IMAGE:
         {
-            QImage image;
+            QByteArray image;
             QPoint index;
             serialization::fromBinary(_buffer, image, index);
             emit receivedScreenshot(image, index);
             break;
         }
+        case MessageType::PIXELSTREAM_OPEN:
+            emit pixelStreamOpen(serialization::get<QString>(_buffer));
+            break;
         case MessageType::PIXELSTREAM_CLOSE:
             emit pixelStreamClose(serialization::get<QString>(_buffer));
             break;
+        case MessageType::TILE_CACHE_STATISTICS:
+        {
+            const auto stats = serialization::get<TileCacheStatistics>(_buffer);
+            emit receivedTileCacheStatistics(result.src, stats);
+            break;
+        }
         case MessageType::QUIT:
             _processMessages = false;
             break;
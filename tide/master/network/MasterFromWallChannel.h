@@ -41,6 +41,7 @@
 #ifndef MASTERFROMWALLCHANNEL_H
 #define MASTERFROMWALLCHANNEL_H
 
+#include "data/TileCacheStatistics.h"
 #include "network/MessageHeader.h"
 #include "network/ReceiveBuffer.h"
 #include "types.h"
@@ -75,10 +76,17 @@ signals:
 
     /**
      * Emitted after each wall process has rendered a screenshot
-     * @param image The rendered image
+     * @param image The rendered image, compressed
      * @param index The global index of the window that sent the image
      */
-    void receivedScreenshot(QImage image, QPoint index);
+    void receivedScreenshot(QByteArray image, QPoint index);
+
+    /**
+     * Emitted when the wall processes opened the given pixel stream and don't
+     * have any previous frame for it.
+     * @param uri The URI of the pixel stream
+     */
+    void pixelStreamOpen(QString uri);
 
     /**
      * Emitted when the given pixel stream was requested to be closed, e.g.
@@ -87,6 +95,13 @@ signals:
      */
     void pixelStreamClose(QString uri);
 
+    /**
+     * Emitted when a wall process sent the statistics of its tile cache.
+     * @param rank of the wall process
+     * @param stats the statistics of the process
+     */
+    void receivedTileCacheStatistics(int rank, TileCacheStatistics stats);
+
 private:
     MPICommunicator& _communicator;
     ReceiveBuffer _buffer;
@@ -96,28 +96,44 @@ void MasterToWallChannel::sendAsync(ScreenLockPtr lock)
 
 void MasterToWallChannel::sendAsync(MarkersPtr markers)
 {
-    broadcastAsync(markers, MessageType::MARKERS);
+    const auto changes = markers->takeChanges();
+    if (changes.empty())
+        return;
+
+    QMetaObject::invokeMethod(this, "_broadcast", Qt::QueuedConnection,
+                              Q_ARG(MessageType, MessageType::MARKERS),
+                              Q_ARG(std::string, changes));
 }
 
 void MasterToWallChannel::sendFrame(deflect::server::FramePtr frame)
 {
     assert(!frame->tiles.empty() && "received an empty frame");
+
+    // The frame is also used by the main thread, only modify a (shallow) copy
+    auto strippedFrame = std::make_shared<deflect::server::Frame>(*frame);
+    _streamTileCaches[frame->uri].stripUnchangedTiles(*strippedFrame);
+
 #if BOOST_VERSION >= 106000
-    broadcast(frame, MessageType::PIXELSTREAM);
+    broadcast(strippedFrame, MessageType::PIXELSTREAM);
 #else
     // WAR missing support for std::shared_ptr
-    broadcast(*frame, MessageType::PIXELSTREAM);
+    broadcast(*strippedFrame, MessageType::PIXELSTREAM);
 #endif
 }
 
+void MasterToWallChannel::resetPixelStream(const QString uri)
+{
+    _streamTileCaches.erase(uri);
+}
+
 void MasterToWallChannel::send(const Configuration& config)
 {
     _communicator.broadcast(MessageType::CONFIG, json::pack(config));
 }
 
-void MasterToWallChannel::sendRequestScreenshot()
+void MasterToWallChannel::sendRequestScreenshot(const double scale)
 {
-    _communicator.broadcast(MessageType::IMAGE);
+    broadcastAsync(scale, MessageType::IMAGE);
 }
 
 void MasterToWallChannel::sendQuit()
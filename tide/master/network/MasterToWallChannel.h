@@ -41,10 +41,13 @@
 #define MASTERTOWALLCHANNEL_H
 
 #include "network/MessageHeader.h"
+#include "network/PixelStreamTileCache.h"
 #include "types.h"
 
 #include <QObject>
 
+#include <map>
+
 /**
  * Sending channel from the master application to the wall processes.
  *
@@ -97,17 +100,29 @@ public slots:
     void sendAsync(ScreenLockPtr lock);
 
     /**
-     * Send the given Markers to the wall processes.
+     * Send the Markers which changed since the last call to the wall processes.
      * @param markers The markers to send
      */
     void sendAsync(MarkersPtr markers);
 
     /**
      * Send pixel stream frame to the wall processes.
+     *
+     * The payload of the tiles which have not changed since the previous frame
+     * of the stream is not transmitted.
      * @param frame The frame to send
      */
     void sendFrame(deflect::server::FramePtr frame);
 
+    /**
+     * Transmit the next frame of a pixel stream in full.
+     *
+     * Must be called when the wall processes don't have the previous frame of
+     * the stream, or when it is closed.
+     * @param uri The URI of the pixel stream
+     */
+    void resetPixelStream(QString uri);
+
     /**
      * Send the configuration to the wall processes.
      * @param config The configuration to send
@@ -116,8 +131,9 @@ public slots:
 
     /**
      * Send a screenshot request to the wall processes.
+     * @param scale of the images to send back, in ]0, 1].
      */
-    void sendRequestScreenshot();
+    void sendRequestScreenshot(double scale);
 
     /**
      * Send quit message to the wall processes, terminating the application.
@@ -126,6 +142,7 @@ public slots:
 
 private:
     MPICommunicator& _communicator;
+    std::map<QString, PixelStreamTileCache> _streamTileCaches;
 
     template <typename T>
     void broadcast(const T& object, const MessageType type);
@@ -98,6 +98,17 @@ struct UriAndSurface : Uri, SurfaceIndex
     }
 };
 
+struct ScreenshotParams : UriAndSurface
+{
+    double scale = 1.0;
+
+    bool fromJson(const QJsonObject& object)
+    {
+        json::deserialize(object["scale"], scale);
+        return UriAndSurface::fromJson(object) && scale > 0.0 && scale <= 1.0;
+    }
+};
+
 struct BrowseParams : UriAndSurface
 {
     bool fromJson(const QJsonObject& object)
@@ -161,8 +172,9 @@ AppRemoteController::AppRemoteController(const Configuration& config)
         emit this->browse(params.surfaceIndex, params.uri, QSize(), QPointF(),
                           0);
     });
-    rpc::connect<UriAndSurface>("screenshot", [this](const auto params) {
-        emit this->takeScreenshot(params.surfaceIndex, params.uri);
+    rpc::connect<ScreenshotParams>("screenshot", [this](const auto params) {
+        emit this->takeScreenshot(params.surfaceIndex, params.uri,
+                                  params.scale);
     });
     rpc::connect<SurfaceIndex>("whiteboard", [this](const auto params) {
         emit this->openWhiteboard(params.surfaceIndex);
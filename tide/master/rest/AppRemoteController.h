@@ -83,8 +83,8 @@ signals:
     /** Open a whiteboard. */
     void openWhiteboard(uint surfaceIndex);
 
-    /** Take a screenshot. */
-    void takeScreenshot(uint surfaceIndex, QString filename);
+    /** Take a screenshot, optionally downscaled by a factor in ]0, 1]. */
+    void takeScreenshot(uint surfaceIndex, QString filename, double scale);
 
     /** Power off the screens. */
     void powerOff(BoolCallback callback);
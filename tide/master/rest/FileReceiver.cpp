@@ -40,16 +40,24 @@
 
 #include "FileReceiver.h"
 
+#include "config.h"
+#include "data/ImageReader.h"
 #include "scene/ContentFactory.h"
 #include "session/SessionSaver.h"
 #include "utils/log.h"
 #include "json/json.h"
+#if TIDE_USE_TIFF
+#include "data/TiffPyramidReader.h"
+#include "data/TiffPyramidWriter.h"
+#endif
 
 #include <QByteArray>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QFutureWatcher>
 #include <QUrl>
+#include <QtConcurrent>
 
 using namespace rockets;
 
@@ -102,13 +110,16 @@ struct FileReceiver::UploadParameters
     uint surfaceIndex = 0;
 };
 
-FileReceiver::FileReceiver(const QString& tmpDir)
+FileReceiver::FileReceiver(const QString& tmpDir, const uint pyramidThreshold)
     : _tmpDir{tmpDir}
+    , _pyramidThreshold{pyramidThreshold}
 {
 }
 
 FileReceiver::~FileReceiver()
 {
+    for (auto& conversion : _conversions)
+        conversion.waitForFinished();
 }
 
 std::future<http::Response> FileReceiver::prepareUpload(
@@ -166,6 +177,92 @@ std::future<http::Response> FileReceiver::handleUpload(
               filePath.toLocal8Bit().constData());
 
     auto promise = std::make_shared<std::promise<Response>>();
+    if (_needsConversion(filePath))
+        _convertAndOpen(params, filePath, promise);
+    else
+        _open(params, filePath, promise);
+    return promise->get_future();
+}
+
+bool FileReceiver::_needsConversion(const QString& filePath) const
+{
+#if TIDE_USE_TIFF
+    if (_pyramidThreshold == 0)
+        return false;
+
+    const auto suffix = QFileInfo{filePath}.suffix().toLower();
+    if (suffix == "tif" || suffix == "tiff")
+    {
+        try
+        {
+            TiffPyramidReader{filePath};
+            return false; // already an image pyramid
+        }
+        catch (...)
+        { /* not a pyramid file, pass */
+        }
+    }
+
+    const auto imageReader = ImageReader{filePath};
+    if (!imageReader.isValid() || imageReader.isStereo())
+        return false;
+
+    const auto size = imageReader.getSize();
+    return uint(std::max(size.width(), size.height())) > _pyramidThreshold;
+#else
+    Q_UNUSED(filePath);
+    return false;
+#endif
+}
+
+void FileReceiver::_convertAndOpen(const UploadParameters& params,
+                                   const QString& filePath,
+                                   ResponsePromise promise)
+{
+#if TIDE_USE_TIFF
+    const auto fileInfo = QFileInfo{filePath};
+    const auto pyramidName = fileInfo.completeBaseName() + ".pyramid.tif";
+    const auto pyramidPath =
+        SessionSaver::findAvailableFilePath(pyramidName, _tmpDir);
+
+    print_log(LOG_INFO, LOG_REST, "converting %s to an image pyramid",
+              filePath.toLocal8Bit().constData());
+
+    auto watcher = new QFutureWatcher<QString>{this};
+    connect(watcher, &QFutureWatcher<QString>::finished,
+            [this, watcher, params, promise] {
+                _conversions.removeOne(watcher->future());
+                _open(params, watcher->result(), promise);
+                watcher->deleteLater();
+            });
+
+    auto future = QtConcurrent::run([filePath, pyramidPath] {
+        try
+        {
+            TiffPyramidWriter{}.write(filePath, pyramidPath);
+            QFile{filePath}.remove();
+            return pyramidPath;
+        }
+        catch (const std::exception& e)
+        {
+            print_log(LOG_WARN, LOG_REST,
+                      "image pyramid conversion failed, opening original "
+                      "file: %s",
+                      e.what());
+            QFile{pyramidPath}.remove();
+            return filePath;
+        }
+    });
+    watcher->setFuture(future);
+    _conversions.append(future);
+#else
+    _open(params, filePath, promise);
+#endif
+}
+
+void FileReceiver::_open(const UploadParameters& params,
+                         const QString& filePath, ResponsePromise promise)
+{
     emit open(
         params.surfaceIndex, filePath, params.position,
         [promise, filePath](const bool success, const QString msg) {
@@ -190,5 +287,4 @@ std::future<http::Response> FileReceiver::handleUpload(
                                                  INFO_KEY, message));
             }
         });
-    return promise->get_future();
 }
@@ -45,6 +45,8 @@
 
 #include <rockets/server.h>
 
+#include <QFuture>
+#include <QList>
 #include <QObject>
 
 /**
@@ -59,13 +61,23 @@
  * PUT /api/upload/cool%20image.png
  * --- BINARY DATA ---
  * => 201
+ *
+ * Uploaded images which are larger than a given threshold are converted to a
+ * TIFF image pyramid in the background before being opened (if available).
  */
 class FileReceiver : public QObject
 {
     Q_OBJECT
 
 public:
-    FileReceiver(const QString& tmpDir);
+    /**
+     * Create a file receiver.
+     *
+     * @param tmpDir the directory where to save the uploaded files.
+     * @param pyramidThreshold the size in pixels above which uploaded images
+     *        are converted to an image pyramid, 0 to disable.
+     */
+    FileReceiver(const QString& tmpDir, uint pyramidThreshold = 0);
     ~FileReceiver();
 
     using Response = rockets::http::Response;
@@ -95,8 +107,18 @@ signals:
 
 private:
     QString _tmpDir;
+    uint _pyramidThreshold = 0;
     struct UploadParameters;
     std::map<QString, UploadParameters> _preparedPaths;
+    QList<QFuture<QString>> _conversions; // in progress
+
+    using ResponsePromise = std::shared_ptr<std::promise<Response>>;
+
+    bool _needsConversion(const QString& filePath) const;
+    void _convertAndOpen(const UploadParameters& params,
+                         const QString& filePath, ResponsePromise promise);
+    void _open(const UploadParameters& params, const QString& filePath,
+               ResponsePromise promise);
 };
 
 #endif
@@ -51,6 +51,7 @@
 #include "scene/Scene.h"
 #include "session/Session.h"
 #include "tools/ActivityLogger.h"
+#include "tools/TileCacheMonitor.h"
 #include "utils/log.h"
 #include "json/serialization.h"
 // include last
@@ -102,7 +103,8 @@ public:
         , contentBrowser{config.folders.contents,
                          ContentFactory::getSupportedFilesFilter()}
         , sessionBrowser{config.folders.sessions, QStringList{"*.dcx"}}
-        , fileReceiver{config.folders.tmp}
+        , fileReceiver{config.folders.tmp,
+                       config.settings.imageTilingThreshold}
         , htmlContent{server}
         , lockState{locked}
     {
@@ -191,6 +193,11 @@ void RestInterface::exposeStatistics(const ActivityLogger& logger) const
     _impl->server.handleGET("tide/stats", logger);
 }
 
+void RestInterface::exposeStatistics(const TileCacheMonitor& monitor) const
+{
+    _impl->server.handleGET("tide/tilecache", monitor);
+}
+
 const AppRemoteController& RestInterface::getAppRemoteController() const
 {
     return _impl->appRemoteController;
@@ -76,6 +76,9 @@ public:
     /** Expose the statistics gathered by the given activity logger. */
     void exposeStatistics(const ActivityLogger& logger) const;
 
+    /** Expose the statistics of the tile caches of the wall processes. */
+    void exposeStatistics(const TileCacheMonitor& monitor) const;
+
     const AppRemoteController& getAppRemoteController() const;
 
     /** Prevent modifying the wall via the interface. */
@@ -47,6 +47,7 @@
 #include "scene/Scene.h"
 #include "session/Session.h"
 #include "tools/ActivityLogger.h"
+#include "tools/TileCacheMonitor.h"
 #include "json/json.h"
 #include "json/serialization.h"
 #include "json/templates.h"
@@ -66,6 +67,13 @@ QSizeF _getMinSize(const Window& window, const DisplayGroup& group)
     return WindowController(const_cast<Window&>(window), group)
         .getMinSizeAspectRatioCorrect();
 }
+
+QJsonObject _serialize(const TileCacheStatistics& stats)
+{
+    return QJsonObject{{"hits", double(stats.hits)},
+                       {"misses", double(stats.misses)},
+                       {"disk_usage", double(stats.diskUsage)}};
+}
 }
 
 namespace
@@ -157,6 +165,20 @@ QJsonObject serialize(const SessionInfo& info)
                        {"version", info.version}};
 }
 
+QJsonObject serialize(const TileCacheMonitor& monitor)
+{
+    QJsonArray processes;
+    for (const auto& entry : monitor.getStatistics())
+    {
+        auto process = _serialize(entry.second);
+        process["rank"] = entry.first;
+        processes.append(process);
+    }
+    auto result = _serialize(monitor.getTotal());
+    result["processes"] = processes;
+    return result;
+}
+
 QJsonObject serializeForRest(const Configuration& config)
 {
     std::vector<QSize> surfaceSizes;
@@ -56,6 +56,7 @@ QJsonObject serialize(const Surface& surface);
 QJsonArray serialize(const Scene& scene);
 QJsonObject serialize(const ActivityLogger& logger);
 QJsonObject serialize(const SessionInfo& info);
+QJsonObject serialize(const TileCacheMonitor& monitor);
 QJsonObject serializeForRest(const Configuration& config);
 //@}
 }
@@ -39,14 +39,43 @@
 
 #include "ScreenshotAssembler.h"
 
+#include "config.h"
+
+#if TIDE_USE_TIFF
+#include "data/TiffImageWriter.h"
+#endif
+
+#include <QFileInfo>
 #include <QPainter>
 
-ScreenshotAssembler::ScreenshotAssembler(const SurfaceConfig& surface)
+#include <stdexcept>
+
+namespace
+{
+#if TIDE_USE_TIFF
+bool _isTiff(const QString& filename)
+{
+    const auto suffix = QFileInfo{filename}.suffix().toLower();
+    return suffix == "tif" || suffix == "tiff";
+}
+#endif
+
+int _scaled(const int value, const double scale)
+{
+    return qRound(value * scale);
+}
+}
+
+ScreenshotAssembler::ScreenshotAssembler(const SurfaceConfig& surface,
+                                         const double scale)
     : _surface(surface)
-    , _screenshot{_surface.getTotalSize(), QImage::Format_RGB32}
+    , _scale{std::min(scale, 1.0)}
 {
+    if (!(_scale > 0.0))
+        throw std::invalid_argument("invalid screenshot scale");
+
     const auto count = _surface.screenCountX * _surface.screenCountY;
-    _imagesReceived.resize(count, false);
+    _images.resize(count);
 }
 
 bool ScreenshotAssembler::isComplete() const
@@ -54,28 +83,108 @@ bool ScreenshotAssembler::isComplete() const
     return _complete;
 }
 
-void ScreenshotAssembler::addImage(const QImage image, const QPoint index)
+QSize ScreenshotAssembler::getSize() const
+{
+    const auto size = _surface.getTotalSize();
+    return QSize{std::max(_scaled(size.width(), _scale), 1),
+                 std::max(_scaled(size.height(), _scale), 1)};
+}
+
+QImage ScreenshotAssembler::assemble() const
+{
+    QImage screenshot{getSize(), QImage::Format_RGB32};
+    screenshot.fill(Qt::black);
+    {
+        QPainter painter{&screenshot};
+        for (auto y = 0; y < (int)_surface.screenCountY; ++y)
+            _drawRow(painter, y);
+    }
+    return screenshot;
+}
+
+void ScreenshotAssembler::write(const QString& filename) const
 {
+#if TIDE_USE_TIFF
+    if (_isTiff(filename))
     {
-        QPainter{&_screenshot}.drawImage(_surface.getScreenRect(index), image);
+        _writeTiff(filename);
+        return;
     }
+#endif
+    if (!assemble().save(filename))
+        throw std::runtime_error("could not save " + filename.toStdString());
+}
 
+void ScreenshotAssembler::addImage(const QByteArray image, const QPoint index)
+{
     const auto source = index.x() + index.y() * _surface.screenCountX;
-    _imagesReceived[source] = true;
-    _complete = false;
+    if (source >= _images.size())
+        return;
 
-    if (_hasReceivedAllImages())
+    _images[source] = image;
+
+    if (!_complete && _hasReceivedAllImages())
     {
         _complete = true;
-        std::fill(_imagesReceived.begin(), _imagesReceived.end(), false);
-        emit screenshotComplete(_screenshot);
+        emit screenshotComplete();
     }
 }
 
 bool ScreenshotAssembler::_hasReceivedAllImages() const
 {
-    for (const auto& received : _imagesReceived)
-        if (!received)
+    for (const auto& image : _images)
+        if (image.isNull())
             return false;
     return true;
 }
+
+QRect ScreenshotAssembler::_getTargetRect(const QPoint& index) const
+{
+    // Scale both corners so that adjacent screens do not overlap or leave gaps
+    const auto rect = _surface.getScreenRect(index);
+    const auto x0 = _scaled(rect.left(), _scale);
+    const auto y0 = _scaled(rect.top(), _scale);
+    const auto x1 = _scaled(rect.left() + rect.width(), _scale);
+    const auto y1 = _scaled(rect.top() + rect.height(), _scale);
+    return QRect{x0, y0, x1 - x0, y1 - y0};
+}
+
+void ScreenshotAssembler::_drawRow(QPainter& painter, const int row) const
+{
+    for (auto x = 0; x < (int)_surface.screenCountX; ++x)
+    {
+        const auto source = x + row * _surface.screenCountX;
+        // Decode one image at a time to bound the memory usage
+        const auto image = QImage::fromData(_images[source]);
+        if (!image.isNull())
+            painter.drawImage(_getTargetRect({x, row}), image);
+    }
+}
+
+#if TIDE_USE_TIFF
+void ScreenshotAssembler::_writeTiff(const QString& filename) const
+{
+    const auto size = getSize();
+    TiffImageWriter writer{filename, size};
+
+    // One band per row of screens, including the mullion below it
+    const auto rows = (int)_surface.screenCountY;
+    for (auto y = 0; y < rows; ++y)
+    {
+        const auto top = writer.getRowsWritten();
+        const auto bottom = y + 1 < rows ? _getTargetRect({0, y + 1}).top()
+                                         : size.height();
+        if (bottom <= top)
+            continue;
+
+        QImage band{size.width(), bottom - top, QImage::Format_RGB32};
+        band.fill(Qt::black);
+        {
+            QPainter painter{&band};
+            painter.translate(0, -top);
+            _drawRow(painter, y);
+        }
+        writer.write(band);
+    }
+}
+#endif
@@ -42,11 +42,17 @@
 
 #include "configuration/SurfaceConfig.h"
 
+#include <QByteArray>
 #include <QImage>
 #include <QObject>
 
 /**
  * Assemble screenshots from the wall processes into a single image.
+ *
+ * The images are kept compressed as received from the wall processes until
+ * the screenshot is written. TIFF files are written by bands of one row of
+ * screens at a time, so that the memory needed does not depend on the size of
+ * the wall; other formats are assembled in memory.
  */
 class ScreenshotAssembler : public QObject
 {
@@ -57,31 +63,50 @@ public:
      * Construct a screenshot assembler for a certain surface.
      *
      * @param config the configuration of the surface.
+     * @param scale the scale of the screenshot wrt the surface, in ]0, 1].
      */
-    explicit ScreenshotAssembler(const SurfaceConfig& config);
+    explicit ScreenshotAssembler(const SurfaceConfig& config,
+                                 double scale = 1.0);
 
     /** @return true once the screenshot is complete. */
     bool isComplete() const;
 
+    /** @return the size of the screenshot. */
+    QSize getSize() const;
+
+    /** @return the complete screenshot assembled in a single image. */
+    QImage assemble() const;
+
+    /**
+     * Write the screenshot to a file.
+     *
+     * @param filename the image file, its suffix determines the format.
+     * @throw std::runtime_error if writing the image failed.
+     */
+    void write(const QString& filename) const;
+
 public slots:
     /**
      * Add an image to the current screenshot.
-     * @param image the image to add.
+     * @param image the compressed image to add.
      * @param index the index of the wall process that sent the image.
      */
-    void addImage(QImage image, QPoint index);
+    void addImage(QByteArray image, QPoint index);
 
 signals:
     /** Emitted when the last image forming the screenshot has been added. */
-    void screenshotComplete(QImage image);
+    void screenshotComplete();
 
 private:
     const SurfaceConfig& _surface;
-    QImage _screenshot;
-    std::vector<bool> _imagesReceived;
+    const double _scale;
+    std::vector<QByteArray> _images;
     bool _complete = false;
 
     bool _hasReceivedAllImages() const;
+    QRect _getTargetRect(const QPoint& index) const;
+    void _drawRow(QPainter& painter, int row) const;
+    void _writeTiff(const QString& filename) const;
 };
 
 #endif
@@ -55,6 +55,8 @@
 
 #include <QtConcurrent>
 
+#include <algorithm>
+
 namespace
 {
 template <typename Map>
@@ -151,6 +153,19 @@ void DataProvider::synchronizeTilesUpdate(WallToWallChannel& channel)
     _updateTiles();
 }
 
+bool DataProvider::hasPendingLoads() const
+{
+    return !_watchers.empty() || !_tileImageRequests.empty();
+}
+
+std::chrono::milliseconds DataProvider::getTimeToNextFrame() const
+{
+    auto delay = std::chrono::milliseconds::max();
+    for (const auto& dataSource : _dataSources)
+        delay = std::min(delay, dataSource.second->getTimeToNextFrame());
+    return delay;
+}
+
 void DataProvider::loadAsync(TilePtr tile, deflect::View view)
 {
     // Group the requests for a single tile from multiple WallWindows for the
@@ -187,6 +202,7 @@ DataSourceSharedPtr DataProvider::_getOrCreateDataSource(const Content& content)
 
             // request the first frame now that the data source is ready to
             // accept it.
+            emit pixelStreamOpened(content.getUri());
             emit requestPixelStreamFrame(content.getUri());
         }
     }
@@ -43,6 +43,8 @@
 #include "synchronizers/ContentSynchronizer.h"
 #include "types.h"
 
+#include <chrono>
+
 #include <QFutureWatcher>
 #include <QList>
 #include <QObject>
@@ -92,6 +94,12 @@ public:
      */
     void synchronizeTilesUpdate(WallToWallChannel& channel);
 
+    /** @return true while tile images are being loaded asynchronously. */
+    bool hasPendingLoads() const;
+
+    /** @return the shortest time until a data source needs a new frame. */
+    std::chrono::milliseconds getTimeToNextFrame() const;
+
 public slots:
     /** Start loading a tile image asynchronously. */
     void loadAsync(TilePtr tile, deflect::View view);
@@ -100,6 +108,9 @@ public slots:
     void setNewFrame(deflect::server::FramePtr frame);
 
 signals:
+    /** Emitted when a stream was opened, before its first frame request. */
+    void pixelStreamOpened(QString uri);
+
     /** Emitted to request a new frame for a stream after a successful swap. */
     void requestPixelStreamFrame(QString uri);
 
@@ -41,7 +41,9 @@
 
 #include "DataProvider.h"
 #include "WallConfiguration.h"
+#include "datasources/DataSource.h"
 #include "network/WallToWallChannel.h"
+#include "qml/TilePool.h"
 #include "qml/WallWindow.h"
 #include "scene/CountdownStatus.h"
 #include "scene/Options.h"
@@ -49,6 +51,11 @@
 #include "scene/ScreenLock.h"
 #include "swapsync/SwapSynchronizer.h"
 
+namespace
+{
+const auto noFrame = uint64_t(std::chrono::milliseconds::max().count());
+}
+
 RenderController::RenderController(const WallConfiguration& config,
                                    DataProvider& provider,
                                    WallToWallChannel& wallChannel,
@@ -97,9 +104,9 @@ void RenderController::updateCountdownStatus(CountdownStatusPtr status)
     _requestRender();
 }
 
-void RenderController::updateRequestScreenshot()
+void RenderController::updateRequestScreenshot(const double scale)
 {
-    _syncScreenshot.update(true);
+    _syncScreenshot.update(scale);
     _requestRender();
 }
 
@@ -112,11 +119,13 @@ void RenderController::updateQuit()
 void RenderController::timerEvent(QTimerEvent* qtEvent)
 {
     if (qtEvent->timerId() == _renderTimer)
+    {
+        killTimer(_renderTimer);
+        _renderTimer = 0;
         _syncAndRender();
+    }
     else if (qtEvent->timerId() == _idleRedrawTimer)
         _requestRender();
-    else if (qtEvent->timerId() == _stopRenderingDelayTimer)
-        _stopRendering();
 }
 
 void RenderController::_connectSwapSyncObjects()
@@ -155,7 +164,9 @@ void RenderController::_connectScreenshotSignals()
     for (auto&& window : _windows)
     {
         connect(window.get(), &WallWindow::imageGrabbed, this,
-                &RenderController::screenshotRendered);
+                [this](const QImage image, const QPoint index) {
+                    emit screenshotRendered(image, index, _screenshotScale);
+                });
     }
 }
 
@@ -175,13 +186,10 @@ void RenderController::_setupSwapSynchronization(
 
 void RenderController::_requestRender()
 {
-    killTimer(_stopRenderingDelayTimer);
     killTimer(_idleRedrawTimer);
-    _stopRenderingDelayTimer = 0;
     _idleRedrawTimer = 0;
 
-    if (_renderTimer == 0)
-        _renderTimer = startTimer(5, Qt::PreciseTimer);
+    _scheduleFrame(std::chrono::milliseconds::zero());
 }
 
 void RenderController::_syncAndRender()
@@ -200,9 +208,15 @@ void RenderController::_syncAndRender()
 
 void RenderController::_renderAllWindows()
 {
-    const auto grab = _syncScreenshot.get();
+    // The scale is synchronized along with the request so that all the
+    // processes use the same one
+    const auto screenshotScale = _syncScreenshot.get();
+    const auto grab = screenshotScale > 0.0;
     if (grab)
-        _syncScreenshot = SwapSyncObject<bool>{false};
+    {
+        _screenshotScale = screenshotScale;
+        _syncScreenshot = SwapSyncObject<double>{0.0};
+    }
 
     for (auto&& window : _windows)
     {
@@ -214,29 +228,64 @@ void RenderController::_renderAllWindows()
 
 void RenderController::_scheduleRedraw()
 {
-    for (const auto& window : _windows)
-        _redrawNeeded = _redrawNeeded || window->needRedraw();
+    // All the processes agree on the earliest frame that any of them needs,
+    // which keeps them in lockstep with a single collective per frame.
+    const auto localDelay = uint64_t(_getTimeToNextFrame().count());
+    const auto delay = _wallChannel.globalMin(localDelay);
+    _redrawNeeded = false;
 
-    if (_wallChannel.allReady(!_redrawNeeded))
-        _scheduleStopRendering();
+    if (delay == noFrame)
+        _stopRendering();
     else
-        _requestRender();
+        _scheduleFrame(std::chrono::milliseconds(delay));
+}
 
-    _redrawNeeded = false;
+void RenderController::_scheduleFrame(const std::chrono::milliseconds delay)
+{
+    // Never postpone a frame which is already scheduled earlier
+    const auto frameTime = clock::now() + delay;
+    if (_renderTimer != 0 && _nextFrameTime <= frameTime)
+        return;
+
+    killTimer(_renderTimer);
+    _renderTimer = startTimer(int(delay.count()), Qt::PreciseTimer);
+    _nextFrameTime = frameTime;
 }
 
-void RenderController::_scheduleStopRendering()
+std::chrono::milliseconds RenderController::_getTimeToNextFrame() const
 {
-    if (_stopRenderingDelayTimer == 0)
-        _stopRenderingDelayTimer = startTimer(5000 /*ms*/);
+    if (_redrawNeeded)
+        return std::chrono::milliseconds::zero();
+
+    for (const auto& window : _windows)
+        if (window->needRedraw())
+            return std::chrono::milliseconds::zero();
+
+    // Scene updates and tile loads complete independently on each process,
+    // so they are polled for instead of waking up the other processes.
+    if (_hasPendingSceneUpdates() || _provider.hasPendingLoads())
+        return DataSource::getPollInterval();
+
+    return _provider.getTimeToNextFrame();
+}
+
+bool RenderController::_hasPendingSceneUpdates() const
+{
+    return _syncScene.hasPendingUpdate() || _syncMarkers.hasPendingUpdate() ||
+           _syncOptions.hasPendingUpdate() || _syncLock.hasPendingUpdate() ||
+           _syncCountdownStatus.hasPendingUpdate() ||
+           _syncScreenshot.hasPendingUpdate() || _syncQuit.hasPendingUpdate();
 }
 
 void RenderController::_stopRendering()
 {
     killTimer(_renderTimer);
-    killTimer(_stopRenderingDelayTimer);
     _renderTimer = 0;
-    _stopRenderingDelayTimer = 0;
+
+    const auto tiles = TilePool::instance().getStatistics();
+    print_log(LOG_VERBOSE, LOG_GENERAL,
+              "tile pool: %d created, %d reused, %d pooled", int(tiles.created),
+              int(tiles.reused), int(tiles.pooled));
 
     // Redraw screen every minute so that the on-screen clock is up to date
     if (_idleRedrawTimer == 0)
@@ -267,7 +316,6 @@ void RenderController::_synchronizeDataSourceUpdates()
 void RenderController::_terminateRendering()
 {
     killTimer(_renderTimer);
-    killTimer(_stopRenderingDelayTimer);
     killTimer(_idleRedrawTimer);
 
     for (auto&& window : _windows)
@@ -47,6 +47,8 @@
 #include <QImage>
 #include <QObject>
 
+#include <chrono>
+
 /**
  * Setup the scene and control the rendering options during runtime.
  */
@@ -68,11 +70,11 @@ public slots:
     void updateOptions(OptionsPtr options);
     void updateLock(ScreenLockPtr lock);
     void updateCountdownStatus(CountdownStatusPtr status);
-    void updateRequestScreenshot();
+    void updateRequestScreenshot(double scale);
     void updateQuit();
 
 signals:
-    void screenshotRendered(QImage image, QPoint index);
+    void screenshotRendered(QImage image, QPoint index, double scale);
 
 private:
     std::vector<WallWindowPtr> _windows;
@@ -85,11 +87,15 @@ private:
     SwapSyncObject<OptionsPtr> _syncOptions;
     SwapSyncObject<ScreenLockPtr> _syncLock;
     SwapSyncObject<CountdownStatusPtr> _syncCountdownStatus;
-    SwapSyncObject<bool> _syncScreenshot{false};
+    // Scale of the requested screenshot, 0 if none
+    SwapSyncObject<double> _syncScreenshot{0.0};
+    double _screenshotScale = 1.0;
     SwapSyncObject<bool> _syncQuit{false};
 
+    using clock = std::chrono::steady_clock;
+
     int _renderTimer = 0;
-    int _stopRenderingDelayTimer = 0;
+    clock::time_point _nextFrameTime;
     int _idleRedrawTimer = 0;
     bool _redrawNeeded = false;
 
@@ -107,7 +113,9 @@ private:
     void _syncAndRender();
     void _renderAllWindows();
     void _scheduleRedraw();
-    void _scheduleStopRendering();
+    void _scheduleFrame(std::chrono::milliseconds delay);
+    std::chrono::milliseconds _getTimeToNextFrame() const;
+    bool _hasPendingSceneUpdates() const;
     void _stopRendering();
     void _synchronizeSceneUpdates();
     void _synchronizeDataSourceUpdates();
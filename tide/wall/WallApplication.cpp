@@ -39,18 +39,33 @@
 
 #include "WallApplication.h"
 
+#include "config.h"
+
 #include "DataProvider.h"
 #include "QmlTypeRegistration.h"
 #include "RenderController.h"
 #include "WallConfiguration.h"
+#include "datasources/ImageTiler.h"
+#include "datasources/PixelStreamUpdater.h"
 #include "network/MPICommunicator.h"
 #include "network/WallFromMasterChannel.h"
 #include "network/WallToMasterChannel.h"
 #include "network/WallToWallChannel.h"
+#include "qml/TextureUploader.h"
 #include "scene/VectorialContent.h"
+#include "tools/TileDiskCache.h"
+
+#if TIDE_ENABLE_MOVIE_SUPPORT
+#include "data/FFMPEGThreadBudget.h"
+#endif
 
 #include <QThreadPool>
 
+namespace
+{
+const int tileCacheStatisticsIntervalMs = 5000;
+}
+
 WallApplication::WallApplication(int& argc_, char** argv_,
                                  MPICommunicator& masterRecvComm,
                                  MPICommunicator& masterSendComm,
@@ -70,12 +85,28 @@ WallApplication::WallApplication(int& argc_, char** argv_,
 
     Content::setMaxScale(config.settings.contentMaxScale);
     VectorialContent::setMaxScale(config.settings.contentMaxScaleVectorial);
+    PixelStreamUpdater::setPipelineDepth(
+        config.settings.pixelStreamPipelineDepth);
+    TileDiskCache::configure(config.folders.tileCache,
+                             config.settings.tileCacheMaxSize);
+    ImageTiler::setSizeThreshold(config.settings.imageTilingThreshold);
+    TextureUploader::setDefaultFrameBudget(
+        size_t(config.settings.textureUploadBudget) * 1024 * 1024);
 
     // avoid overcommit for async content loading; consider number of processes
     // on the same machine
     const auto prCount = _config->processCountForHost;
+#if TIDE_ENABLE_MOVIE_SUPPORT
+    // movie decoding threads take their share of the same cores
+    auto& threadBudget = FFMPEGThreadBudget::instance();
+    threadBudget.setProcessCount(prCount);
+    threadBudget.setLoadingThreadsCallback([](const uint count) {
+        QThreadPool::globalInstance()->setMaxThreadCount(count);
+    });
+#else
     const auto maxThreads = std::max(QThread::idealThreadCount() / prCount, 2);
     QThreadPool::globalInstance()->setMaxThreadCount(maxThreads);
+#endif
 
     _renderController =
         std::make_unique<RenderController>(*_config, *_provider, *_wallChannel,
@@ -134,6 +165,9 @@ void WallApplication::_initMPIConnections()
 
     if (_wallChannel->getRank() == 0)
     {
+        connect(_provider.get(), &DataProvider::pixelStreamOpened,
+                _toMasterChannel.get(),
+                &WallToMasterChannel::sendPixelStreamOpen);
         connect(_provider.get(), &DataProvider::requestPixelStreamFrame,
                 _toMasterChannel.get(), &WallToMasterChannel::sendRequestFrame);
         connect(_provider.get(), &DataProvider::closePixelStream,
@@ -144,12 +178,22 @@ void WallApplication::_initMPIConnections()
     connect(&_mpiReceiveThread, &QThread::started, _fromMasterChannel.get(),
             &WallFromMasterChannel::processMessages);
 
+    if (TileDiskCache::getInstance())
+    {
+        connect(&_tileCacheStatisticsTimer, &QTimer::timeout,
+                _toMasterChannel.get(),
+                &WallToMasterChannel::sendTileCacheStatistics);
+        _tileCacheStatisticsTimer.start(tileCacheStatisticsIntervalMs);
+    }
+
     _mpiReceiveThread.start();
     _mpiSendThread.start();
 }
 
 void WallApplication::_terminateMPIConnections()
 {
+    _tileCacheStatisticsTimer.stop();
+
     if (_wallChannel->getRank() == 0)
     {
         // Make sure the send quit happens after any pending sendRequestFrame.
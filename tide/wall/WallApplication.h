@@ -44,6 +44,7 @@
 
 #include <QGuiApplication>
 #include <QThread>
+#include <QTimer>
 
 class RenderController;
 class WallFromMasterChannel;
@@ -90,6 +91,7 @@ private:
 
     QThread _mpiSendThread;
     QThread _mpiReceiveThread;
+    QTimer _tileCacheStatisticsTimer;
 
     void _initMPIConnections();
     void _terminateMPIConnections();
@@ -39,7 +39,21 @@
 
 #include "CachedDataSource.h"
 
+#include "data/CompressedImage.h"
 #include "data/QtImage.h"
+#include "tools/TileDiskCache.h"
+
+#include <cstdlib> // getenv
+#include <string>
+
+namespace
+{
+bool _isTextureCompressionEnabled()
+{
+    const auto envStr = getenv("TIDE_TEXTURE_COMPRESSION");
+    return !envStr || std::string(envStr) != "0";
+}
+}
 
 ImagePtr CachedDataSource::getTileImage(const uint tileId,
                                         const deflect::View view) const
@@ -48,19 +62,19 @@ ImagePtr CachedDataSource::getTileImage(const uint tileId,
     {
         const QMutexLocker lock(&_mutex);
         if (cache.contains(tileId))
-            return std::make_shared<QtImage>(cache[tileId]);
+            return cache[tileId];
     }
 
-    const auto image =
-        QtImage::toGlCompatibleFormat(getCachableTileImage(tileId, view));
-    if (image.isNull())
+    const auto tileImage = _getTileImage(tileId, view);
+    if (tileImage.isNull())
         throw std::logic_error("Cachable tile images should not be null");
 
+    const auto image = _createImage(tileImage);
     {
         const QMutexLocker lock(&_mutex);
         cache.insert(tileId, image);
     }
-    return std::make_shared<QtImage>(image);
+    return image;
 }
 
 bool CachedDataSource::contains(const uint tileId) const
@@ -69,6 +83,43 @@ bool CachedDataSource::contains(const uint tileId) const
     return _cacheLeftOrMono.contains(tileId);
 }
 
+QImage CachedDataSource::_getTileImage(const uint tileId,
+                                      const deflect::View view) const
+{
+    auto diskCache = isDiskCachable() ? TileDiskCache::getInstance() : nullptr;
+    QString key;
+    if (diskCache)
+    {
+        const auto cacheView = isStereo() ? view : deflect::View::mono;
+        key = TileDiskCache::makeKey(getUri(), getTilesArea(0, 0), tileId,
+                                     cacheView);
+    }
+
+    if (!key.isEmpty())
+    {
+        const auto image = diskCache->load(key);
+        if (!image.isNull())
+            return QtImage::toGlCompatibleFormat(image);
+    }
+
+    const auto image =
+        QtImage::toGlCompatibleFormat(getCachableTileImage(tileId, view));
+
+    if (!key.isEmpty() && !image.isNull())
+        diskCache->store(key, image);
+    return image;
+}
+
+ImagePtr CachedDataSource::_createImage(const QImage& image) const
+{
+    if (isCompressible() && _isTextureCompressionEnabled() &&
+        CompressedImage::canCompress(image))
+    {
+        return std::make_shared<CompressedImage>(image);
+    }
+    return std::make_shared<QtImage>(image);
+}
+
 CachedDataSource::Cache& CachedDataSource::_getCache(
     const deflect::View view) const
 {
@@ -48,6 +48,14 @@
 
 /**
  * A data source which maintains a cache of the requested tiles.
+ *
+ * Sources which opt in with isDiskCachable() also use the TileDiskCache, if
+ * enabled, to persist their tiles across sessions.
+ *
+ * Sources which opt in with isCompressible() keep their opaque tiles in a
+ * GPU-compressed format (see CompressedImage), which takes 8 times less memory
+ * and upload bandwidth than RGBA. Compression can be disabled by setting the
+ * TIDE_TEXTURE_COMPRESSION environment variable to 0.
  */
 class CachedDataSource : public DataSource
 {
@@ -67,12 +75,20 @@ private:
     /** @return true is the source is stereo. */
     virtual bool isStereo() const = 0;
 
+    /** @return true if the tiles can be stored in the TileDiskCache. */
+    virtual bool isDiskCachable() const { return false; }
+
+    /** @return true if the tiles can be compressed with a loss of quality. */
+    virtual bool isCompressible() const { return false; }
+
     mutable QMutex _mutex;
-    using Cache = QMap<uint, QImage>;
+    using Cache = QMap<uint, ImagePtr>;
     mutable Cache _cacheLeftOrMono;
     mutable Cache _cacheRight;
 
     Cache& _getCache(deflect::View view) const;
+    QImage _getTileImage(uint tileId, deflect::View view) const;
+    ImagePtr _createImage(const QImage& image) const;
 };
 
 #endif
@@ -43,6 +43,8 @@
 #include "synchronizers/ContentSynchronizers.h"
 #include "types.h"
 
+#include <chrono>
+
 /**
  * Base interface for shared data sources.
  *
@@ -94,6 +96,23 @@ public:
         Q_UNUSED(channel);
     }
 
+    /**
+     * @return the time until the source needs a new frame to be rendered:
+     *         zero if it has one ready, getPollInterval() while a frame is
+     *         being prepared asynchronously, or max() if it only changes in
+     *         response to external events (scene updates, stream frames).
+     */
+    virtual std::chrono::milliseconds getTimeToNextFrame() const
+    {
+        return std::chrono::milliseconds::max();
+    }
+
+    /** @return the delay between checks for asynchronous work to complete. */
+    static std::chrono::milliseconds getPollInterval()
+    {
+        return std::chrono::milliseconds{5};
+    }
+
     /** The synchronizers linked to this shared data source. */
     ContentSynchronizers synchronizers;
 };
@@ -42,7 +42,9 @@
 #include "config.h"
 #include "scene/Content.h"
 
+#include "data/ImageReader.h"
 #include "datasources/ImageSource.h"
+#include "datasources/ImageTiler.h"
 #include "datasources/PixelStreamUpdater.h"
 #include "datasources/SVGTiler.h"
 
@@ -76,6 +78,11 @@ std::unique_ptr<DataSource> DataSourceFactory::create(const Content& content)
         return std::make_unique<SVGTiler>(content.getUri(),
                                           content.getMaxDimensions());
     case ContentType::image:
+        if (ImageTiler::isLarge(content.getDimensions()) &&
+            !ImageReader{content.getUri()}.isStereo())
+        {
+            return std::make_unique<ImageTiler>(content.getUri());
+        }
         return std::make_unique<ImageSource>(content.getUri());
 
 #if TIDE_ENABLE_PDF_SUPPORT
@@ -67,6 +67,7 @@ private:
     /** threadsafe */
     QImage getCachableTileImage(uint tileId, deflect::View view) const final;
     bool isStereo() const final { return false; }
+    bool isCompressible() const final { return true; }
     const LodTools& _getLodTool() const final { return *_lodTool; }
     const QString _uri;
     std::unique_ptr<LodTools> _lodTool;
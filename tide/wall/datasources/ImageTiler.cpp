@@ -0,0 +1,174 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "ImageTiler.h"
+
+#include "data/ImageReader.h"
+#include "tools/LodTools.h"
+#include "utils/log.h"
+
+#include <QImageReader>
+
+#include <algorithm>
+
+namespace
+{
+const uint tileSize = 1024;
+
+// Larger images can't be uploaded as a single texture anyway
+const uint maxTextureSize = 16384;
+
+// Levels of the pyramid kept in memory while their tiles are requested
+const size_t maxDecodedLevels = 2;
+
+uint _sizeThreshold = 4096;
+}
+
+ImageTiler::ImageTiler(const QString& uri)
+    : _uri{uri}
+{
+    const ImageReader reader{uri};
+    if (reader.isValid() && !reader.isStereo())
+        _lodTool = std::make_unique<LodTools>(reader.getSize(), tileSize);
+    else
+    {
+        _lodTool = std::make_unique<LodTools>(QSize(), 1u);
+        print_log(LOG_WARN, LOG_CONTENT, "Invalid image for tiling: %s",
+                  uri.toLocal8Bit().constData());
+    }
+}
+
+ImageTiler::~ImageTiler() = default;
+
+void ImageTiler::setSizeThreshold(const uint threshold)
+{
+    _sizeThreshold = threshold;
+}
+
+bool ImageTiler::isLarge(const QSize& imageSize)
+{
+    const auto threshold = int(std::min(_sizeThreshold, maxTextureSize));
+    return imageSize.width() > threshold || imageSize.height() > threshold;
+}
+
+QString ImageTiler::getUri() const
+{
+    return _uri;
+}
+
+QImage ImageTiler::getCachableTileImage(const uint tileId,
+                                        const deflect::View view) const
+{
+    Q_UNUSED(view);
+
+    const auto lod = _lodTool->getTileIndex(tileId).lod;
+    const auto image = _acquireLevel(lod);
+    if (image.isNull())
+        throw std::runtime_error("Image source is invalid");
+
+    const auto tile = image.copy(getTileRect(tileId));
+    _releaseLevel(lod, tileId);
+    return tile;
+}
+
+QImage ImageTiler::_acquireLevel(const uint lod) const
+{
+    const std::lock_guard<std::mutex> lock(_levelsMutex);
+
+    auto it = std::find_if(_levels.begin(), _levels.end(),
+                           [lod](const Level& level) {
+                               return level.lod == lod;
+                           });
+    if (it == _levels.end())
+    {
+        _levels.push_front(Level{lod, _decodeLevel(lod), {}});
+        if (_levels.size() > maxDecodedLevels)
+            _levels.pop_back();
+    }
+    else if (it != _levels.begin())
+        _levels.splice(_levels.begin(), _levels, it);
+
+    return _levels.front().image;
+}
+
+void ImageTiler::_releaseLevel(const uint lod, const uint tileId) const
+{
+    const std::lock_guard<std::mutex> lock(_levelsMutex);
+
+    auto it = std::find_if(_levels.begin(), _levels.end(),
+                           [lod](const Level& level) {
+                               return level.lod == lod;
+                           });
+    if (it == _levels.end())
+        return;
+
+    // Once all its tiles have been copied, they are retained by the caches
+    const auto count = _lodTool->getTilesCount(lod);
+    it->copiedTiles.insert(tileId);
+    if (it->copiedTiles.size() >= size_t(count.width() * count.height()))
+        _levels.erase(it);
+}
+
+QImage ImageTiler::_decodeLevel(const uint lod) const
+{
+    const auto size = _lodTool->getTilesArea(lod);
+
+    // Decoders which support it (e.g. jpeg) decode directly at the reduced
+    // size, the others decode the full image and downscale it.
+    QImageReader reader{_uri};
+    if (lod > 0)
+        reader.setScaledSize(size);
+    auto image = reader.read();
+    if (image.size() != size)
+    {
+        print_log(LOG_WARN, LOG_CONTENT, "Could not decode image: %s",
+                  _uri.toLocal8Bit().constData());
+        return QImage();
+    }
+
+    // Tiles are uploaded as 32 bit textures
+    if (image.format() != QImage::Format_ARGB32 &&
+        image.format() != QImage::Format_RGB32)
+    {
+        const auto format = image.hasAlphaChannel() ? QImage::Format_ARGB32
+                                                    : QImage::Format_RGB32;
+        image = image.convertToFormat(format);
+    }
+    return image;
+}
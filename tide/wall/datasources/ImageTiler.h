@@ -0,0 +1,108 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef IMAGETILER_H
+#define IMAGETILER_H
+
+#include "LodTiler.h"
+
+#include <list>
+#include <mutex>
+#include <set>
+
+/**
+ * Represent a large regular image as a multi-LOD tiled data source.
+ *
+ * Each level of the pyramid is decoded at its own resolution on the first
+ * request of one of its tiles, which are then copied from it. Only the two most
+ * recently used levels are kept in memory, and a level is released as soon as
+ * all of its tiles have been copied, since they are retained by the caches
+ * from then on. Tiles are also stored in the TileDiskCache (if enabled), so
+ * that the image does not need to be decoded again when it is reopened.
+ */
+class ImageTiler : public LodTiler
+{
+public:
+    /**
+     * Constructor.
+     * @param uri of the image file, which must not be a stereo image
+     */
+    explicit ImageTiler(const QString& uri);
+
+    /** Destructor. */
+    ~ImageTiler();
+
+    /**
+     * Set the size above which images are tiled.
+     * @param threshold max of width and height in pixels, never more than the
+     *        maximum texture size
+     */
+    static void setSizeThreshold(uint threshold);
+
+    /** @return true if an image of the given size should be tiled. */
+    static bool isLarge(const QSize& imageSize);
+
+    /** @copydoc DataSource::getUri */
+    QString getUri() const final;
+
+private:
+    /** threadsafe */
+    QImage getCachableTileImage(uint tileId, deflect::View view) const final;
+    bool isStereo() const final { return false; }
+    bool isDiskCachable() const final { return true; }
+    const LodTools& _getLodTool() const final { return *_lodTool; }
+
+    QImage _acquireLevel(uint lod) const;
+    void _releaseLevel(uint lod, uint tileId) const;
+    QImage _decodeLevel(uint lod) const;
+
+    const QString _uri;
+    std::unique_ptr<LodTools> _lodTool;
+
+    struct Level
+    {
+        uint lod;
+        QImage image;
+        std::set<uint> copiedTiles;
+    };
+    mutable std::mutex _levelsMutex;
+    mutable std::list<Level> _levels; // most recently used first
+};
+
+#endif
@@ -46,6 +46,7 @@
 #include "scene/MovieContent.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <cmath>
 
 MovieUpdater::MovieUpdater(const QString& uri)
@@ -222,6 +223,11 @@ void MovieUpdater::synchronizeFrameAdvance(WallToWallChannel& channel)
     const bool visible = synchronizers.haveVisibleTiles();
     const double frameDuration = _frameDuration;
 
+    if (_ffmpegMovie)
+        _ffmpegMovie->setActive(visible && (!_paused || _skipping));
+
+    const auto skipTarget = _skipping ? _getSkipTarget(channel, visible) : 0.0;
+
     bool inSync = false;
     {
         // protect _sharedTimestamp & _currentPosition from getTileImage()
@@ -229,7 +235,7 @@ void MovieUpdater::synchronizeFrameAdvance(WallToWallChannel& channel)
 
         // Jump to the skip position
         if (_skipping && !_loopedBack)
-            _sharedTimestamp = _skipPosition;
+            _sharedTimestamp = skipTarget;
 
         inSync = std::abs(_sharedTimestamp - _currentPosition) <= frameDuration;
     }
@@ -279,6 +285,22 @@ void MovieUpdater::synchronizeFrameAdvance(WallToWallChannel& channel)
     _triggerFrameUpdate();
 }
 
+std::chrono::milliseconds MovieUpdater::getTimeToNextFrame() const
+{
+    if (!synchronizers.haveVisibleTiles())
+        return std::chrono::milliseconds::max();
+
+    // The decoding and upload of the current frame complete asynchronously
+    if (!_readyForNextFrame || _skipping)
+        return getPollInterval();
+
+    if (_paused)
+        return std::chrono::milliseconds::max();
+
+    const auto remaining = std::max(_frameDuration - _elapsedTime, 0.0);
+    return std::chrono::milliseconds{int64_t(std::ceil(remaining * 1000.0))};
+}
+
 void MovieUpdater::_triggerFrameUpdate()
 {
     _readyForNextFrame = false;
@@ -287,6 +309,33 @@ void MovieUpdater::_triggerFrameUpdate()
     emit pictureUpdated();
 }
 
+double MovieUpdater::_getSkipTarget(WallToWallChannel& channel,
+                                    const bool visible)
+{
+    // Show the keyframe of a new skip position first, then the exact frame
+    // decoded forward from it if the position stays the same
+    if (_skipPosition == _previewedSkipPosition)
+        return _skipPosition;
+    _previewedSkipPosition = _skipPosition;
+
+    // Processes only know the keyframes of the parts of the movie that they
+    // have played; one of those who know the keyframe shares its position so
+    // that all show the same frame, otherwise the exact frame is decoded.
+    const auto keyframe = visible && _ffmpegMovie
+                              ? _ffmpegMovie->findKeyframe(_skipPosition)
+                              : -1.0;
+    const int leader = channel.electLeader(keyframe >= 0.0);
+    if (leader < 0)
+        return _skipPosition;
+
+    if (leader == channel.getRank())
+    {
+        channel.broadcast(keyframe);
+        return keyframe;
+    }
+    return channel.receiveTimestampBroadcast(leader);
+}
+
 void MovieUpdater::_exchangeSharedTimestamp(WallToWallChannel& channel,
                                             const bool isCandidate)
 {
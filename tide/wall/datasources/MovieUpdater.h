@@ -96,6 +96,9 @@ public:
     /** @copydoc DataSource::synchronizeFrameAdvance */
     void synchronizeFrameAdvance(WallToWallChannel& channel) final;
 
+    /** @copydoc DataSource::getTimeToNextFrame */
+    std::chrono::milliseconds getTimeToNextFrame() const final;
+
     /** @return current / max fps, movie position in percentage. */
     QString getStatistics() const;
 
@@ -117,6 +120,7 @@ signals:
 
 private:
     void _triggerFrameUpdate();
+    double _getSkipTarget(WallToWallChannel& channel, bool visible);
     void _exchangeSharedTimestamp(WallToWallChannel& channel, bool isCandidate);
 
     QString _uri;
@@ -125,6 +129,7 @@ private:
     bool _loop = true;
     bool _skipping = false;
     double _skipPosition = 0.0;
+    double _previewedSkipPosition = -1.0;
     // Received from master to avoid deadlocks that could occur if the code
     // path in synchronizeFrameAdvance would be different on a subset of wall
     // processes because _ffmpegMovie is invalid on those nodes.
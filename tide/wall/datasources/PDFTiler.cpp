@@ -45,14 +45,24 @@
 #include "utils/log.h"
 
 #include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
 
 namespace
 {
 // The main bottelneck of Poppler is the parsing done for every render call not
 // the rendering itself. See: https://bugzilla.gnome.org/show_bug.cgi?id=303365
 // Rendering a small tile takes almost as long a rendering the whole page, so
-// it is more optimal to use a large tile size.
+// it is more optimal to use a large tile size. For the same reason, the pages
+// are rendered in as few calls as possible and cut into tiles afterwards.
 const uint tileSize = 2048;
+
+// Larger pages are rendered in bands of tile rows (64 MB in RGB32)
+const qint64 maxRasterPixels = 16 * 1024 * 1024;
+
+// The current page at two LODs (preview + display) and the adjacent pages
+const size_t maxCachedRasters = 4;
 }
 
 PDFTiler::PDFTiler(const QString& uri, const QSize& maxImageSize)
@@ -70,9 +80,14 @@ PDFTiler::PDFTiler(const QString& uri, const QSize& maxImageSize)
                   uri.toLocal8Bit().constData(), e.what());
     }
     _tilesPerPage = _lodTool->getTilesCount();
+    _minRequestedLod = _lodTool->getMaxLod();
+    _prefetchPool.setMaxThreadCount(1);
 }
 
-PDFTiler::~PDFTiler() = default;
+PDFTiler::~PDFTiler()
+{
+    _prefetchPool.clear();
+}
 
 QString PDFTiler::getUri() const
 {
@@ -87,6 +102,7 @@ void PDFTiler::update(const Content& content)
     if (_currentPage != pdf.getPage())
     {
         _currentPage = pdf.getPage();
+        _prefetchAdjacentPages();
         emit pageChanged();
     }
 }
@@ -114,12 +130,16 @@ QImage PDFTiler::getCachableTileImage(const uint tileId,
 {
     Q_UNUSED(view);
 
-    auto& pdf = _getPdfForCurrentThread();
-    pdf.setPage(tileId / _tilesPerPage);
+    const auto page = int(tileId / _tilesPerPage);
+    const auto index = _lodTool->getTileIndex(tileId % _tilesPerPage);
+    const auto band = index.y / _getBandRows(index.lod);
 
-    const auto imageSize = getTileRect(tileId).size();
-    const auto region = LodTiler::getNormalizedTileRect(tileId % _tilesPerPage);
-    return pdf.renderToImage(imageSize, region);
+    const auto raster = _getRaster(RasterKey{page, index.lod, band}).get();
+    if (raster.isNull())
+        return raster;
+
+    const auto bandOrigin = _getBandRect(index.lod, band).topLeft();
+    return raster.copy(getTileRect(tileId).translated(-bandOrigin));
 }
 
 uint PDFTiler::getPreviewTileId() const
@@ -132,6 +152,110 @@ QString PDFTiler::getStatistics() const
     return QString("page %1/%2").arg(_currentPage + 1).arg(_pageCount);
 }
 
+PDFTiler::Raster PDFTiler::_getRaster(const RasterKey& key) const
+{
+    const QMutexLocker lock(&_rastersMutex);
+
+    _minRequestedLod = std::min(_minRequestedLod, std::get<1>(key));
+
+    const auto it = std::find_if(_rasters.begin(), _rasters.end(),
+                                 [&key](const auto& raster) {
+                                     return raster.first == key;
+                                 });
+    if (it != _rasters.end())
+    {
+        _rasters.splice(_rasters.begin(), _rasters, it);
+        return it->second;
+    }
+
+    // The first thread to get() the raster renders it, the others wait for it
+    auto raster = std::async(std::launch::deferred, [this, key] {
+                      return _renderRaster(key);
+                  }).share();
+
+    _rasters.emplace_front(key, raster);
+    if (_rasters.size() > maxCachedRasters)
+        _rasters.pop_back();
+
+    return raster;
+}
+
+QImage PDFTiler::_renderRaster(const RasterKey& key) const
+{
+    int page = 0;
+    uint lod = 0;
+    uint band = 0;
+    std::tie(page, lod, band) = key;
+
+    auto& pdf = _getPdfForCurrentThread();
+    pdf.setPage(page);
+
+    const auto rect = QRectF{_getBandRect(lod, band)};
+    const auto area = QSizeF{_lodTool->getTilesArea(lod)};
+    const auto t =
+        QTransform::fromScale(1.0 / area.width(), 1.0 / area.height());
+    return pdf.renderToImage(rect.size().toSize(), t.mapRect(rect));
+}
+
+uint PDFTiler::_getBandRows(const uint lod) const
+{
+    const auto tilesX = qint64(_lodTool->getTilesCount(lod).width());
+    const auto rowPixels = tilesX * tileSize * tileSize;
+    return std::max(qint64(1), maxRasterPixels / rowPixels);
+}
+
+uint PDFTiler::_getBandsCount(const uint lod) const
+{
+    const auto tilesY = uint(_lodTool->getTilesCount(lod).height());
+    const auto bandRows = _getBandRows(lod);
+    return (tilesY + bandRows - 1) / bandRows;
+}
+
+QRect PDFTiler::_getBandRect(const uint lod, const uint band) const
+{
+    const auto tilesCount = _lodTool->getTilesCount(lod);
+    const auto tilesX = uint(tilesCount.width());
+    const auto bandRows = _getBandRows(lod);
+    const auto firstRow = band * bandRows;
+    const auto endRow =
+        std::min(firstRow + bandRows, uint(tilesCount.height()));
+
+    const auto firstTileId = _lodTool->getFirstTileId(lod);
+    const auto topLeftTile = firstTileId + firstRow * tilesX;
+    const auto bottomRightTile = firstTileId + endRow * tilesX - 1;
+
+    return _lodTool->getTileCoord(topLeftTile)
+        .united(_lodTool->getTileCoord(bottomRightTile));
+}
+
+void PDFTiler::_prefetchAdjacentPages()
+{
+    // Requests for the previously adjacent pages are outdated
+    _prefetchPool.clear();
+
+    uint lod = 0;
+    {
+        const QMutexLocker lock(&_rastersMutex);
+        lod = _minRequestedLod;
+        _minRequestedLod = _lodTool->getMaxLod();
+    }
+    // Only prefetch pages which can be rendered in a single call
+    while (lod < _lodTool->getMaxLod() && _getBandsCount(lod) > 1)
+        ++lod;
+
+    for (auto page : {_currentPage + 1, _currentPage - 1})
+    {
+        if (page < 0 || page >= _pageCount)
+            continue;
+
+        const auto key = RasterKey{page, lod, 0};
+        QtConcurrent::run(&_prefetchPool, [this, key] {
+            QThread::currentThread()->setPriority(QThread::LowPriority);
+            _getRaster(key).wait();
+        });
+    }
+}
+
 PDF& PDFTiler::_getPdfForCurrentThread() const
 {
     const auto id = QThread::currentThreadId();
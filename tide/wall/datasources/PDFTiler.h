@@ -43,11 +43,20 @@
 #include "LodTiler.h"
 
 #include <QObject>
+#include <QThreadPool>
+
+#include <future>
+#include <list>
+#include <tuple>
 
 class PDF;
 
 /**
  * Represent a PDF document as a multi-LOD tiled data source.
+ *
+ * Pages are rendered once per LOD (in bands of tile rows if they are too
+ * large) and the tiles are cut from the cached rasters. The pages adjacent to
+ * the current one are pre-rendered in the background.
  */
 class PDFTiler : public QObject, public LodTiler
 {
@@ -87,9 +96,21 @@ signals:
 private:
     QImage getCachableTileImage(uint tileId, deflect::View view) const final;
     bool isStereo() const final { return false; }
+    bool isDiskCachable() const final { return true; }
     const LodTools& _getLodTool() const final { return *_lodTool; }
     PDF& _getPdfForCurrentThread() const;
 
+    /** Page, lod and band of a raster. */
+    using RasterKey = std::tuple<int, uint, uint>;
+    using Raster = std::shared_future<QImage>;
+
+    Raster _getRaster(const RasterKey& key) const;
+    QImage _renderRaster(const RasterKey& key) const;
+    uint _getBandRows(uint lod) const;
+    uint _getBandsCount(uint lod) const;
+    QRect _getBandRect(uint lod, uint band) const;
+    void _prefetchAdjacentPages();
+
     const QString _uri;
     std::unique_ptr<LodTools> _lodTool;
     uint _tilesPerPage;
@@ -98,6 +119,13 @@ private:
 
     mutable QMutex _threadMapMutex;
     mutable std::map<Qt::HANDLE, std::unique_ptr<PDF>> _perThreadPDF;
+
+    mutable QMutex _rastersMutex;
+    mutable std::list<std::pair<RasterKey, Raster>> _rasters; // MRU first
+    mutable uint _minRequestedLod = 0;
+
+    // Must be destroyed first to wait for running prefetch tasks
+    QThreadPool _prefetchPool;
 };
 
 #endif
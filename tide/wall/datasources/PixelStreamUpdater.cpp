@@ -64,19 +64,73 @@ void _splitByView(const deflect::server::Tiles& tiles,
 
 void _sortByChannelAndPosition(deflect::server::Tiles& tiles)
 {
-    std::sort(tiles.begin(), tiles.end(), [](const auto& t1, const auto& t2) {
+    const auto compare = [](const auto& t1, const auto& t2) {
         return t1.channel == t2.channel
                    ? (t1.y == t2.y ? t1.x < t2.x : t1.y < t2.y)
                    : t1.channel < t2.channel;
+    };
+    // Streamers usually send the tiles in order already
+    if (!std::is_sorted(tiles.begin(), tiles.end(), compare))
+        std::sort(tiles.begin(), tiles.end(), compare);
+}
+
+// Reuse the tiles of the previous frame (which may already be decoded) in place
+// of the new ones which still share the compressed payload of the last frame.
+// The compressed payloads of the new frame are kept for the next comparison.
+void _reuseUnchangedTiles(deflect::server::Tiles& tiles,
+                          std::vector<QByteArray>& previousPayloads,
+                          const deflect::server::Frame* previousFrame)
+{
+    const bool sameCount = previousFrame &&
+                           previousFrame->tiles.size() == tiles.size() &&
+                           previousPayloads.size() == tiles.size();
+
+    previousPayloads.resize(tiles.size());
+    for (size_t i = 0; i < tiles.size(); ++i)
+    {
+        auto& tile = tiles[i];
+        auto& payload = previousPayloads[i];
+        if (sameCount && tile.imageData.constData() == payload.constData())
+        {
+            const auto& previous = previousFrame->tiles[i];
+            if (previous.x == tile.x && previous.y == tile.y &&
+                previous.width == tile.width &&
+                previous.height == tile.height &&
+                previous.channel == tile.channel)
+            {
+                tile = previous;
+                continue;
+            }
+        }
+        payload = tile.imageData;
+    }
+}
+
+#if TIDE_USE_LIBJPEGTURBO
+// Scaling factors supported by libjpeg-turbo in the DCT domain: 1/2, 1/4, 1/8
+const uint maxScaleDivider = 8;
+
+// The scaled tiles must keep even dimensions for the subsampled chroma planes
+// to be aligned when the tiles are assembled.
+bool _canDecodeAtScale(const deflect::server::Tiles& tiles, const uint divider)
+{
+    return std::all_of(tiles.begin(), tiles.end(), [divider](const auto& t) {
+        return t.format == deflect::Format::jpeg &&
+               t.width % (2 * divider) == 0 && t.height % (2 * divider) == 0;
     });
 }
+#endif
+
+// Frames of each view being split + in use by the current frame processors
+const size_t maxPooledFrames = 4;
 }
 
+uint PixelStreamUpdater::_pipelineDepth = 2;
+
 PixelStreamUpdater::PixelStreamUpdater(const QString& uri)
     : _uri{uri}
+    , _framesPool{maxPooledFrames}
 {
-    _swapSyncFrame.setCallback(std::bind(&PixelStreamUpdater::_onFrameSwapped,
-                                         this, std::placeholders::_1));
 }
 
 PixelStreamUpdater::~PixelStreamUpdater()
@@ -123,6 +177,19 @@ ImagePtr PixelStreamUpdater::getTileImage(const uint tileIndex,
     }
 }
 
+Indices PixelStreamUpdater::getUnchangedTiles(const deflect::View view) const
+{
+    const QReadLocker frameLock(&_frameMutex);
+
+    if (!_processorLeft)
+        return Indices{};
+
+    const bool rightEye = view == deflect::View::right_eye;
+    const bool rightFrame = rightEye && !_frameRight->tiles.empty();
+    const auto& processor = rightFrame ? _processRight : _processorLeft;
+    return processor->getUnchangedTiles();
+}
+
 QRect PixelStreamUpdater::getTileRect(const uint tileIndex) const
 {
     if (!_processorLeft)
@@ -164,62 +231,218 @@ void PixelStreamUpdater::synchronizeFrameAdvance(WallToWallChannel& channel)
     if (!_readyToSwap)
         return;
 
-    const auto versionCheckFunc = std::bind(&WallToWallChannel::checkVersion,
-                                            &channel, std::placeholders::_1);
-    _swapSyncFrame.sync(versionCheckFunc);
+    // Swap to the most recent frame received by all the processes
+    swapToFrame(channel.globalMin(_receivedFramesCount));
+}
+
+void PixelStreamUpdater::swapToFrame(const uint64_t frameIndex)
+{
+    if (frameIndex == _swappedFrameIndex)
+        return;
+
+    // The frame counts of the processes differ if some of them dropped
+    // incomplete frames, in which case the frame may not be in the queue.
+    const auto firstQueuedIndex =
+        _receivedFramesCount + 1 - _receivedFrames.size();
+    if (frameIndex < firstQueuedIndex || frameIndex > _receivedFramesCount)
+    {
+        print_log(LOG_DEBUG, LOG_STREAM,
+                  "Frame %llu of stream %s is not queued (frames %llu-%llu)",
+                  (unsigned long long)frameIndex,
+                  _uri.toLocal8Bit().constData(),
+                  (unsigned long long)firstQueuedIndex,
+                  (unsigned long long)_receivedFramesCount);
+        return;
+    }
+
+    // Drop the older frames if the processes are falling behind
+    const auto staleFrames = frameIndex - firstQueuedIndex;
+    _receivedFrames.erase(_receivedFrames.begin(),
+                          _receivedFrames.begin() + staleFrames);
+
+    auto frame = std::move(_receivedFrames.front());
+    _receivedFrames.pop_front();
+    _swappedFrameIndex = frameIndex;
+
+    _onFrameSwapped(std::move(frame));
+}
+
+std::chrono::milliseconds PixelStreamUpdater::getTimeToNextFrame() const
+{
+    if (_readyToSwap && _receivedFramesCount > _swappedFrameIndex)
+        return std::chrono::milliseconds::zero();
+
+    // The tiles of the swapped frame are still being decoded and uploaded
+    if (!_readyToSwap && synchronizers.haveVisibleTiles())
+        return getPollInterval();
+
+    return std::chrono::milliseconds::max();
+}
+
+void PixelStreamUpdater::setDisplayScale(
+    const PixelStreamSynchronizer* synchronizer, const qreal scale)
+{
+    if (scale > 0.0)
+        _displayScales[synchronizer] = scale;
+    else
+        _displayScales.erase(synchronizer);
 }
 
 void PixelStreamUpdater::setNextFrame(deflect::server::FramePtr frame)
 {
     assert(frame->uri == getUri());
 
-    _swapSyncFrame.update(frame);
+    _requestPending = false;
+
+    // Frames must be processed in the order they were sent by the master
+    if (_tileCache.restoreUnchangedTiles(*frame))
+    {
+        _receivedFrames.push_back(std::move(frame));
+        ++_receivedFramesCount;
+    }
+    else
+    {
+        // The missing tiles were sent before this stream was (re)opened. The
+        // master transmits the frame which answers the opening request in full.
+        print_log(LOG_WARN, LOG_STREAM,
+                  "Dropping incomplete frame for stream %s",
+                  frame->uri.toLocal8Bit().constData());
+    }
+
+    _requestFrames();
+}
+
+void PixelStreamUpdater::setPipelineDepth(const uint depth)
+{
+    if (depth >= 1)
+        _pipelineDepth = depth;
+}
+
+uint PixelStreamUpdater::getPipelineDepth()
+{
+    return _pipelineDepth;
+}
+
+void PixelStreamUpdater::_requestFrames()
+{
+    // Requests are not cumulative, the server sends a single frame in reply
+    // to any number of requests made in the meantime.
+    if (_requestPending || _receivedFrames.size() >= _pipelineDepth)
+        return;
+
+    _requestPending = true;
+    emit requestFrame(_uri);
 }
 
 void PixelStreamUpdater::_onFrameSwapped(deflect::server::FramePtr frame)
 {
     _readyToSwap = false;
 
-    auto leftOrMono = std::make_shared<deflect::server::Frame>();
-    auto right = std::make_shared<deflect::server::Frame>();
+    // Recycled frames keep the capacity of their tiles vector
+    auto leftOrMono = _framesPool.acquire();
+    auto right = _framesPool.acquire();
+    leftOrMono->tiles.clear();
+    right->tiles.clear();
 
     _splitByView(frame->tiles, leftOrMono->tiles, right->tiles);
     _sortByChannelAndPosition(leftOrMono->tiles);
     _sortByChannelAndPosition(right->tiles);
 
+    const auto scaleDivider = _computeScaleDivider(frame->tiles);
+    const bool sameScale = scaleDivider == _scaleDivider;
+
     {
         const QWriteLocker frameLock(&_frameMutex);
+        // No tiles can be decoded concurrently while holding the write lock.
+        // Tiles decoded at a different scale can't be reused.
+        _reuseUnchangedTiles(leftOrMono->tiles, _payloadsLeftOrMono,
+                             sameScale ? _frameLeftOrMono.get() : nullptr);
+        _reuseUnchangedTiles(right->tiles, _payloadsRight,
+                             sameScale ? _frameRight.get() : nullptr);
         _frameLeftOrMono = std::move(leftOrMono);
         _frameRight = std::move(right);
+        if (!sameScale)
+        {
+            _scaleDivider = scaleDivider;
+            _processorLeft.reset();
+            _processRight.reset();
+        }
         _createFrameProcessors();
         _createPerTileMutexes();
     }
 
     emit pictureUpdated();
-    emit requestFrame(frame->uri);
+    _requestFrames();
+}
+
+uint PixelStreamUpdater::_computeScaleDivider(
+    const deflect::server::Tiles& tiles) const
+{
+#if TIDE_USE_LIBJPEGTURBO
+    const auto displayScale = _getDisplayScale();
+    for (auto divider = maxScaleDivider; divider > 1; divider /= 2)
+    {
+        if (displayScale * divider <= 1.0 && _canDecodeAtScale(tiles, divider))
+            return divider;
+    }
+#else
+    Q_UNUSED(tiles);
+#endif
+    return 1;
+}
+
+qreal PixelStreamUpdater::_getDisplayScale() const
+{
+    // Full resolution until the stream is displayed
+    qreal scale = 0.0;
+    for (const auto& request : _displayScales)
+        scale = std::max(scale, request.second);
+    return scale > 0.0 ? scale : 1.0;
 }
 
 void PixelStreamUpdater::_createFrameProcessors()
 {
+    if (_reuseFrameProcessors())
+        return;
+
     try
     {
         if (!_frameLeftOrMono->tiles.empty())
-            _processorLeft.reset(new PixelStreamAssembler(_frameLeftOrMono));
+            _processorLeft.reset(
+                new PixelStreamAssembler(_frameLeftOrMono, _scaleDivider));
         else
             _processorLeft.reset();
 
         if (!_frameRight->tiles.empty())
-            _processRight.reset(new PixelStreamAssembler(_frameRight));
+            _processRight.reset(
+                new PixelStreamAssembler(_frameRight, _scaleDivider));
         else
             _processRight.reset();
     }
     catch (const std::runtime_error&)
     {
-        _processorLeft.reset(new PixelStreamPassthrough(_frameLeftOrMono));
-        _processRight.reset(new PixelStreamPassthrough(_frameRight));
+        _processorLeft.reset(
+            new PixelStreamPassthrough(_frameLeftOrMono, _scaleDivider));
+        if (!_frameRight->tiles.empty())
+            _processRight.reset(
+                new PixelStreamPassthrough(_frameRight, _scaleDivider));
+        else
+            _processRight.reset();
     }
 }
 
+bool PixelStreamUpdater::_reuseFrameProcessors()
+{
+    const bool hasRight = !_frameRight->tiles.empty();
+    if (!_processorLeft || hasRight != bool(_processRight))
+        return false;
+
+    if (!_processorLeft->setFrame(_frameLeftOrMono))
+        return false;
+
+    return !hasRight || _processRight->setFrame(_frameRight);
+}
+
 void PixelStreamUpdater::_createPerTileMutexes()
 {
     const auto tiles = (_processorLeft ? _processorLeft->getTilesCount() : 0) +
@@ -43,15 +43,26 @@
 #include "types.h"
 
 #include "DataSource.h"
-#include "tools/SwapSyncObject.h"
+#include "network/PixelStreamTileCache.h"
+#include "tools/ObjectPool.h"
 
 #include <QObject>
 #include <QReadWriteLock>
 
+#include <deque>
+#include <map>
+
 class PixelStreamProcessor;
+class PixelStreamSynchronizer;
 
 /**
  * Synchronize the update of PixelStreams and send new frame requests.
+ *
+ * Up to getPipelineDepth() frames can be in flight, i.e. requested or received
+ * but not yet swapped, so that the frame rate is not bound by the round-trip
+ * latency to the master. The received frames are queued and all processes
+ * swap to the most recent frame that they have all received, dropping the
+ * older ones if they fall behind.
  */
 class PixelStreamUpdater : public QObject, public DataSource
 {
@@ -95,9 +106,55 @@ public:
     /** @copydoc DataSource::synchronizeFrameAdvance */
     void synchronizeFrameAdvance(WallToWallChannel& channel) final;
 
-    /** Set the frame to be rendered next. */
+    /**
+     * Swap to a received frame, dropping the older ones.
+     *
+     * Nothing happens if the frame is not queued, which is the case when the
+     * processes disagree on the frame count after one of them dropped an
+     * incomplete frame.
+     * @param frameIndex the 1-based index of the frame in the received frames,
+     *        normally the minimum across processes.
+     */
+    void swapToFrame(uint64_t frameIndex);
+
+    /** @copydoc DataSource::getTimeToNextFrame */
+    std::chrono::milliseconds getTimeToNextFrame() const final;
+
+    /**
+     * @return the tiles of the given view which did not change with the last
+     *         frame swap and do not need to be uploaded again.
+     */
+    Indices getUnchangedTiles(deflect::View view) const;
+
+    /**
+     * Set the scale at which a synchronizer displays the stream on screen.
+     *
+     * Starting with the next frame, the tiles are decoded at the lowest
+     * resolution that is sufficient for all the synchronizers.
+     * @param synchronizer which displays the stream.
+     * @param scale the on-screen size relative to the stream size, or 0 to
+     *        remove the synchronizer's request.
+     */
+    void setDisplayScale(const PixelStreamSynchronizer* synchronizer,
+                         qreal scale);
+
+    /**
+     * Set the frame to be rendered next.
+     *
+     * The payload of its unchanged tiles is restored from the previous frames,
+     * see PixelStreamTileCache.
+     */
     void setNextFrame(deflect::server::FramePtr frame);
 
+    /**
+     * Set the maximum number of frames in flight for each stream.
+     * @param depth number of frames, must be >= 1 (1 disables pipelining).
+     */
+    static void setPipelineDepth(uint depth);
+
+    /** @return the maximum number of frames in flight for each stream. */
+    static uint getPipelineDepth();
+
 signals:
     /** Emitted when a new picture has become available. */
     void pictureUpdated();
@@ -107,17 +164,32 @@ signals:
 
 private:
     QString _uri;
-    SwapSyncObject<deflect::server::FramePtr> _swapSyncFrame;
+    PixelStreamTileCache _tileCache;
+    std::deque<deflect::server::FramePtr> _receivedFrames;
+    uint64_t _receivedFramesCount = 0;
+    uint64_t _swappedFrameIndex = 0;
+    bool _requestPending = true; // first frame requested by the DataProvider
+    ObjectPool<deflect::server::Frame> _framesPool;
     deflect::server::FramePtr _frameLeftOrMono;
     deflect::server::FramePtr _frameRight;
+    std::vector<QByteArray> _payloadsLeftOrMono;
+    std::vector<QByteArray> _payloadsRight;
     std::unique_ptr<PixelStreamProcessor> _processorLeft;
     std::unique_ptr<PixelStreamProcessor> _processRight;
+    std::map<const PixelStreamSynchronizer*, qreal> _displayScales;
+    uint _scaleDivider = 1;
     mutable QReadWriteLock _frameMutex;
     mutable std::unique_ptr<std::vector<std::mutex>> _perTileLock;
     bool _readyToSwap = true;
 
+    static uint _pipelineDepth;
+
+    void _requestFrames();
     void _onFrameSwapped(deflect::server::FramePtr frame);
+    uint _computeScaleDivider(const deflect::server::Tiles& tiles) const;
+    qreal _getDisplayScale() const;
     void _createFrameProcessors();
+    bool _reuseFrameProcessors();
     void _createPerTileMutexes();
 };
 
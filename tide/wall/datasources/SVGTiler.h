@@ -78,6 +78,7 @@ private:
      */
     QImage getCachableTileImage(uint tileId, deflect::View view) const final;
     bool isStereo() const final { return false; }
+    bool isDiskCachable() const final { return true; }
     const LodTools& _getLodTool() const final { return *_lodTool; }
     SVG& _getSvgForCurrentThread() const;
 
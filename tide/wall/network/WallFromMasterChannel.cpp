@@ -94,7 +94,7 @@ void WallFromMasterChannel::receiveMessage()
         emit received(receiveQObjectBroadcast<ScreenLockPtr>(mh.size));
         break;
     case MessageType::MARKERS:
-        emit received(receiveQObjectBroadcast<MarkersPtr>(mh.size));
+        emit received(receiveMarkers(mh.size));
         break;
     case MessageType::COUNTDOWN_STATUS:
         emit received(receiveQObjectBroadcast<CountdownStatusPtr>(mh.size));
@@ -112,7 +112,8 @@ void WallFromMasterChannel::receiveMessage()
 #endif
         break;
     case MessageType::IMAGE:
-        emit receivedScreenshotRequest();
+        emit receivedScreenshotRequest(
+            receiveBinaryBroadcast<double>(mh.size));
         break;
     case MessageType::QUIT:
         _processMessages = false;
@@ -147,6 +148,22 @@ T WallFromMasterChannel::receiveJsonBroadcast(const size_t messageSize)
     return json::unpack<T>(data);
 }
 
+MarkersPtr WallFromMasterChannel::receiveMarkers(const size_t messageSize)
+{
+    receiveBroadcast(messageSize);
+    const auto changes = std::string(_buffer.data(), _buffer.size());
+
+    const auto surfaceIndex = Markers::decodeSurfaceIndex(changes);
+    auto& markers = _markers[surfaceIndex];
+    if (!markers)
+        markers = Markers::create(surfaceIndex);
+
+    // Keep the previous markers unmodified, they may be in use for rendering
+    markers = markers->copyWithChanges(changes);
+    markers->moveToThread(QApplication::instance()->thread());
+    return markers;
+}
+
 template <typename T>
 T WallFromMasterChannel::receiveQObjectBroadcast(const size_t messageSize)
 {
@@ -45,6 +45,8 @@
 
 #include <QObject>
 
+#include <map>
+
 /**
  * Receiving channel from the master application to the wall processes.
  */
@@ -108,8 +110,9 @@ signals:
 
     /**
      * Emitted when a screenshot was requested.
+     * @param scale of the images to send back.
      */
-    void receivedScreenshotRequest();
+    void receivedScreenshotRequest(double scale);
 
     /**
      * Emitted when the quit message was recieved.
@@ -120,8 +123,10 @@ private:
     MPICommunicator& _communicator;
     ReceiveBuffer _buffer;
     bool _processMessages = true;
+    std::map<size_t, MarkersPtr> _markers;
 
     void receiveMessage();
+    MarkersPtr receiveMarkers(size_t messageSize);
 
     void receiveBroadcast(const size_t messageSize);
     template <typename T>
@@ -42,15 +42,45 @@
 
 #include "network/MPICommunicator.h"
 #include "serialization/utils.h"
+#include "tools/TileDiskCache.h"
+
+#include <QBuffer>
 
 WallToMasterChannel::WallToMasterChannel(MPICommunicator& communicator)
     : _communicator{communicator}
 {
 }
 
-void WallToMasterChannel::sendScreenshot(const QImage image, const QPoint index)
+namespace
+{
+// Qt maps PNG quality 90 to zlib level 1. Screenshots are encoded on demand
+// and read once by the master, so only the encoding latency matters.
+const int pngQuality = 90;
+
+QByteArray _compress(const QImage& image, const double scale)
 {
-    const auto data = serialization::toBinary(image, index);
+    auto scaled = image;
+    if (scale < 1.0)
+    {
+        const auto size = QSize{std::max(qRound(image.width() * scale), 1),
+                                std::max(qRound(image.height() * scale), 1)};
+        scaled = image.scaled(size, Qt::IgnoreAspectRatio,
+                              Qt::SmoothTransformation);
+    }
+
+    QByteArray data;
+    QBuffer buffer{&data};
+    buffer.open(QIODevice::WriteOnly);
+    scaled.save(&buffer, "PNG", pngQuality);
+    return data;
+}
+}
+
+void WallToMasterChannel::sendScreenshot(const QImage image, const QPoint index,
+                                         const double scale)
+{
+    const auto compressed = _compress(image, scale);
+    const auto data = serialization::toBinary(compressed, index);
     _communicator.send(MessageType::IMAGE, data, 0);
 }
 
@@ -60,12 +90,33 @@ void WallToMasterChannel::sendRequestFrame(const QString uri)
     _communicator.send(MessageType::REQUEST_FRAME, data, 0);
 }
 
+void WallToMasterChannel::sendPixelStreamOpen(const QString uri)
+{
+    const auto data = serialization::toBinary(uri);
+    _communicator.send(MessageType::PIXELSTREAM_OPEN, data, 0);
+}
+
 void WallToMasterChannel::sendPixelStreamClose(const QString uri)
 {
     const auto data = serialization::toBinary(uri);
     _communicator.send(MessageType::PIXELSTREAM_CLOSE, data, 0);
 }
 
+void WallToMasterChannel::sendTileCacheStatistics()
+{
+    const auto cache = TileDiskCache::getInstance();
+    if (!cache)
+        return;
+
+    const auto stats = cache->getStatistics();
+    if (stats == _tileCacheStatistics)
+        return;
+
+    _tileCacheStatistics = stats;
+    const auto data = serialization::toBinary(stats);
+    _communicator.send(MessageType::TILE_CACHE_STATISTICS, data, 0);
+}
+
 void WallToMasterChannel::sendQuit()
 {
     _communicator.send(MessageType::QUIT, "", 0);
@@ -41,6 +41,7 @@
 #ifndef WALLTOMASTERCHANNEL_H
 #define WALLTOMASTERCHANNEL_H
 
+#include "data/TileCacheStatistics.h"
 #include "types.h"
 
 #include <QImage> // needed by moc compiler on Travis OSX
@@ -65,6 +66,13 @@ public slots:
      */
     void sendRequestFrame(QString uri);
 
+    /**
+     * Notify the master application that a pixel stream was opened and does
+     * not have any previous frame yet.
+     * @param uri The URI of the pixel stream
+     */
+    void sendPixelStreamOpen(QString uri);
+
     /**
      * Send a request to the master application to close the given pixel stream.
      * @param uri The URI of the pixel stream
@@ -72,11 +80,18 @@ public slots:
     void sendPixelStreamClose(QString uri);
 
     /**
-     * Send a screenshot to the master application
+     * Compress and send a screenshot to the master application
      * @param image the rendered image
      * @param index the global index of the window sending the image
+     * @param scale to apply to the image before sending it, in ]0, 1]
+     */
+    void sendScreenshot(QImage image, QPoint index, double scale);
+
+    /**
+     * Send the statistics of the TileDiskCache if they changed since the last
+     * call.
      */
-    void sendScreenshot(QImage image, QPoint index);
+    void sendTileCacheStatistics();
 
     /**
      * Send quit message to the master application to stop the receiver.
@@ -85,6 +100,7 @@ public slots:
 
 private:
     MPICommunicator& _communicator;
+    TileCacheStatistics _tileCacheStatistics;
 };
 
 #endif
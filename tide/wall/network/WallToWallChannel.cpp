@@ -44,6 +44,8 @@
 #include "serialization/utils.h"
 #include "utils/log.h"
 
+#include <algorithm>
+
 #define RANK0 0
 
 WallToWallChannel::WallToWallChannel(MPICommunicator& communicator)
@@ -61,6 +63,12 @@ int WallToWallChannel::globalSum(const int localValue) const
     return _communicator.globalSum(localValue);
 }
 
+uint64_t WallToWallChannel::globalMin(const uint64_t localValue) const
+{
+    const auto values = _communicator.gatherAll(localValue);
+    return *std::min_element(values.begin(), values.end());
+}
+
 bool WallToWallChannel::allReady(const bool isReady) const
 {
     return _communicator.globalSum(isReady ? 1 : 0) == _communicator.getSize();
@@ -71,6 +71,13 @@ public:
      */
     int globalSum(int localValue) const;
 
+    /**
+     * Get the minimum of the given local values across all processes.
+     * @param localValue The value to compare
+     * @return the minimum of the localValues
+     */
+    uint64_t globalMin(uint64_t localValue) const;
+
     /** Check if all processes are ready to perform a common action. */
     bool allReady(bool isReady) const;
 
@@ -0,0 +1,302 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "SharedTextures.h"
+
+#include <algorithm>
+
+SharedTextures::SharedTextures(const size_t maxPooledTextures)
+    : _maxPooledTextures{maxPooledTextures}
+{
+}
+
+SharedTextures::Texture SharedTextures::acquire(const ImagePtr& image,
+                                                const uint plane,
+                                                const bool mipmaps)
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    const auto it = _find(image, plane, mipmaps, false);
+    if (it == _records.end())
+        return Texture();
+
+    ++it->second.references;
+    return Texture{it->first.first, it->second.mipmaps, it->second.fence};
+}
+
+SharedTextures::Layer SharedTextures::acquireLayer(const ImagePtr& image)
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    const auto it = _find(image, 0, true, true);
+    if (it == _records.end())
+        return Layer();
+
+    ++it->second.references;
+    return Layer{it->second.array, it->first.second, it->second.fence};
+}
+
+bool SharedTextures::contains(const Image& image) const
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    for (const auto& entry : _records)
+    {
+        for (const auto& source : entry.second.sources)
+        {
+            if (source.image.lock().get() == &image)
+                return true;
+        }
+    }
+    return false;
+}
+
+void SharedTextures::add(const ImagePtr& image, const uint plane,
+                         const Texture& texture)
+{
+    Record record;
+    record.mipmaps = texture.mipmaps;
+    record.fence = texture.fence;
+
+    const std::lock_guard<std::mutex> lock{_mutex};
+    _add({texture.id, 0}, image, plane, record);
+}
+
+void SharedTextures::addLayer(const ImagePtr& image, const Layer& layer)
+{
+    Record record;
+    record.mipmaps = true;
+    record.fence = layer.fence;
+    record.array = layer.array;
+
+    const std::lock_guard<std::mutex> lock{_mutex};
+    _add({layer.array->getTextureId(), layer.index}, image, 0, record);
+}
+
+bool SharedTextures::claim(const uint textureId)
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    return _claim({textureId, 0});
+}
+
+bool SharedTextures::claimLayer(const uint textureId, const uint index)
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    return _claim({textureId, index});
+}
+
+bool SharedTextures::release(const uint textureId, void* fence)
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    return _release({textureId, 0}, fence);
+}
+
+bool SharedTextures::releaseLayer(const uint textureId, const uint index,
+                                  void* fence)
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    return _release({textureId, index}, fence);
+}
+
+std::vector<void*> SharedTextures::takeReleaseFences(const uint textureId,
+                                                     const uint index)
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    const auto it = _releaseFences.find({textureId, index});
+    if (it == _releaseFences.end())
+        return {};
+
+    auto fences = std::move(it->second);
+    _releaseFences.erase(it);
+    return fences;
+}
+
+void SharedTextures::expireReleaseFences(const uint textureId)
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    _expireReleaseFences(textureId);
+}
+
+uint SharedTextures::takePooledTexture(const QSize& size,
+                                       const uint internalFormat)
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    const auto it = std::find_if(_pool.begin(), _pool.end(),
+                                 [&](const PooledTexture& texture) {
+                                     return texture.size == size &&
+                                            texture.internalFormat ==
+                                                internalFormat;
+                                 });
+    if (it == _pool.end())
+        return 0;
+
+    const auto id = it->id;
+    _pool.erase(it);
+    return id;
+}
+
+uint SharedTextures::poolTexture(const uint textureId, const QSize& size,
+                                 const uint internalFormat)
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    _pool.push_back({textureId, size, internalFormat});
+    if (_pool.size() <= _maxPooledTextures)
+        return 0;
+
+    const auto oldest = _pool.front().id;
+    _pool.pop_front();
+    _expireReleaseFences(oldest);
+    return oldest;
+}
+
+size_t SharedTextures::getPooledTexturesCount() const
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    return _pool.size();
+}
+
+std::vector<uint> SharedTextures::takePooledTextures()
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    std::vector<uint> textures;
+    for (const auto& texture : _pool)
+    {
+        textures.push_back(texture.id);
+        _expireReleaseFences(texture.id);
+    }
+    _pool.clear();
+    return textures;
+}
+
+std::vector<void*> SharedTextures::takeExpiredFences()
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    std::vector<void*> fences;
+    fences.swap(_expiredFences);
+    return fences;
+}
+
+std::map<SharedTextures::Key, SharedTextures::Record>::iterator
+    SharedTextures::_find(const ImagePtr& image, const uint plane,
+                          const bool mipmaps, const bool layer)
+{
+    for (auto entry = _records.begin(); entry != _records.end(); ++entry)
+    {
+        auto& record = entry->second;
+        auto& sources = record.sources;
+        sources.erase(std::remove_if(sources.begin(), sources.end(),
+                                     [](const Source& source) {
+                                         return source.image.expired();
+                                     }),
+                      sources.end());
+
+        if (layer != bool(record.array) || (mipmaps && !record.mipmaps))
+            continue;
+
+        const auto it = std::find_if(sources.begin(), sources.end(),
+                                     [&](const Source& source) {
+                                         return source.plane == plane &&
+                                                source.image.lock() == image;
+                                     });
+        if (it != sources.end())
+            return entry;
+    }
+    return _records.end();
+}
+
+void SharedTextures::_add(const Key& key, const ImagePtr& image,
+                          const uint plane, const Record& added)
+{
+    auto& record = _records[key];
+    record.references = std::max(record.references, size_t(1));
+    record.mipmaps = added.mipmaps;
+    record.array = added.array;
+    if (record.fence != added.fence)
+    {
+        _expireFence(record);
+        record.fence = added.fence;
+    }
+    record.sources = {Source{image, plane}};
+}
+
+bool SharedTextures::_claim(const Key& key)
+{
+    const auto it = _records.find(key);
+    if (it == _records.end())
+        return true;
+
+    if (it->second.references > 1)
+        return false;
+
+    it->second.sources.clear();
+    return true;
+}
+
+bool SharedTextures::_release(const Key& key, void* fence)
+{
+    // The next writer may be another user, whether or not this one was last
+    if (fence)
+        _releaseFences[key].push_back(fence);
+
+    const auto it = _records.find(key);
+    if (it == _records.end())
+        return false;
+
+    if (--it->second.references > 0)
+        return true;
+
+    _expireFence(it->second);
+    _records.erase(it);
+    return false;
+}
+
+void SharedTextures::_expireFence(Record& record)
+{
+    if (record.fence)
+        _expiredFences.push_back(record.fence);
+    record.fence = nullptr;
+}
+
+void SharedTextures::_expireReleaseFences(const uint textureId)
+{
+    auto it = _releaseFences.lower_bound({textureId, 0});
+    while (it != _releaseFences.end() && it->first.first == textureId)
+    {
+        _expiredFences.insert(_expiredFences.end(), it->second.begin(),
+                              it->second.end());
+        it = _releaseFences.erase(it);
+    }
+}
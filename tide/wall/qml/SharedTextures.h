@@ -0,0 +1,246 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef SHAREDTEXTURES_H
+#define SHAREDTEXTURES_H
+
+#include "types.h"
+
+#include "TextureArray.h"
+
+#include <QSize>
+
+#include <deque>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * The textures of the OpenGL contexts of a share group.
+ *
+ * The screens of a wall process render the same images, for instance the tiles
+ * which span several screens or the frames of a movie. When their contexts
+ * share objects, an image plane uploaded by one context is registered here and
+ * sampled by the others instead of being uploaded again. The static tiles
+ * uploaded to a layer of a TextureArray are shared in the same way.
+ *
+ * Textures and layers are reference counted by their users. They can only be
+ * written again by a user which holds the only reference, see claim().
+ *
+ * The released textures of all contexts of the group go to a common pool, so
+ * that a texture released by one screen can be reused by another one. A user
+ * which releases a texture or a layer may still be sampling it on the GPU: it
+ * leaves a fence which the next writer waits on, see takeReleaseFences().
+ *
+ * The class does not call OpenGL, the textures and fences which should be
+ * deleted are returned to the caller. All methods are thread-safe.
+ */
+class SharedTextures
+{
+public:
+    /** A texture holding an image plane. */
+    struct Texture
+    {
+        uint id = 0;
+        bool mipmaps = false;
+        void* fence = nullptr; // signaled when the upload is complete
+    };
+
+    /** A layer of a texture array holding an image. */
+    struct Layer
+    {
+        TextureArrayPtr array;
+        uint index = 0;
+        void* fence = nullptr; // signaled when the upload is complete
+    };
+
+    /**
+     * Create the textures of a share group.
+     * @param maxPooledTextures released textures beyond this count are deleted
+     */
+    explicit SharedTextures(size_t maxPooledTextures = 64);
+
+    /**
+     * Get the texture of an image plane uploaded by another user.
+     * @param image the source image
+     * @param plane the texture plane of the source image
+     * @param mipmaps true if the texture must have mipmaps
+     * @return the texture, referenced by the caller until released, or a
+     *         texture with a null id if there is none.
+     */
+    Texture acquire(const ImagePtr& image, uint plane, bool mipmaps);
+
+    /**
+     * Get the texture array layer of an image uploaded by another user.
+     * @param image the source image
+     * @return the layer, referenced by the caller until released, or a layer
+     *         with a null array if there is none.
+     */
+    Layer acquireLayer(const ImagePtr& image);
+
+    /** @return true if an image has a texture or a layer. */
+    bool contains(const Image& image) const;
+
+    /**
+     * Register the texture holding an image plane.
+     *
+     * The texture is referenced by the caller, and forgotten when the image is
+     * destroyed or when the texture is claimed for a new upload.
+     * @param image the source image
+     * @param plane the texture plane of the source image
+     * @param texture the texture, with a fence which was flushed
+     */
+    void add(const ImagePtr& image, uint plane, const Texture& texture);
+
+    /**
+     * Register the texture array layer holding an image.
+     *
+     * Same as add(), the layer is referenced by the caller.
+     * @param image the source image
+     * @param layer the layer, with its mipmaps and a fence which was flushed
+     */
+    void addLayer(const ImagePtr& image, const Layer& layer);
+
+    /**
+     * Claim a texture of the caller before writing it again.
+     * @param textureId the texture
+     * @return true if the caller is the only user of the texture, which is no
+     *         longer shared until it is added again.
+     */
+    bool claim(uint textureId);
+
+    /** Claim a texture array layer, same as claim(). */
+    bool claimLayer(uint textureId, uint index);
+
+    /**
+     * Release the reference of the caller to a texture.
+     * @param textureId the texture
+     * @param fence signaled when the caller no longer samples the texture, or
+     *        null if the next writer does not need to wait for the caller
+     * @return true if the texture is still used by others.
+     */
+    bool release(uint textureId, void* fence = nullptr);
+
+    /** Release a texture array layer, same as release(). */
+    bool releaseLayer(uint textureId, uint index, void* fence = nullptr);
+
+    /**
+     * Take the fences of the previous users of a texture before writing it.
+     *
+     * The caller must wait for the fences and delete them.
+     * @param textureId the texture, claimed or taken from the pool
+     * @param index the layer of a texture array, 0 for a texture
+     * @return the fences left by release() or releaseLayer()
+     */
+    std::vector<void*> takeReleaseFences(uint textureId, uint index = 0);
+
+    /**
+     * Expire the release fences of a texture which is deleted.
+     * @param textureId the texture or texture array
+     */
+    void expireReleaseFences(uint textureId);
+
+    /**
+     * Take a texture from the pool.
+     * @param size of the texture
+     * @param internalFormat of the texture (GL_R8 or GL_RGBA8)
+     * @return the texture, or 0 if there is none of this size and format.
+     */
+    uint takePooledTexture(const QSize& size, uint internalFormat);
+
+    /**
+     * Put a texture in the pool.
+     * @param textureId the texture
+     * @param size of the texture
+     * @param internalFormat of the texture (GL_R8 or GL_RGBA8)
+     * @return the oldest texture which must be deleted if the pool is full,
+     *         otherwise 0.
+     */
+    uint poolTexture(uint textureId, const QSize& size, uint internalFormat);
+
+    /** @return the number of textures in the pool. */
+    size_t getPooledTexturesCount() const;
+
+    /** @return the textures of the pool, which is emptied. */
+    std::vector<uint> takePooledTextures();
+
+    /** @return the fences which are no longer used and should be deleted. */
+    std::vector<void*> takeExpiredFences();
+
+private:
+    struct Source
+    {
+        std::weak_ptr<Image> image;
+        uint plane;
+    };
+    struct Record
+    {
+        size_t references = 0;
+        bool mipmaps = false;
+        void* fence = nullptr;
+        TextureArrayPtr array; // only for the layers of a texture array
+        std::vector<Source> sources;
+    };
+    using Key = std::pair<uint, uint>; // texture, layer of a texture array
+    struct PooledTexture
+    {
+        uint id;
+        QSize size;
+        uint internalFormat;
+    };
+
+    mutable std::mutex _mutex;
+    std::map<Key, Record> _records;
+    std::map<Key, std::vector<void*>> _releaseFences;
+    std::deque<PooledTexture> _pool;
+    const size_t _maxPooledTextures;
+    std::vector<void*> _expiredFences;
+
+    std::map<Key, Record>::iterator _find(const ImagePtr& image, uint plane,
+                                          bool mipmaps, bool layer);
+    void _add(const Key& key, const ImagePtr& image, uint plane,
+              const Record& record);
+    bool _claim(const Key& key);
+    bool _release(const Key& key, void* fence);
+    void _expireFence(Record& record);
+    void _expireReleaseFences(uint textureId);
+};
+
+#endif
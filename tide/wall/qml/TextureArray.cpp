@@ -0,0 +1,199 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "TextureArray.h"
+
+#include "TextureUploader.h"
+
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+
+#include <algorithm>
+#include <utility> // std::exchange
+
+#ifndef GL_TEXTURE_2D_ARRAY
+#define GL_TEXTURE_2D_ARRAY 0x8C1A
+#endif
+
+TextureArray::TextureArray(const uint textureId, const QSize& size,
+                           const uint layers, const uint compressedFormat)
+    : _textureId{textureId}
+    , _size{size}
+    , _layers{layers}
+    , _compressedFormat{compressedFormat}
+    , _context{QOpenGLContext::currentContext()}
+{
+    // Allocate the lowest indices first
+    for (auto i = layers; i > 0; --i)
+        _freeLayers.push_back(i - 1);
+}
+
+TextureArray::~TextureArray()
+{
+    // Without the context, the texture is released along with it
+    if (auto context = QOpenGLContext::currentContext())
+        context->functions()->glDeleteTextures(1, &_textureId);
+}
+
+uint TextureArray::getTextureId() const
+{
+    return _textureId;
+}
+
+const QOpenGLContext* TextureArray::getContext() const
+{
+    return _context;
+}
+
+const QSize& TextureArray::getSize() const
+{
+    return _size;
+}
+
+uint TextureArray::getCompressedFormat() const
+{
+    return _compressedFormat;
+}
+
+bool TextureArray::hasAlphaChannel() const
+{
+    // Same as textureUtils: compressed textures use the opaque DXT1 format
+    return _compressedFormat == 0;
+}
+
+uint TextureArray::getUsedLayers() const
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    return _layers - _freeLayers.size();
+}
+
+bool TextureArray::isFull() const
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    return _freeLayers.empty();
+}
+
+uint TextureArray::acquireLayer()
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    if (_freeLayers.empty())
+        throw std::runtime_error("texture array is full");
+
+    const auto index = _freeLayers.back();
+    _freeLayers.pop_back();
+    return index;
+}
+
+void TextureArray::releaseLayer(const uint index)
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    _freeLayers.push_back(index);
+
+    // The mipmaps of a free layer are not needed until its next upload
+    _outdatedLayers.erase(std::remove(_outdatedLayers.begin(),
+                                      _outdatedLayers.end(), index),
+                          _outdatedLayers.end());
+}
+
+void TextureArray::invalidateMipmaps(const uint index)
+{
+    // OpenGL can not generate the mipmaps of compressed textures
+    if (_compressedFormat != 0)
+        return;
+
+    const std::lock_guard<std::mutex> lock{_mutex};
+    if (std::find(_outdatedLayers.begin(), _outdatedLayers.end(), index) ==
+        _outdatedLayers.end())
+    {
+        _outdatedLayers.push_back(index);
+    }
+}
+
+std::vector<uint> TextureArray::takeOutdatedLayers()
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    return std::exchange(_outdatedLayers, std::vector<uint>());
+}
+
+void TextureArray::bind()
+{
+    // The other contexts only sample layers shared with their mipmaps
+    if (QOpenGLContext::currentContext() == _context && _hasOutdatedLayers())
+        TextureUploader::current().generateMipmaps(*this);
+
+    auto gl = QOpenGLContext::currentContext()->functions();
+    gl->glBindTexture(GL_TEXTURE_2D_ARRAY, _textureId);
+    ++_binds;
+}
+
+size_t TextureArray::takeBindCount()
+{
+    return _binds.exchange(0);
+}
+
+bool TextureArray::_hasOutdatedLayers() const
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    return !_outdatedLayers.empty();
+}
+
+TextureLayer::TextureLayer(TextureArrayPtr array, const uint index)
+    : _array{std::move(array)}
+    , _index{index}
+{
+}
+
+TextureLayer::~TextureLayer()
+{
+    // Layers are only shared by rendering contexts, which have an uploader
+    if (auto uploader = TextureUploader::find())
+        uploader->releaseLayer(*_array, _index);
+    else
+        _array->releaseLayer(_index);
+}
+
+const TextureArrayPtr& TextureLayer::getArray() const
+{
+    return _array;
+}
+
+uint TextureLayer::getIndex() const
+{
+    return _index;
+}
@@ -0,0 +1,178 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef TEXTUREARRAY_H
+#define TEXTUREARRAY_H
+
+#include "types.h"
+
+#include <QSize>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class QOpenGLContext;
+class TextureArray;
+using TextureArrayPtr = std::shared_ptr<TextureArray>;
+
+/**
+ * A 2D texture array with layers of the same size and format.
+ *
+ * The layers are either uncompressed RGBA or compressed (BC1, opaque), as set
+ * on construction; tiles of each kind are allocated to arrays of that kind.
+ * All the nodes drawing from the same array share an equal material, which
+ * lets the scene graph renderer merge them in a single draw call instead of
+ * one per tile.
+ *
+ * The mipmaps of RGBA layers are generated lazily on the first bind() after an
+ * upload, only for the layers uploaded since the previous bind(). Compressed
+ * layers can not be generated on the GPU, they receive the mipmaps of each
+ * image with its upload instead, and have no alpha channel.
+ *
+ * Only the context which created the array allocates, uploads and generates
+ * its layers. The layers can be shared with the other contexts of its share
+ * group, which sample them and may release them: the methods are thread-safe.
+ */
+class TextureArray
+{
+public:
+    /**
+     * Take ownership of an array texture of the current context.
+     * @param textureId the GL_TEXTURE_2D_ARRAY texture
+     * @param size of each layer
+     * @param layers the number of layers of the texture
+     * @param compressedFormat the OpenGL compressed format of the layers, or 0
+     *        for RGBA layers
+     */
+    TextureArray(uint textureId, const QSize& size, uint layers,
+                 uint compressedFormat = 0);
+
+    /** Delete the texture, if its OpenGL context is current. */
+    ~TextureArray();
+
+    /** @return the OpenGL texture. */
+    uint getTextureId() const;
+
+    /** @return the context which writes the layers of the array. */
+    const QOpenGLContext* getContext() const;
+
+    /** @return the size of each layer. */
+    const QSize& getSize() const;
+
+    /** @return the compressed format of the layers, 0 for RGBA layers. */
+    uint getCompressedFormat() const;
+
+    /** @return true if the layers have an alpha channel (RGBA layers). */
+    bool hasAlphaChannel() const;
+
+    /** @return the number of layers in use. */
+    uint getUsedLayers() const;
+
+    /** @return true if all layers are in use. */
+    bool isFull() const;
+
+    /**
+     * Allocate a free layer.
+     * @return the index of the layer
+     * @throw std::runtime_error if the array is full
+     */
+    uint acquireLayer();
+
+    /** Return a layer to the array. */
+    void releaseLayer(uint index);
+
+    /** Mark the mipmaps of a layer as outdated after its upload. */
+    void invalidateMipmaps(uint index);
+
+    /** @return the layers with outdated mipmaps, which are now marked valid. */
+    std::vector<uint> takeOutdatedLayers();
+
+    /**
+     * Bind to the active texture unit, generating outdated mipmaps first if
+     * called from the context of the array.
+     */
+    void bind();
+
+    /** @return the number of calls to bind() since the previous call. */
+    size_t takeBindCount();
+
+private:
+    const uint _textureId;
+    const QSize _size;
+    const uint _layers;
+    const uint _compressedFormat;
+    const QOpenGLContext* const _context;
+
+    mutable std::mutex _mutex;
+    std::vector<uint> _freeLayers;
+    std::vector<uint> _outdatedLayers;
+    std::atomic<size_t> _binds{0};
+
+    bool _hasOutdatedLayers() const;
+};
+
+/**
+ * A reference to a layer of a TextureArray.
+ *
+ * The layer is returned to the array when its last reference is destroyed,
+ * see TextureUploader::releaseLayer().
+ */
+class TextureLayer
+{
+public:
+    TextureLayer(TextureArrayPtr array, uint index);
+    ~TextureLayer();
+
+    /** @return the array of the layer. */
+    const TextureArrayPtr& getArray() const;
+
+    /** @return the index of the layer in its array. */
+    uint getIndex() const;
+
+private:
+    Q_DISABLE_COPY(TextureLayer)
+
+    TextureArrayPtr _array;
+    const uint _index;
+};
+using TextureLayerPtr = std::unique_ptr<TextureLayer>;
+
+#endif
@@ -75,6 +75,13 @@ void TextureBorderSwitcher::updateBorderNode(TextureNode& textureNode)
     }
 }
 
+void TextureBorderSwitcher::reset()
+{
+    TextureSwitcher::reset();
+    showBorder = false;
+    _border = nullptr; // deleted along with its parent node
+}
+
 void TextureBorderSwitcher::aboutToSwitch(TextureNode& oldNode,
                                           TextureNode& newNode)
 {
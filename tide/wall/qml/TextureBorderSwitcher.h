@@ -53,6 +53,9 @@ public:
     bool showBorder = false;
     void updateBorderNode(TextureNode& parentNode);
 
+    /** @copydoc TextureSwitcher::reset */
+    void reset() final;
+
 private:
     QuadLineNode* _border = nullptr; // QObject ref
     void aboutToSwitch(TextureNode& oldNode, TextureNode& newNode) final;
@@ -56,10 +56,22 @@ public:
     /** Set the surface of the node. */
     virtual void setCoord(const QRectF& coord) = 0;
 
-    /** Upload the given image to the back PBO. */
-    virtual void uploadTexture(const Image& image) = 0;
+    /**
+     * Set the size of the node on screen in pixels, which determines if the
+     * next uploads of a dynamic texture need mipmaps. The mipmaps of the
+     * current texture are generated if it becomes minified without them.
+     */
+    virtual void setScreenSize(const QSizeF& size) = 0;
 
-    /** Swap the PBOs and update the texture with the back PBO's contents. */
+    /**
+     * Upload the given image to the back texture.
+     *
+     * The image is shared so that its texture can be reused by the other
+     * screens of the process instead of being uploaded again.
+     */
+    virtual void uploadTexture(const ImagePtr& image) = 0;
+
+    /** Swap the front and back textures. */
     virtual void swap() = 0;
 };
 
@@ -0,0 +1,267 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "TextureNodeArray.h"
+
+#include "TextureUploader.h"
+#include "textureUtils.h"
+#include "data/Image.h"
+
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QSGMaterial>
+
+#ifndef GL_TEXTURE_2D_ARRAY
+#define GL_TEXTURE_2D_ARRAY 0x8C1A
+#endif
+
+namespace
+{
+// Texture arrays need GLSL 1.30 (OpenGL 3.0)
+const char* vertShader =
+    R"(
+#version 130
+uniform highp mat4 qt_Matrix;
+in highp vec4 aVertex;
+in highp vec3 aTexCoord;
+out vec3 vTexCoord;
+void main() {
+    gl_Position = qt_Matrix * aVertex;
+    vTexCoord = aTexCoord;
+}
+)";
+
+const char* fragShader =
+    R"(
+#version 130
+uniform lowp float qt_Opacity;
+uniform sampler2DArray tex;
+in vec3 vTexCoord;
+void main() {
+    gl_FragColor = texture(tex, vTexCoord) * qt_Opacity;
+}
+)";
+
+/** Vertex with the layer of the texture array as third texture coordinate. */
+struct Vertex
+{
+    float x;
+    float y;
+    float u;
+    float v;
+    float layer;
+};
+
+const QSGGeometry::AttributeSet& _getAttributes()
+{
+    static const QSGGeometry::Attribute attributes[] = {
+        QSGGeometry::Attribute::create(0, 2, GL_FLOAT, true),
+        QSGGeometry::Attribute::create(1, 3, GL_FLOAT)};
+    static const QSGGeometry::AttributeSet set = {2, sizeof(Vertex),
+                                                  attributes};
+    return set;
+}
+
+/**
+ * Material to render a layer of a TextureArray.
+ *
+ * Materials are equal if they use the same array, since the layer is a vertex
+ * attribute. Only arrays with an alpha channel are blended, so that opaque
+ * tiles are drawn in the renderer's front-to-back opaque pass.
+ */
+class TextureArrayMaterial : public QSGMaterial
+{
+public:
+    void setArray(TextureArrayPtr array_)
+    {
+        array = std::move(array_);
+        setFlag(Blending, array && array->hasAlphaChannel());
+    }
+
+    QSGMaterialType* type() const final
+    {
+        static QSGMaterialType type;
+        return &type;
+    }
+
+    QSGMaterialShader* createShader() const final;
+
+    int compare(const QSGMaterial* other) const final
+    {
+        const auto a = array.get();
+        const auto b = static_cast<const TextureArrayMaterial*>(other)->array;
+        return a == b.get() ? 0 : (a < b.get() ? -1 : 1);
+    }
+
+    TextureArrayPtr array;
+};
+
+class TextureArrayShader : public QSGMaterialShader
+{
+public:
+    const char* vertexShader() const final { return vertShader; }
+    const char* fragmentShader() const final { return fragShader; }
+
+    char const* const* attributeNames() const final
+    {
+        static const char* names[] = {"aVertex", "aTexCoord", nullptr};
+        return names;
+    }
+
+    void initialize() final
+    {
+        _matrixId = program()->uniformLocation("qt_Matrix");
+        _opacityId = program()->uniformLocation("qt_Opacity");
+    }
+
+    void updateState(const RenderState& state, QSGMaterial* newMaterial,
+                     QSGMaterial*) final
+    {
+        if (state.isMatrixDirty())
+            program()->setUniformValue(_matrixId, state.combinedMatrix());
+        if (state.isOpacityDirty())
+            program()->setUniformValue(_opacityId, state.opacity());
+
+        // The sampler uses the default texture unit 0
+        auto material = static_cast<TextureArrayMaterial*>(newMaterial);
+        if (material->array)
+            material->array->bind();
+        else
+        {
+            auto gl = QOpenGLContext::currentContext()->functions();
+            gl->glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        }
+    }
+
+private:
+    int _matrixId = -1;
+    int _opacityId = -1;
+};
+
+QSGMaterialShader* TextureArrayMaterial::createShader() const
+{
+    return new TextureArrayShader;
+}
+} // anonymous namespace
+
+TextureNodeArray::TextureNodeArray()
+{
+    setGeometry(new QSGGeometry(_getAttributes(), 4));
+    setFlag(QSGNode::OwnsGeometry);
+
+    setMaterial(new TextureArrayMaterial);
+    setFlag(QSGNode::OwnsMaterial);
+
+    _updateGeometry();
+}
+
+void TextureNodeArray::setCoord(const QRectF& coord)
+{
+    if (_rect == coord)
+        return;
+
+    _rect = coord;
+    _updateGeometry();
+}
+
+void TextureNodeArray::uploadTexture(const ImagePtr& source)
+{
+    const auto image = textureUtils::toSupportedFormat(source);
+    const auto size = image->getTextureSize();
+    if (!size.isValid())
+        throw std::runtime_error("image texture has invalid size");
+    if (image->getFormat() != TextureFormat::rgba)
+        throw std::runtime_error("TextureNodeArray image format must be rgba");
+
+    _backMirrored = image->getRowOrder() == deflect::RowOrder::bottom_up;
+
+    auto& uploader = TextureUploader::current();
+    if (auto shared = uploader.acquireSharedLayer(image))
+    {
+        _backLayer = std::move(shared);
+        return;
+    }
+
+    // The back layer may still be displayed by another screen
+    const auto compressedFormat = image->getGLCompressedFormat();
+    if (!_backLayer || _backLayer->getArray()->getSize() != size ||
+        _backLayer->getArray()->getCompressedFormat() != compressedFormat ||
+        !uploader.claimLayer(*_backLayer))
+    {
+        _backLayer = uploader.acquireLayer(size, compressedFormat);
+    }
+
+    uploader.uploadToLayer(*image, *_backLayer);
+    uploader.shareLayer(image, *_backLayer);
+}
+
+void TextureNodeArray::swap()
+{
+    if (!_backLayer)
+        return;
+
+    // Static textures: the previous layer is returned to its array
+    _layer = std::move(_backLayer);
+    _mirrored = _backMirrored;
+
+    static_cast<TextureArrayMaterial*>(material())->setArray(
+        _layer->getArray());
+    markDirty(DirtyMaterial);
+    _updateGeometry();
+}
+
+void TextureNodeArray::_updateGeometry()
+{
+    const auto layer = _layer ? float(_layer->getIndex()) : 0.f;
+    const auto top = _mirrored ? 1.f : 0.f;
+    const auto bottom = _mirrored ? 0.f : 1.f;
+
+    const float left = _rect.left();
+    const float right = _rect.right();
+    const float y0 = _rect.top();
+    const float y1 = _rect.bottom();
+
+    // Same triangle strip order as QSGGeometry::updateTexturedRectGeometry
+    auto vertices = static_cast<Vertex*>(geometry()->vertexData());
+    vertices[0] = {left, y0, 0.f, top, layer};
+    vertices[1] = {left, y1, 0.f, bottom, layer};
+    vertices[2] = {right, y0, 1.f, top, layer};
+    vertices[3] = {right, y1, 1.f, bottom, layer};
+    markDirty(DirtyGeometry);
+}
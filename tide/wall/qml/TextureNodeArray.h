@@ -0,0 +1,82 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef TEXTURENODEARRAY_H
+#define TEXTURENODEARRAY_H
+
+#include "TextureArray.h"
+#include "TextureNode.h"
+
+#include <QSGNode>
+
+/**
+ * A node displaying a static RGBA image from a layer of a TextureArray.
+ *
+ * The nodes using layers of the same array have equal materials, so the scene
+ * graph renderer merges them in a single draw call. Each node keeps the
+ * semantics of a TextureNode: the image is uploaded to a back layer, which is
+ * displayed after swap(), and the layers are returned to their array when the
+ * node is deleted. An image already uploaded by another screen of the process
+ * is sampled from its layer instead, see TextureUploader::acquireSharedLayer().
+ *
+ * Initially the node renders black, like the other texture nodes.
+ */
+class TextureNodeArray : public QSGGeometryNode, public TextureNode
+{
+public:
+    TextureNodeArray();
+
+    QRectF getCoord() const final { return _rect; }
+    void setCoord(const QRectF& coord) final;
+    void setScreenSize(const QSizeF&) final {} // always mipmapped
+    void uploadTexture(const ImagePtr& image) final;
+    void swap() final;
+
+private:
+    QRectF _rect;
+
+    TextureLayerPtr _layer;
+    TextureLayerPtr _backLayer;
+    bool _mirrored = false;
+    bool _backMirrored = false;
+
+    void _updateGeometry();
+};
+
+#endif
@@ -39,7 +39,9 @@
 
 #include "TextureNodeFactory.h"
 
+#include "TextureNodeArray.h"
 #include "TextureNodeRGBA.h"
+#include "TextureUploader.h"
 #include "TextureNodeYUV.h"
 
 std::unique_ptr<TextureNode> TextureNodeFactoryImpl::create(
@@ -49,6 +51,9 @@ std::unique_ptr<TextureNode> TextureNodeFactoryImpl::create(
     switch (format)
     {
     case TextureFormat::rgba:
+        // Static tiles are batched, dynamic ones are updated continuously
+        if (!dynamic && TextureUploader::current().hasTextureArrays())
+            return std::make_unique<TextureNodeArray>();
         return std::make_unique<TextureNodeRGBA>(_window, dynamic);
     case TextureFormat::yuv444:
     case TextureFormat::yuv422:
@@ -39,15 +39,16 @@
 
 #include "TextureNodeRGBA.h"
 
+#include "TextureUploader.h"
 #include "data/Image.h"
-#include "textureUtils.h"
 
+#include <QOpenGLFunctions>
 #include <QQuickWindow>
 
 TextureNodeRGBA::TextureNodeRGBA(QQuickWindow& window, const bool dynamic)
     : _window(window)
     , _dynamicTexture(dynamic)
-    , _texture(window.createTextureFromId(0, QSize(1, 1)))
+    , _texture(textureUtils::createEmptyTexture(window))
 {
     if (_texture) // needed for null texture in unit tests without a scene graph
         setTexture(_texture.get());
@@ -64,34 +65,96 @@ void TextureNodeRGBA::setMipmapFiltering(const QSGTexture::Filtering filtering_)
     opaqueMat->setMipmapFiltering(filtering_);
 }
 
-void TextureNodeRGBA::uploadTexture(const Image& image)
+void TextureNodeRGBA::setScreenSize(const QSizeF& size)
 {
-    if (!image.getTextureSize().isValid())
+    _screenSize = size;
+
+    // Until its next upload, which may not come soon for paused content, a
+    // texture without mipmaps would alias if it is now minified
+    if (_hasMipmaps || !_image || !_texture || !_texture->textureId() ||
+        !textureUtils::needMipmaps(_imageSize, size, _dynamicTexture))
+    {
+        return;
+    }
+
+    textureUtils::addMipmaps(_texture, _image, 0, _window);
+    _image.reset();
+    _hasMipmaps = true;
+    setTexture(_texture.get());
+    setMipmapFiltering(QSGTexture::Linear);
+    markDirty(DirtyMaterial);
+}
+
+void TextureNodeRGBA::uploadTexture(const ImagePtr& source)
+{
+    const auto image = textureUtils::toSupportedFormat(source);
+    if (!image->getTextureSize().isValid())
         throw std::runtime_error("image texture has invalid size");
 
-    if (image.getRowOrder() == deflect::RowOrder::bottom_up)
+    if (image->getRowOrder() == deflect::RowOrder::bottom_up)
         setTextureCoordinatesTransform(QSGSimpleTextureNode::MirrorVertically);
     else
         setTextureCoordinatesTransform(QSGSimpleTextureNode::NoTransform);
 
-    if (!_pbo)
-        _pbo = textureUtils::createPbo(_dynamicTexture);
+    // Compressed images come with their mipmaps
+    const auto compressedFormat = image->getGLCompressedFormat();
+    _backImageSize = image->getViewPort().size();
+    _backHasMipmaps =
+        compressedFormat != 0 ||
+        textureUtils::needMipmaps(_backImageSize, _screenSize, _dynamicTexture);
+    _backImage = _backHasMipmaps ? ImagePtr() : image;
 
-    textureUtils::upload(image, 0, *_pbo);
+    if (auto shared = textureUtils::acquireSharedTexture(image, 0,
+                                                         _backHasMipmaps,
+                                                         _window))
+    {
+        _backTexture = std::move(shared);
+        return;
+    }
 
-    _nextTextureSize = image.getTextureSize();
-    _glImageFormat = image.getGLPixelFormat();
+    // The back texture may still be displayed by another screen
+    auto& uploader = TextureUploader::current();
+    const auto size = image->getTextureSize();
+    const auto internalFormat =
+        compressedFormat ? compressedFormat : uint(GL_RGBA8);
+    if (!_backTexture || !_backTexture->textureId() ||
+        _backTexture->textureSize() != size ||
+        _backTexture.get_deleter().internalFormat != internalFormat ||
+        !uploader.claimTexture(_backTexture->textureId()))
+    {
+        _backTexture =
+            compressedFormat
+                ? textureUtils::createCompressedTexture(size, compressedFormat,
+                                                        _window)
+                : textureUtils::createTextureRgba(size, _window);
+    }
+
+    const auto textureId = _backTexture->textureId();
+    if (compressedFormat)
+        uploader.uploadCompressed(*image, textureId);
+    else
+        uploader.upload(*image, 0, textureId, image->getGLPixelFormat(),
+                        _backHasMipmaps);
+    uploader.shareTexture(image, 0, textureId, _backHasMipmaps);
 }
 
 void TextureNodeRGBA::swap()
 {
-    if (_texture->textureSize() != _nextTextureSize)
-        _texture = textureUtils::createTextureRgba(_nextTextureSize, _window);
+    if (!_backTexture)
+        return;
 
-    textureUtils::copy(*_pbo, *_texture, _glImageFormat);
+    std::swap(_texture, _backTexture);
+    std::swap(_image, _backImage);
+    std::swap(_hasMipmaps, _backHasMipmaps);
+    std::swap(_imageSize, _backImageSize);
     setTexture(_texture.get());
+    // Sampling missing mipmap levels would render black
+    setMipmapFiltering(_hasMipmaps ? QSGTexture::Linear : QSGTexture::None);
     markDirty(DirtyMaterial);
 
     if (!_dynamicTexture)
-        _pbo.reset();
+    {
+        _backTexture.reset();
+        _backImage.reset();
+    }
 }
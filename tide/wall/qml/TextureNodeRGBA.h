@@ -41,8 +41,8 @@
 #define TEXTURENODERGBA_H
 
 #include "TextureNode.h"
+#include "textureUtils.h"
 
-#include <QOpenGLBuffer>
 #include <QSGSimpleTextureNode>
 #include <memory>
 
@@ -55,10 +55,14 @@ class QQuickWindow;
  * asynchronously to the texture and call swap() on the next frame rendering to
  * display the results.
  *
- * The texture can be either static or dynamic:
- * * In the dynamic case, two PBOs are used for real-time texture updates.
- * * In the static case, a single PBO is used for the initial texture upload and
- *   then released in the first call to swap() so that no memory is wasted.
+ * Uploads go through the TextureUploader of the render thread's context into a
+ * back texture, which becomes the front texture in swap(). An image already
+ * uploaded by another screen of the process is sampled from its texture
+ * instead, see TextureUploader::acquireSharedTexture(). The texture can be
+ * either static or dynamic:
+ * * In the dynamic case, the two textures are kept for real-time updates.
+ * * In the static case, the back texture is released in the first call to
+ *   swap() so that no memory is wasted.
  */
 class TextureNodeRGBA : public QSGSimpleTextureNode, public TextureNode
 {
@@ -75,18 +79,24 @@ public:
 
     QRectF getCoord() const final { return rect(); }
     void setCoord(const QRectF& coord) final { setRect(coord); }
-    void uploadTexture(const Image& image) final;
+    void setScreenSize(const QSizeF& size) final;
+    void uploadTexture(const ImagePtr& image) final;
     void swap() final;
 
 private:
     QQuickWindow& _window;
     bool _dynamicTexture = false;
 
-    std::unique_ptr<QSGTexture> _texture;
-    std::unique_ptr<QOpenGLBuffer> _pbo;
-
-    QSize _nextTextureSize;
-    uint _glImageFormat = 0;
+    textureUtils::TexturePtr _texture;
+    textureUtils::TexturePtr _backTexture;
+    // Source images of textures without mipmaps, in case they need them later
+    ImagePtr _image;
+    ImagePtr _backImage;
+    bool _hasMipmaps = true;
+    bool _backHasMipmaps = true;
+    QSize _imageSize;
+    QSize _backImageSize;
+    QSizeF _screenSize;
 };
 
 #endif
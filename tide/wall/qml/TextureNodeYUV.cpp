@@ -39,11 +39,9 @@
 
 #include "TextureNodeYUV.h"
 
+#include "TextureUploader.h"
 #include "data/Image.h"
-#include "textureUtils.h"
-#include "utils/yuv.h"
 
-#include <QOpenGLBuffer>
 #include <QOpenGLContext>
 #include <QOpenGLFunctions>
 #include <QQuickWindow>
@@ -123,17 +121,13 @@ void main() {
  */
 struct YUVState
 {
-    std::unique_ptr<QSGTexture> textureY;
-    std::unique_ptr<QSGTexture> textureU;
-    std::unique_ptr<QSGTexture> textureV;
+    textureUtils::TexturePtr textureY;
+    textureUtils::TexturePtr textureU;
+    textureUtils::TexturePtr textureV;
     TextureFormat textureFormat;
     bool reverseOrientation = false;
     ColorSpace colorSpace = ColorSpace::undefined;
 
-    std::unique_ptr<QOpenGLBuffer> pboY;
-    std::unique_ptr<QOpenGLBuffer> pboU;
-    std::unique_ptr<QOpenGLBuffer> pboV;
-
     float texOffsetX = 0.f;
     float texOffsetY = 0.f;
     float texScaleX = 1.f;
@@ -215,9 +209,9 @@ TextureNodeYUV::TextureNodeYUV(QQuickWindow& window, const bool dynamic)
     _node.setFlag(QSGNode::OwnsMaterial);
 
     auto state = _getMaterialState(_node);
-    state->textureY.reset(_window.createTextureFromId(0, QSize(1, 1)));
-    state->textureU.reset(_window.createTextureFromId(0, QSize(1, 1)));
-    state->textureV.reset(_window.createTextureFromId(0, QSize(1, 1)));
+    state->textureY = textureUtils::createEmptyTexture(_window);
+    state->textureU = textureUtils::createEmptyTexture(_window);
+    state->textureV = textureUtils::createEmptyTexture(_window);
 
     appendChildNode(&_node);
 }
@@ -238,27 +232,49 @@ void TextureNodeYUV::setCoord(const QRectF& rect)
     _node.markDirty(QSGNode::DirtyGeometry);
 }
 
-void TextureNodeYUV::uploadTexture(const Image& image)
+void TextureNodeYUV::setScreenSize(const QSizeF& size)
 {
-    if (!image.getTextureSize().isValid())
-        throw std::runtime_error("image texture has invalid size");
-    if (image.getGLPixelFormat() != GL_RED)
-        throw std::runtime_error("TextureNodeYUV image format must be GL_RED");
+    _screenSize = size;
 
+    // Until their next upload, which may not come soon for paused movies,
+    // textures without mipmaps would alias if they are now minified
     auto state = _getMaterialState(_node);
-    if (!state->pboY)
-        _createPbos();
+    if (_hasMipmaps || !_image || !state->textureY->textureId() ||
+        !textureUtils::needMipmaps(_imageSize, size, _dynamicTexture))
+    {
+        return;
+    }
+
+    textureUtils::TexturePtr* textures[] = {&state->textureY, &state->textureU,
+                                            &state->textureV};
+    for (uint plane = 0; plane < 3; ++plane)
+    {
+        auto& texture = *textures[plane];
+        textureUtils::addMipmaps(texture, _image, plane, _window);
+        texture->setFiltering(QSGTexture::Linear);
+        texture->setMipmapFiltering(QSGTexture::Linear);
+    }
+    _image.reset();
+    _hasMipmaps = true;
+    markDirty(DirtyMaterial);
+}
 
-    _uploadToPbos(image);
+void TextureNodeYUV::uploadTexture(const ImagePtr& image)
+{
+    if (!image->getTextureSize().isValid())
+        throw std::runtime_error("image texture has invalid size");
+    if (image->getGLPixelFormat() != GL_RED)
+        throw std::runtime_error("TextureNodeYUV image format must be GL_RED");
 
-    _nextTextureSize = image.getTextureSize();
-    _nextFormat = image.getFormat();
+    _uploadToBackTextures(image);
+    _backFormat = image->getFormat();
 
+    auto state = _getMaterialState(_node);
     {
         // Calculate viewport clipping
-        const auto viewPort = image.getViewPort();
-        const double imageWidth = image.getWidth();
-        const double imageHeight = image.getHeight();
+        const auto viewPort = image->getViewPort();
+        const double imageWidth = image->getWidth();
+        const double imageHeight = image->getHeight();
 
         state->texOffsetX = viewPort.x() / imageWidth;
         state->texOffsetY = viewPort.y() / imageHeight;
@@ -267,77 +283,73 @@ void TextureNodeYUV::uploadTexture(const Image& image)
     }
 
     state->reverseOrientation =
-        image.getRowOrder() == deflect::RowOrder::bottom_up;
-    state->colorSpace = image.getColorSpace();
+        image->getRowOrder() == deflect::RowOrder::bottom_up;
+    state->colorSpace = image->getColorSpace();
 }
 
 void TextureNodeYUV::swap()
 {
-    if (_needTextureChange())
-        _createTextures(_nextTextureSize, _nextFormat);
+    if (!_backTextureY)
+        return;
 
-    _copyPbosToTextures();
+    auto state = _getMaterialState(_node);
+    std::swap(state->textureY, _backTextureY);
+    std::swap(state->textureU, _backTextureU);
+    std::swap(state->textureV, _backTextureV);
+    std::swap(state->textureFormat, _backFormat);
+    std::swap(_image, _backImage);
+    std::swap(_hasMipmaps, _backHasMipmaps);
+    std::swap(_imageSize, _backImageSize);
     markDirty(DirtyMaterial);
 
     if (!_dynamicTexture)
-        _deletePbos();
-}
-
-bool TextureNodeYUV::_needTextureChange() const
-{
-    auto state = _getMaterialState(_node);
-    return state->textureY->textureSize() != _nextTextureSize ||
-           state->textureFormat != _nextFormat;
-}
-
-void TextureNodeYUV::_createTextures(const QSize& size,
-                                     const TextureFormat format)
-{
-    auto state = _getMaterialState(_node);
-    const auto uvSize = yuv::getUVSize(size, format);
-    state->textureY = _createTexture(size);
-    state->textureU = _createTexture(uvSize);
-    state->textureV = _createTexture(uvSize);
-    state->textureFormat = format;
-}
-
-std::unique_ptr<QSGTexture> TextureNodeYUV::_createTexture(
-    const QSize& size) const
-{
-    auto texture = textureUtils::createTexture(size, _window);
-    texture->setFiltering(QSGTexture::Linear);
-    texture->setMipmapFiltering(QSGTexture::Linear);
-    return texture;
-}
-
-void TextureNodeYUV::_createPbos()
-{
-    auto state = _getMaterialState(_node);
-    state->pboY = textureUtils::createPbo(_dynamicTexture);
-    state->pboU = textureUtils::createPbo(_dynamicTexture);
-    state->pboV = textureUtils::createPbo(_dynamicTexture);
-}
-
-void TextureNodeYUV::_deletePbos()
-{
-    auto state = _getMaterialState(_node);
-    state->pboY.reset();
-    state->pboU.reset();
-    state->pboV.reset();
+        _deleteBackTextures();
 }
 
-void TextureNodeYUV::_uploadToPbos(const Image& image)
+void TextureNodeYUV::_deleteBackTextures()
 {
-    auto state = _getMaterialState(_node);
-    textureUtils::upload(image, 0, *state->pboY);
-    textureUtils::upload(image, 1, *state->pboU);
-    textureUtils::upload(image, 2, *state->pboV);
+    _backTextureY.reset();
+    _backTextureU.reset();
+    _backTextureV.reset();
+    _backImage.reset();
 }
 
-void TextureNodeYUV::_copyPbosToTextures()
+void TextureNodeYUV::_uploadToBackTextures(const ImagePtr& image)
 {
-    auto state = _getMaterialState(_node);
-    textureUtils::copy(*state->pboY, *state->textureY, GL_RED);
-    textureUtils::copy(*state->pboU, *state->textureU, GL_RED);
-    textureUtils::copy(*state->pboV, *state->textureV, GL_RED);
+    _backImageSize = image->getViewPort().size();
+    _backHasMipmaps =
+        textureUtils::needMipmaps(_backImageSize, _screenSize, _dynamicTexture);
+    _backImage = _backHasMipmaps ? ImagePtr() : image;
+    const auto mipmaps = _backHasMipmaps;
+    // Sampling missing mipmap levels would render black
+    const auto filtering = mipmaps ? QSGTexture::Linear : QSGTexture::None;
+
+    auto& uploader = TextureUploader::current();
+    textureUtils::TexturePtr* textures[] = {&_backTextureY, &_backTextureU,
+                                            &_backTextureV};
+    for (uint plane = 0; plane < 3; ++plane)
+    {
+        auto& texture = *textures[plane];
+        if (auto shared = textureUtils::acquireSharedTexture(image, plane,
+                                                             mipmaps, _window))
+        {
+            texture = std::move(shared);
+        }
+        else
+        {
+            // The back texture may still be displayed by another screen
+            const auto size = image->getTextureSize(plane);
+            if (!texture || !texture->textureId() ||
+                texture->textureSize() != size ||
+                !uploader.claimTexture(texture->textureId()))
+            {
+                texture = textureUtils::createTexture(size, _window);
+            }
+            const auto textureId = texture->textureId();
+            uploader.upload(*image, plane, textureId, GL_RED, mipmaps);
+            uploader.shareTexture(image, plane, textureId, mipmaps);
+        }
+        texture->setFiltering(QSGTexture::Linear);
+        texture->setMipmapFiltering(filtering);
+    }
 }
@@ -41,6 +41,7 @@
 #define TEXTURENODEYUV_H
 
 #include "TextureNode.h"
+#include "textureUtils.h"
 
 #include <QSGNode>
 
@@ -54,10 +55,14 @@ class QSGTexture;
  * asynchronously to the texture and call swap() on the next frame rendering to
  * display the results.
  *
- * The texture can be either static or dynamic:
- * * In the dynamic case, two PBOs are used for real-time texture updates.
- * * In the static case, a single PBO is used for the initial texture upload and
- *   then released in the first call to swap() so that no memory is wasted.
+ * Uploads go through the TextureUploader of the render thread's context into
+ * back textures, which become the front textures in swap(). An image already
+ * uploaded by another screen of the process is sampled from its textures
+ * instead, see TextureUploader::acquireSharedTexture(). The texture can be
+ * either static or dynamic:
+ * * In the dynamic case, both sets of textures are kept for real-time updates.
+ * * In the static case, the back textures are released in the first call to
+ *   swap() so that no memory is wasted.
  */
 class TextureNodeYUV : public QSGNode, public TextureNode
 {
@@ -71,7 +76,8 @@ public:
 
     QRectF getCoord() const final;
     void setCoord(const QRectF& rect) final;
-    void uploadTexture(const Image& image) final;
+    void setScreenSize(const QSizeF& size) final;
+    void uploadTexture(const ImagePtr& image) final;
     void swap() final;
 
 private:
@@ -81,17 +87,21 @@ private:
     QRectF _rect;
     QSGGeometryNode _node;
 
-    QSize _nextTextureSize;
-    TextureFormat _nextFormat;
+    textureUtils::TexturePtr _backTextureY;
+    textureUtils::TexturePtr _backTextureU;
+    textureUtils::TexturePtr _backTextureV;
+    TextureFormat _backFormat = TextureFormat::yuv420;
+    // Source images of textures without mipmaps, in case they need them later
+    ImagePtr _image;
+    ImagePtr _backImage;
+    bool _hasMipmaps = true;
+    bool _backHasMipmaps = true;
+    QSize _imageSize;
+    QSize _backImageSize;
+    QSizeF _screenSize;
 
-    bool _needTextureChange() const;
-    void _createTextures(const QSize& size, TextureFormat format);
-    std::unique_ptr<QSGTexture> _createTexture(const QSize& size) const;
-    void _createPbos();
-    void _deletePbos();
-    void _uploadToPbos(const Image& image);
-    void _copyPbosToTextures();
-    void _swapPbos();
+    void _deleteBackTextures();
+    void _uploadToBackTextures(const ImagePtr& image);
 };
 
 #endif
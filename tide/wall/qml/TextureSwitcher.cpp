@@ -49,13 +49,19 @@ void TextureSwitcher::setNextImage(ImagePtr image)
     _image = image;
 }
 
+const ImagePtr& TextureSwitcher::getNextImage() const
+{
+    return _image;
+}
+
 void TextureSwitcher::requestSwap()
 {
     _swapRequested = true;
 }
 
 void TextureSwitcher::update(std::unique_ptr<TextureNode>& node,
-                             TextureNodeFactory& factory)
+                             TextureNodeFactory& factory,
+                             const bool upload)
 {
     if (!node) // initial call
     {
@@ -65,7 +71,7 @@ void TextureSwitcher::update(std::unique_ptr<TextureNode>& node,
             return;
     }
 
-    if (_image)
+    if (_image && upload)
     {
         if (_needToChangeNextNode(factory))
             _createNextNode(factory);
@@ -78,6 +84,25 @@ void TextureSwitcher::update(std::unique_ptr<TextureNode>& node,
 
     if (_canSwap())
         _swap(node);
+
+    // The scale can change without new images, e.g. for paused movies
+    if (_screenSize.isValid())
+        node->setScreenSize(_screenSize);
+}
+
+void TextureSwitcher::setScreenSize(const QSizeF& size)
+{
+    _screenSize = size;
+}
+
+void TextureSwitcher::reset()
+{
+    _swapRequested = false;
+    _swapPossible = false;
+    _image.reset();
+    _screenSize = QSizeF();
+    _format = TextureFormat::rgba;
+    _nextNode.reset();
 }
 
 bool TextureSwitcher::_canSwap() const
@@ -110,7 +135,8 @@ void TextureSwitcher::_createNextNode(TextureNodeFactory& factory)
 
 void TextureSwitcher::_uploadImage(TextureNode& node)
 {
-    node.uploadTexture(*_image);
+    node.setScreenSize(_screenSize);
+    node.uploadTexture(_image);
     _format = _image->getFormat();
     _image.reset();
     _swapPossible = true;
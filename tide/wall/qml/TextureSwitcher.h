@@ -51,18 +51,29 @@ public:
     /** Set the image used to update the back texture in the next update(). */
     void setNextImage(ImagePtr image);
 
+    /** @return the image waiting to be uploaded in update(), if any. */
+    const ImagePtr& getNextImage() const;
+
     /** Request a swap of the front/back textures in the next update(). */
     void requestSwap();
 
+    /** Set the size on screen of the node, applied in the next update(). */
+    void setScreenSize(const QSizeF& size);
+
     /**
      * Update and/or swap a texture node, (re-)creating it if needed.
      * @param node to update with the given image, swapping its front/back
      *        textures if requested with requestSwap(). The node is reset if the
      *        image format has changed.
      * @param factory to create appropriate nodes for the image type.
+     * @param upload false to keep the next image for a later update(), in
+     *        which case the swap is also postponed.
      */
     void update(std::unique_ptr<TextureNode>& node,
-                TextureNodeFactory& factory);
+                TextureNodeFactory& factory, bool upload = true);
+
+    /** Reset to the initial state, once the node has left the scene. */
+    virtual void reset();
 
     virtual ~TextureSwitcher() = default;
 
@@ -70,6 +81,7 @@ private:
     bool _swapRequested = false;
     bool _swapPossible = false;
     ImagePtr _image;
+    QSizeF _screenSize;
     TextureFormat _format = TextureFormat::rgba;
     std::unique_ptr<TextureNode> _nextNode;
 
@@ -0,0 +1,1014 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "TextureUploader.h"
+
+#include "SharedTextures.h"
+#include "data/Image.h"
+
+#include <QOpenGLBuffer>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+
+#include <algorithm>
+#include <cstdlib> // getenv
+#include <cstring> // std::memcpy
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <string>
+
+// ARB_sync and ARB_buffer_storage (OpenGL 3.2 / 4.4) may not be declared by
+// the OpenGL headers shipped with Qt on some platforms.
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT 0x0002
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
+#ifndef GL_TIMEOUT_EXPIRED
+#define GL_TIMEOUT_EXPIRED 0x911B
+#endif
+#ifndef GL_TIMEOUT_IGNORED
+#define GL_TIMEOUT_IGNORED 0xFFFFFFFFFFFFFFFFull
+#endif
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+#ifndef GL_TEXTURE_2D_ARRAY
+#define GL_TEXTURE_2D_ARRAY 0x8C1A
+#endif
+#ifndef GL_READ_FRAMEBUFFER
+#define GL_READ_FRAMEBUFFER 0x8CA8
+#endif
+#ifndef GL_DRAW_FRAMEBUFFER
+#define GL_DRAW_FRAMEBUFFER 0x8CA9
+#endif
+#ifndef GL_READ_FRAMEBUFFER_BINDING
+#define GL_READ_FRAMEBUFFER_BINDING 0x8CAA
+#endif
+#ifndef GL_DRAW_FRAMEBUFFER_BINDING
+#define GL_DRAW_FRAMEBUFFER_BINDING 0x8CA6
+#endif
+
+namespace
+{
+// Keep the offsets of the uploads aligned for the DMA engines
+const size_t uploadAlignment = 256;
+
+// Texture arrays hold up to 32 tiles, fewer for large tiles so that a single
+// large static image does not allocate more than its own texture.
+const size_t maxTextureArrayBytes = 64 * 1024 * 1024;
+const size_t maxTextureArrayLayers = 32;
+
+// Empty texture arrays kept for the next tiles, the others are deleted
+const size_t maxSpareTextureArrays = 2;
+
+const quint64 fenceTimeoutNs = 100 * 1000 * 1000;
+
+using Clock = std::chrono::steady_clock;
+
+std::mutex registryMutex;
+std::map<QOpenGLContext*, std::unique_ptr<TextureUploader>> registry;
+
+std::mutex sharedTexturesMutex;
+std::map<QOpenGLContextGroup*, std::weak_ptr<SharedTextures>> sharedTextures;
+
+size_t _align(const size_t bytes)
+{
+    return (bytes + uploadAlignment - 1) / uploadAlignment * uploadAlignment;
+}
+
+GLint _getUnpackAlignment(const int textureWidth)
+{
+    if (textureWidth % 4 == 0)
+        return 4;
+    if (textureWidth % 2 == 0)
+        return 2;
+    return 1;
+}
+
+GLenum _getPixelFormat(const uint internalFormat)
+{
+    return internalFormat == GL_R8 ? GL_RED : GL_RGBA;
+}
+
+bool _isCompressed(const uint internalFormat)
+{
+    return internalFormat != GL_R8 && internalFormat != GL_RGBA8;
+}
+
+uint _getMipmapLevels(const QSize& size)
+{
+    uint levels = 1;
+    for (auto extent = std::max(size.width(), size.height()); extent > 1;
+         extent /= 2)
+    {
+        ++levels;
+    }
+    return levels;
+}
+
+QSize _getLevelSize(const QSize& size, const uint level)
+{
+    return {std::max(1, size.width() >> level),
+            std::max(1, size.height() >> level)};
+}
+
+size_t _getUploadSize(const Image& image)
+{
+    if (image.getGLCompressedFormat())
+    {
+        size_t bytes = 0;
+        for (uint level = 0; level < image.getMipmapLevels(); ++level)
+            bytes += image.getDataSize(level);
+        return bytes;
+    }
+    if (image.getFormat() == TextureFormat::rgba)
+        return image.getDataSize(0);
+    return image.getDataSize(0) + image.getDataSize(1) + image.getDataSize(2);
+}
+
+uint _getTextureArrayLayers(const QSize& size, const bool compressed)
+{
+    // Block-compressed formats use 4 bits per pixel
+    const auto pixels = size_t(size.width()) * size.height();
+    const auto layerBytes = compressed ? pixels / 2 : pixels * 4;
+    const auto layers = maxTextureArrayBytes / std::max(layerBytes, size_t(1));
+    return std::max(size_t(1), std::min(layers, maxTextureArrayLayers));
+}
+
+bool _isTileBatchingEnabled()
+{
+    const auto envStr = getenv("TIDE_TILE_BATCHING");
+    return !envStr || std::string(envStr) != "0";
+}
+
+bool _hasCompressedTextures(const QOpenGLContext& context)
+{
+    return context.hasExtension("GL_EXT_texture_compression_s3tc") ||
+           context.hasExtension("GL_EXT_texture_compression_dxt1");
+}
+
+bool _isTextureSharingEnabled()
+{
+    const auto envStr = getenv("TIDE_TEXTURE_SHARING");
+    return !envStr || std::string(envStr) != "0";
+}
+
+std::shared_ptr<SharedTextures> _getSharedTextures(QOpenGLContextGroup* group)
+{
+    const std::lock_guard<std::mutex> lock{sharedTexturesMutex};
+    auto& weakTextures = sharedTextures[group];
+    auto textures = weakTextures.lock();
+    if (!textures)
+    {
+        textures = std::make_shared<SharedTextures>();
+        weakTextures = textures;
+    }
+    return textures;
+}
+
+QOpenGLContext* _getCurrentGlContext()
+{
+    if (auto context = QOpenGLContext::currentContext())
+        return context;
+    throw std::runtime_error("no current gl context");
+}
+} // anonymous namespace
+
+/** The entry points which are not part of QOpenGLFunctions. */
+struct TextureUploader::GLFunctions
+{
+    using BufferStorage = void(QOPENGLF_APIENTRYP)(GLenum, GLsizeiptr,
+                                                   const void*, GLbitfield);
+    using MapBufferRange = void*(QOPENGLF_APIENTRYP)(GLenum, GLintptr,
+                                                     GLsizeiptr, GLbitfield);
+    using UnmapBuffer = GLboolean(QOPENGLF_APIENTRYP)(GLenum);
+    using FenceSync = void*(QOPENGLF_APIENTRYP)(GLenum, GLbitfield);
+    using ClientWaitSync = GLenum(QOPENGLF_APIENTRYP)(void*, GLbitfield,
+                                                      quint64);
+    using DeleteSync = void(QOPENGLF_APIENTRYP)(void*);
+    using WaitSync = void(QOPENGLF_APIENTRYP)(void*, GLbitfield, quint64);
+    using TexImage3D = void(QOPENGLF_APIENTRYP)(GLenum, GLint, GLint, GLsizei,
+                                                GLsizei, GLsizei, GLint,
+                                                GLenum, GLenum, const void*);
+    using TexSubImage3D = void(QOPENGLF_APIENTRYP)(GLenum, GLint, GLint,
+                                                   GLint, GLint, GLsizei,
+                                                   GLsizei, GLsizei, GLenum,
+                                                   GLenum, const void*);
+    using CompressedTexSubImage3D = void(QOPENGLF_APIENTRYP)(
+        GLenum, GLint, GLint, GLint, GLint, GLsizei, GLsizei, GLsizei, GLenum,
+        GLsizei, const void*);
+    using FramebufferTextureLayer = void(QOPENGLF_APIENTRYP)(GLenum, GLenum,
+                                                             GLuint, GLint,
+                                                             GLint);
+    using BlitFramebuffer = void(QOPENGLF_APIENTRYP)(GLint, GLint, GLint,
+                                                     GLint, GLint, GLint,
+                                                     GLint, GLint, GLbitfield,
+                                                     GLenum);
+
+    BufferStorage bufferStorage = nullptr;
+    MapBufferRange mapBufferRange = nullptr;
+    UnmapBuffer unmapBuffer = nullptr;
+    FenceSync fenceSync = nullptr;
+    ClientWaitSync clientWaitSync = nullptr;
+    DeleteSync deleteSync = nullptr;
+    WaitSync waitSync = nullptr;
+    TexImage3D texImage3D = nullptr;
+    TexSubImage3D texSubImage3D = nullptr;
+    CompressedTexSubImage3D compressedTexSubImage3D = nullptr;
+    FramebufferTextureLayer framebufferTextureLayer = nullptr;
+    BlitFramebuffer blitFramebuffer = nullptr;
+
+    explicit GLFunctions(QOpenGLContext& context)
+    {
+        if (context.isOpenGLES())
+            return;
+
+        const auto version = context.format().version();
+        if (version >= qMakePair(3, 0))
+        {
+            _resolve(context, "glTexImage3D", texImage3D);
+            _resolve(context, "glTexSubImage3D", texSubImage3D);
+            _resolve(context, "glCompressedTexSubImage3D",
+                     compressedTexSubImage3D);
+            _resolve(context, "glFramebufferTextureLayer",
+                     framebufferTextureLayer);
+            _resolve(context, "glBlitFramebuffer", blitFramebuffer);
+        }
+
+        if (version >= qMakePair(3, 2) || context.hasExtension("GL_ARB_sync"))
+        {
+            _resolve(context, "glFenceSync", fenceSync);
+            _resolve(context, "glClientWaitSync", clientWaitSync);
+            _resolve(context, "glDeleteSync", deleteSync);
+            _resolve(context, "glWaitSync", waitSync);
+        }
+
+        const auto hasStorage = version >= qMakePair(4, 4) ||
+                                context.hasExtension("GL_ARB_buffer_storage");
+        if (!hasStorage)
+            return;
+
+        _resolve(context, "glBufferStorage", bufferStorage);
+        _resolve(context, "glMapBufferRange", mapBufferRange);
+        _resolve(context, "glUnmapBuffer", unmapBuffer);
+    }
+
+    bool hasTextureArrays() const
+    {
+        return texImage3D && texSubImage3D && compressedTexSubImage3D &&
+               framebufferTextureLayer && blitFramebuffer;
+    }
+
+    bool hasSync() const { return fenceSync && deleteSync && waitSync; }
+
+    bool isComplete() const
+    {
+        return bufferStorage && mapBufferRange && unmapBuffer && fenceSync &&
+               clientWaitSync && deleteSync;
+    }
+
+private:
+    template <typename Func>
+    static void _resolve(QOpenGLContext& context, const char* name,
+                         Func& func)
+    {
+        func = reinterpret_cast<Func>(context.getProcAddress(name));
+    }
+};
+
+TextureUploader& TextureUploader::current()
+{
+    auto context = _getCurrentGlContext();
+
+    const std::lock_guard<std::mutex> lock{registryMutex};
+    auto& uploader = registry[context];
+    if (!uploader)
+    {
+        uploader.reset(new TextureUploader);
+        QObject::connect(context, &QOpenGLContext::aboutToBeDestroyed,
+                         [context] {
+                             const std::lock_guard<std::mutex> l{registryMutex};
+                             registry.erase(context);
+                         });
+    }
+    return *uploader;
+}
+
+TextureUploader* TextureUploader::find()
+{
+    const std::lock_guard<std::mutex> lock{registryMutex};
+    const auto it = registry.find(QOpenGLContext::currentContext());
+    return it != registry.end() ? it->second.get() : nullptr;
+}
+
+void TextureUploader::recycle(const uint textureId, const QSize& size,
+                              const uint internalFormat)
+{
+    if (auto uploader = find())
+        uploader->releaseTexture(textureId, size, internalFormat);
+    else if (auto context = QOpenGLContext::currentContext())
+        context->functions()->glDeleteTextures(1, &textureId);
+    // else: the context is gone, and its textures with it
+}
+
+// About 2 ms of transfer at the typical PCIe 3.0 x16 throughput
+size_t TextureUploader::_defaultFrameBudget = 24 * 1024 * 1024;
+
+TextureUploader::TextureUploader(const size_t segments,
+                                 const size_t segmentSize)
+    : _context{_getCurrentGlContext()}
+    , _gl{new GLFunctions{*_context}}
+    , _segmentSize{_align(segmentSize)}
+    , _frameBudget{_defaultFrameBudget}
+    , _textureArraysEnabled{_gl->hasTextureArrays() && _isTileBatchingEnabled()}
+    , _compressedTextures{_hasCompressedTextures(*_context)}
+    , _sharingEnabled{_gl->hasSync() && _isTextureSharingEnabled()}
+    , _sharedTextures{_sharingEnabled
+                          ? _getSharedTextures(_context->shareGroup())
+                          : std::make_shared<SharedTextures>()}
+{
+    if (_gl->isComplete())
+        _createRing(std::max(segments, size_t(2)));
+}
+
+TextureUploader::~TextureUploader()
+{
+    // Without the context, the resources are released along with it
+    if (QOpenGLContext::currentContext() == _context)
+        _destroy();
+}
+
+bool TextureUploader::isPersistent() const
+{
+    return _mappedData != nullptr;
+}
+
+void TextureUploader::upload(const Image& image, const uint plane,
+                             const uint textureId, const uint glFormat,
+                             const bool mipmaps)
+{
+    const auto size = image.getTextureSize(plane);
+    const auto bytes = image.getDataSize(plane);
+    auto gl = _context->functions();
+
+    const auto pixels = _stage(image, plane);
+
+    gl->glPixelStorei(GL_UNPACK_ALIGNMENT, _getUnpackAlignment(size.width()));
+    gl->glBindTexture(GL_TEXTURE_2D, textureId);
+    gl->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size.width(), size.height(),
+                        glFormat, GL_UNSIGNED_BYTE, pixels);
+    if (mipmaps)
+    {
+        gl->glGenerateMipmap(GL_TEXTURE_2D);
+        ++_statistics.mipmapsGenerated;
+    }
+    else
+        ++_statistics.mipmapsSkipped;
+    gl->glBindTexture(GL_TEXTURE_2D, 0);
+    gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    ++_statistics.uploads;
+    _statistics.bytes += bytes;
+}
+
+void TextureUploader::generateMipmaps(const uint textureId)
+{
+    auto gl = _context->functions();
+    gl->glBindTexture(GL_TEXTURE_2D, textureId);
+    gl->glGenerateMipmap(GL_TEXTURE_2D);
+    gl->glBindTexture(GL_TEXTURE_2D, 0);
+    ++_statistics.mipmapsGenerated;
+}
+
+bool TextureUploader::hasCompressedTextures() const
+{
+    return _compressedTextures;
+}
+
+void TextureUploader::uploadCompressed(const Image& image, const uint textureId)
+{
+    const auto format = image.getGLCompressedFormat();
+    auto gl = _context->functions();
+
+    for (uint level = 0; level < image.getMipmapLevels(); ++level)
+    {
+        const auto size = image.getTextureSize(level);
+        const auto bytes = image.getDataSize(level);
+        const auto blocks = _stage(image, level);
+
+        gl->glBindTexture(GL_TEXTURE_2D, textureId);
+        gl->glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, size.width(),
+                                      size.height(), format, GLsizei(bytes),
+                                      blocks);
+        _statistics.bytes += bytes;
+    }
+    gl->glBindTexture(GL_TEXTURE_2D, 0);
+    gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    ++_statistics.uploads;
+}
+
+uint TextureUploader::acquireSharedTexture(const ImagePtr& image,
+                                           const uint plane, const bool mipmaps)
+{
+    if (!_sharingEnabled)
+        return 0;
+
+    const auto texture = _sharedTextures->acquire(image, plane, mipmaps);
+    if (!texture.id)
+        return 0;
+
+    // The texture must not be sampled before the upload is complete
+    if (texture.fence)
+        _gl->waitSync(texture.fence, 0, GL_TIMEOUT_IGNORED);
+
+    ++_statistics.uploadsSaved;
+    _statistics.bytesSaved += image->getDataSize(plane);
+    return texture.id;
+}
+
+bool TextureUploader::claimTexture(const uint textureId)
+{
+    if (!_sharedTextures->claim(textureId))
+        return false;
+
+    _waitForRelease(textureId);
+    return true;
+}
+
+void TextureUploader::shareTexture(const ImagePtr& image, const uint plane,
+                                   const uint textureId, const bool mipmaps)
+{
+    if (!_sharesTextures())
+        return;
+
+    // The other contexts wait on the fence, which must reach the GPU first
+    const auto fence = _gl->fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _context->functions()->glFlush();
+    _sharedTextures->add(image, plane, {textureId, mipmaps, fence});
+}
+
+uint TextureUploader::acquireTexture(const QSize& size,
+                                     const uint internalFormat)
+{
+    const auto pooledId = _sharedTextures->takePooledTexture(size,
+                                                             internalFormat);
+    if (pooledId)
+    {
+        _waitForRelease(pooledId);
+        ++_statistics.texturesReused;
+        return pooledId;
+    }
+
+    ++_statistics.texturesCreated;
+    auto gl = _context->functions();
+    auto textureId = GLuint{0};
+    gl->glGenTextures(1, &textureId);
+    gl->glBindTexture(GL_TEXTURE_2D, textureId);
+
+    // The mipmaps of compressed textures are uploaded, not generated
+    const auto levels =
+        _isCompressed(internalFormat) ? _getMipmapLevels(size) : 1;
+    for (uint level = 0; level < levels; ++level)
+    {
+        const auto levelSize = _getLevelSize(size, level);
+        gl->glTexImage2D(GL_TEXTURE_2D, level, internalFormat,
+                         levelSize.width(), levelSize.height(), 0,
+                         _getPixelFormat(internalFormat), GL_UNSIGNED_BYTE,
+                         nullptr);
+    }
+    gl->glBindTexture(GL_TEXTURE_2D, 0);
+    return textureId;
+}
+
+void TextureUploader::releaseTexture(const uint textureId, const QSize& size,
+                                     const uint internalFormat)
+{
+    if (_sharedTextures->release(textureId, _createReleaseFence()))
+        return;
+
+    const auto oldest =
+        _sharedTextures->poolTexture(textureId, size, internalFormat);
+    if (oldest)
+        _context->functions()->glDeleteTextures(1, &oldest);
+}
+
+size_t TextureUploader::getPooledTexturesCount() const
+{
+    return _sharedTextures->getPooledTexturesCount();
+}
+
+void TextureUploader::setFrameBudget(const size_t bytes)
+{
+    _frameBudget = bytes;
+}
+
+void TextureUploader::setDefaultFrameBudget(const size_t bytes)
+{
+    _defaultFrameBudget = bytes;
+}
+
+bool TextureUploader::acquireBudget(const Image& image, const Priority priority)
+{
+    if (_sharingEnabled && _sharedTextures->contains(image))
+        return true;
+
+    const auto bytes = _getUploadSize(image);
+    const auto fits = _frameBudget == 0 || _budgetUsed + bytes <= _frameBudget;
+
+    bool accepted = false;
+    switch (priority)
+    {
+    case Priority::dynamic:
+        accepted = true;
+        break;
+    case Priority::visible:
+        accepted = fits || _budgetUsed == 0;
+        _visibleDeferred = _visibleDeferred || !accepted;
+        break;
+    case Priority::prefetch:
+        accepted = fits && !_visibleDeferred && !_visibleDeferredLastFrame;
+        break;
+    }
+
+    if (accepted)
+        _budgetUsed += bytes;
+    else
+        ++_statistics.deferred;
+    return accepted;
+}
+
+bool TextureUploader::hasTextureArrays() const
+{
+    return _textureArraysEnabled;
+}
+
+TextureLayerPtr TextureUploader::acquireLayer(const QSize& size,
+                                             const uint compressedFormat)
+{
+    if (!_textureArraysEnabled)
+        throw std::runtime_error("texture arrays are not supported");
+
+    auto it = std::find_if(_textureArrays.begin(), _textureArrays.end(),
+                           [&](const TextureArrayPtr& array) {
+                               return array->getSize() == size &&
+                                      array->getCompressedFormat() ==
+                                          compressedFormat &&
+                                      !array->isFull();
+                           });
+    if (it == _textureArrays.end())
+    {
+        _textureArrays.push_back(_createTextureArray(size, compressedFormat));
+        it = std::prev(_textureArrays.end());
+    }
+    const auto index = (*it)->acquireLayer();
+    _waitForRelease((*it)->getTextureId(), index);
+    return std::make_unique<TextureLayer>(*it, index);
+}
+
+void TextureUploader::uploadToLayer(const Image& image,
+                                    const TextureLayer& layer)
+{
+    const auto size = image.getTextureSize();
+    auto& array = *layer.getArray();
+    if (size != array.getSize())
+        throw std::invalid_argument("image and texture layer sizes differ");
+    const auto format = image.getGLCompressedFormat();
+    if (format != array.getCompressedFormat())
+        throw std::invalid_argument("image and texture layer formats differ");
+
+    auto gl = _context->functions();
+    if (format)
+    {
+        for (uint level = 0; level < image.getMipmapLevels(); ++level)
+        {
+            const auto levelSize = image.getTextureSize(level);
+            const auto bytes = image.getDataSize(level);
+            const auto blocks = _stage(image, level);
+
+            gl->glBindTexture(GL_TEXTURE_2D_ARRAY, array.getTextureId());
+            _gl->compressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0,
+                                         layer.getIndex(), levelSize.width(),
+                                         levelSize.height(), 1, format,
+                                         GLsizei(bytes), blocks);
+            _statistics.bytes += bytes;
+        }
+    }
+    else
+    {
+        const auto pixels = _stage(image, 0);
+
+        gl->glPixelStorei(GL_UNPACK_ALIGNMENT,
+                          _getUnpackAlignment(size.width()));
+        gl->glBindTexture(GL_TEXTURE_2D_ARRAY, array.getTextureId());
+        _gl->texSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer.getIndex(),
+                           size.width(), size.height(), 1,
+                           image.getGLPixelFormat(), GL_UNSIGNED_BYTE, pixels);
+        _statistics.bytes += image.getDataSize(0);
+    }
+    gl->glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    array.invalidateMipmaps(layer.getIndex());
+
+    ++_statistics.uploads;
+}
+
+void TextureUploader::generateMipmaps(TextureArray& array)
+{
+    const auto layers = array.takeOutdatedLayers();
+    if (layers.empty())
+        return;
+
+    // Called while rendering: restore the framebuffers and the scissor test,
+    // which also applies to blits.
+    auto gl = _context->functions();
+    GLint readFramebuffer = 0;
+    GLint drawFramebuffer = 0;
+    gl->glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+    gl->glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+    const auto scissor = gl->glIsEnabled(GL_SCISSOR_TEST);
+    gl->glDisable(GL_SCISSOR_TEST);
+
+    GLuint framebuffers[2] = {0, 0};
+    gl->glGenFramebuffers(2, framebuffers);
+    gl->glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffers[0]);
+    gl->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffers[1]);
+
+    const auto size = array.getSize();
+    const auto levels = _getMipmapLevels(size);
+    for (const auto layer : layers)
+    {
+        for (uint level = 1; level < levels; ++level)
+        {
+            const auto src = _getLevelSize(size, level - 1);
+            const auto dst = _getLevelSize(size, level);
+            _gl->framebufferTextureLayer(GL_READ_FRAMEBUFFER,
+                                         GL_COLOR_ATTACHMENT0,
+                                         array.getTextureId(), level - 1,
+                                         layer);
+            _gl->framebufferTextureLayer(GL_DRAW_FRAMEBUFFER,
+                                         GL_COLOR_ATTACHMENT0,
+                                         array.getTextureId(), level, layer);
+            _gl->blitFramebuffer(0, 0, src.width(), src.height(), 0, 0,
+                                 dst.width(), dst.height(),
+                                 GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        }
+        ++_statistics.mipmapsGenerated;
+    }
+
+    gl->glBindFramebuffer(GL_READ_FRAMEBUFFER, GLuint(readFramebuffer));
+    gl->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, GLuint(drawFramebuffer));
+    gl->glDeleteFramebuffers(2, framebuffers);
+    if (scissor)
+        gl->glEnable(GL_SCISSOR_TEST);
+}
+
+TextureLayerPtr TextureUploader::acquireSharedLayer(const ImagePtr& image)
+{
+    if (!_sharingEnabled)
+        return nullptr;
+
+    const auto layer = _sharedTextures->acquireLayer(image);
+    if (!layer.array)
+        return nullptr;
+
+    // The layer must not be sampled before the upload is complete
+    if (layer.fence)
+        _gl->waitSync(layer.fence, 0, GL_TIMEOUT_IGNORED);
+
+    ++_statistics.uploadsSaved;
+    _statistics.bytesSaved += image->getDataSize(0);
+    return std::make_unique<TextureLayer>(layer.array, layer.index);
+}
+
+bool TextureUploader::claimLayer(const TextureLayer& layer)
+{
+    const auto& array = *layer.getArray();
+    if (array.getContext() != _context ||
+        !_sharedTextures->claimLayer(array.getTextureId(), layer.getIndex()))
+    {
+        return false;
+    }
+    _waitForRelease(array.getTextureId(), layer.getIndex());
+    return true;
+}
+
+void TextureUploader::shareLayer(const ImagePtr& image,
+                                 const TextureLayer& layer)
+{
+    if (!_sharesTextures())
+        return;
+
+    generateMipmaps(*layer.getArray());
+
+    // The other contexts wait on the fence, which must reach the GPU first
+    const auto fence = _gl->fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _context->functions()->glFlush();
+    _sharedTextures->addLayer(image,
+                              {layer.getArray(), layer.getIndex(), fence});
+}
+
+void TextureUploader::releaseLayer(TextureArray& array, const uint index)
+{
+    // The context of the array writes its layers in the order of its commands
+    const auto fence =
+        array.getContext() != _context ? _createReleaseFence() : nullptr;
+    if (!_sharedTextures->releaseLayer(array.getTextureId(), index, fence))
+        array.releaseLayer(index);
+}
+
+TextureUploader::Statistics TextureUploader::endFrame()
+{
+    if (_offset > 0)
+        _nextSegment();
+
+    _collectTextureArrays();
+    _deleteExpiredFences();
+
+    _budgetUsed = 0;
+    _visibleDeferredLastFrame = _visibleDeferred;
+    _visibleDeferred = false;
+
+    const auto statistics = _statistics;
+    _statistics = Statistics();
+    return statistics;
+}
+
+void TextureUploader::_createRing(const size_t segments)
+{
+    const auto size = segments * _segmentSize;
+    const auto flags =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    auto gl = _context->functions();
+    gl->glGenBuffers(1, &_buffer);
+    gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _buffer);
+    _gl->bufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, flags);
+    _mappedData = static_cast<uint8_t*>(
+        _gl->mapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags));
+    gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (!_mappedData)
+    {
+        gl->glDeleteBuffers(1, &_buffer);
+        _buffer = 0;
+        return;
+    }
+    _fences.resize(segments, nullptr);
+}
+
+void TextureUploader::_destroy()
+{
+    auto gl = _context->functions();
+
+    for (auto fence : _fences)
+        if (fence)
+            _gl->deleteSync(fence);
+    _fences.clear();
+
+    if (_buffer)
+    {
+        gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _buffer);
+        _gl->unmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        gl->glDeleteBuffers(1, &_buffer);
+        _buffer = 0;
+        _mappedData = nullptr;
+    }
+
+    // The pool of a share group is deleted with its last context
+    if (_sharedTextures.use_count() == 1)
+    {
+        for (const auto id : _sharedTextures->takePooledTextures())
+            gl->glDeleteTextures(1, &id);
+    }
+
+    // Arrays still used by nodes are deleted along with them
+    for (const auto& array : _textureArrays)
+        _sharedTextures->expireReleaseFences(array->getTextureId());
+    _textureArrays.clear();
+
+    _deleteExpiredFences();
+
+    _fallbackPbo.reset();
+}
+
+bool TextureUploader::_reserve(const size_t bytes, size_t& offset)
+{
+    if (!_mappedData || bytes > _segmentSize)
+        return false;
+
+    if (_offset + bytes > _segmentSize)
+        _nextSegment();
+
+    if (_offset == 0)
+        _waitForSegment(_segment);
+
+    offset = _segment * _segmentSize + _offset;
+    _offset += _align(bytes);
+    return true;
+}
+
+const void* TextureUploader::_stage(const Image& image, const uint plane)
+{
+    const auto bytes = image.getDataSize(plane);
+    size_t offset = 0;
+    if (!_reserve(bytes, offset))
+        return _uploadToFallbackPbo(image, plane);
+
+    std::memcpy(_mappedData + offset, image.getData(plane), bytes);
+    _context->functions()->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _buffer);
+    return reinterpret_cast<const void*>(offset);
+}
+
+void TextureUploader::_nextSegment()
+{
+    _fences[_segment] = _gl->fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _segment = (_segment + 1) % _fences.size();
+    _offset = 0;
+}
+
+void TextureUploader::_waitForSegment(const size_t segment)
+{
+    auto& fence = _fences[segment];
+    if (!fence)
+        return;
+
+    const auto start = Clock::now();
+    while (_gl->clientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                               fenceTimeoutNs) == GL_TIMEOUT_EXPIRED)
+    {
+    }
+    _statistics.stallTime += std::chrono::duration_cast<
+        std::chrono::microseconds>(Clock::now() - start);
+
+    _gl->deleteSync(fence);
+    fence = nullptr;
+}
+
+const void* TextureUploader::_uploadToFallbackPbo(const Image& image,
+                                                  const uint plane)
+{
+    if (!_fallbackPbo)
+    {
+        _fallbackPbo.reset(new QOpenGLBuffer(QOpenGLBuffer::PixelUnpackBuffer));
+        _fallbackPbo->setUsagePattern(QOpenGLBuffer::StreamDraw);
+        _fallbackPbo->create();
+    }
+
+    const auto bytes = image.getDataSize(plane);
+    const auto start = Clock::now();
+
+    // Orphan the previous storage so that map() does not wait for the GPU
+    _fallbackPbo->bind();
+    _fallbackPbo->allocate(bytes);
+    auto data = _fallbackPbo->map(QOpenGLBuffer::WriteOnly);
+
+    _statistics.stallTime += std::chrono::duration_cast<
+        std::chrono::microseconds>(Clock::now() - start);
+
+    if (!data)
+    {
+        // Mapping is not supported (OpenGL ES 2), upload from client memory
+        _fallbackPbo->release();
+        return image.getData(plane);
+    }
+    std::memcpy(data, image.getData(plane), bytes);
+    _fallbackPbo->unmap();
+    return nullptr; // offset in the bound PBO
+}
+
+TextureArrayPtr TextureUploader::_createTextureArray(const QSize& size,
+                                                    const uint compressedFormat)
+{
+    const auto layers = _getTextureArrayLayers(size, compressedFormat != 0);
+
+    auto gl = _context->functions();
+    auto textureId = GLuint{0};
+    gl->glGenTextures(1, &textureId);
+    gl->glBindTexture(GL_TEXTURE_2D_ARRAY, textureId);
+    // All levels are allocated: the mipmaps of compressed layers are uploaded
+    // and those of RGBA layers are generated for each layer separately.
+    const auto internalFormat = compressedFormat ? compressedFormat : GL_RGBA8;
+    for (uint level = 0; level < _getMipmapLevels(size); ++level)
+    {
+        const auto levelSize = _getLevelSize(size, level);
+        _gl->texImage3D(GL_TEXTURE_2D_ARRAY, level, GLint(internalFormat),
+                        levelSize.width(), levelSize.height(), layers, 0,
+                        GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+    gl->glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER,
+                        GL_LINEAR_MIPMAP_LINEAR);
+    gl->glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    gl->glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S,
+                        GL_CLAMP_TO_EDGE);
+    gl->glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T,
+                        GL_CLAMP_TO_EDGE);
+    gl->glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    return std::make_shared<TextureArray>(textureId, size, layers,
+                                          compressedFormat);
+}
+
+void TextureUploader::_collectTextureArrays()
+{
+    size_t spareArrays = 0;
+    auto it = _textureArrays.begin();
+    while (it != _textureArrays.end())
+    {
+        auto& array = **it;
+        _statistics.arrayBinds += array.takeBindCount();
+        _statistics.arrayLayers += array.getUsedLayers();
+
+        // Arrays without layers in use are only referenced by the uploader
+        if (array.getUsedLayers() == 0 && ++spareArrays > maxSpareTextureArrays)
+        {
+            _sharedTextures->expireReleaseFences(array.getTextureId());
+            it = _textureArrays.erase(it);
+        }
+        else
+            ++it;
+    }
+    _statistics.textureArrays = _textureArrays.size();
+}
+
+void TextureUploader::_deleteExpiredFences()
+{
+    for (auto fence : _sharedTextures->takeExpiredFences())
+        _gl->deleteSync(fence);
+}
+
+bool TextureUploader::_sharesTextures() const
+{
+    // Contexts which do not share their objects form a group of their own
+    return _sharingEnabled && _context->shareGroup()->shares().size() > 1;
+}
+
+void* TextureUploader::_createReleaseFence()
+{
+    if (!_sharesTextures())
+        return nullptr;
+
+    // Another context may write the texture next, see _waitForRelease()
+    const auto fence = _gl->fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _context->functions()->glFlush();
+    return fence;
+}
+
+void TextureUploader::_waitForRelease(const uint textureId, const uint index)
+{
+    // The wait is queued on the GPU, the fence can be deleted right away
+    for (auto fence : _sharedTextures->takeReleaseFences(textureId, index))
+    {
+        _gl->waitSync(fence, 0, GL_TIMEOUT_IGNORED);
+        _gl->deleteSync(fence);
+    }
+}
@@ -0,0 +1,389 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef TEXTUREUPLOADER_H
+#define TEXTUREUPLOADER_H
+
+#include "types.h"
+
+#include "TextureArray.h"
+
+#include <QSize>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+class QOpenGLBuffer;
+class QOpenGLContext;
+class SharedTextures;
+
+/**
+ * Upload images to textures through a ring of persistently mapped PBOs.
+ *
+ * There is one uploader per OpenGL context, obtained with current(). The ring
+ * is divided in segments which are filled one after the other. A fence is
+ * inserted when moving on to the next segment and waited on before the
+ * segment is written again, so that in the common case the CPU never waits
+ * for the driver. Contexts without ARB_buffer_storage and uploads larger than
+ * a segment go through an orphaned PBO which is mapped for each upload.
+ *
+ * The uploader also keeps a pool of released textures which are reused for
+ * the next textures of the same size and format.
+ *
+ * When the contexts of the screens of a process share their objects, the
+ * uploaders of the share group register the textures of the images they upload
+ * so that the other screens sample them instead of uploading the same images
+ * again, including the static tiles uploaded to texture arrays. The pool of
+ * released textures is also common to the group. Every handoff between
+ * contexts is fenced: uploads before they are sampled, releases before the
+ * texture is written again. Sharing can be disabled by setting the
+ * TIDE_TEXTURE_SHARING environment variable to 0.
+ *
+ * To keep frame times steady, the uploads of static content are limited to a
+ * budget of bytes per frame. Images which do not fit are deferred to the next
+ * frames, see acquireBudget().
+ *
+ * Images in a compressed format are uploaded with their precomputed mipmaps, if
+ * the context supports the format (see hasCompressedTextures()).
+ *
+ * On OpenGL 3.0 and above, the uploader also manages the TextureArray used to
+ * batch the rendering of static tiles. Batching can be disabled by setting the
+ * TIDE_TILE_BATCHING environment variable to 0.
+ */
+class TextureUploader
+{
+public:
+    /** Priority of an upload with respect to the frame budget. */
+    enum class Priority
+    {
+        dynamic,  // movies and streams, never deferred
+        visible,  // static content in the visible area of the screen
+        prefetch, // static content outside of the visible area
+    };
+
+    /** Upload statistics, collected between two calls to endFrame(). */
+    struct Statistics
+    {
+        size_t uploads = 0;
+        size_t bytes = 0;
+        size_t deferred = 0;
+        size_t mipmapsGenerated = 0;
+        size_t mipmapsSkipped = 0;
+        size_t texturesCreated = 0;
+        size_t texturesReused = 0;
+        size_t textureArrays = 0;
+        size_t arrayLayers = 0;
+        size_t arrayBinds = 0;
+        size_t uploadsSaved = 0;
+        size_t bytesSaved = 0;
+        std::chrono::microseconds stallTime{0};
+    };
+
+    /**
+     * @return the uploader of the current OpenGL context, created on first use.
+     * @throw std::runtime_error if there is no current OpenGL context.
+     */
+    static TextureUploader& current();
+
+    /** @return the uploader of the current OpenGL context, if it exists. */
+    static TextureUploader* find();
+
+    /**
+     * Return a texture to the pool of the current context.
+     *
+     * The texture is deleted if the current context has no uploader.
+     * @param textureId the OpenGL texture
+     * @param size of the texture
+     * @param internalFormat of the texture (GL_R8, GL_RGBA8 or compressed)
+     */
+    static void recycle(uint textureId, const QSize& size, uint internalFormat);
+
+    /**
+     * Create an uploader for the current OpenGL context.
+     * @param segments number of segments in the ring, at least 2
+     * @param segmentSize the size of each segment in bytes
+     * @throw std::runtime_error if there is no current OpenGL context.
+     */
+    explicit TextureUploader(size_t segments = 3,
+                             size_t segmentSize = 32 * 1024 * 1024);
+    ~TextureUploader();
+
+    /** @return true if the uploads use persistently mapped buffers. */
+    bool isPersistent() const;
+
+    /**
+     * Upload a plane of an image to a texture.
+     * @param image the source image
+     * @param plane the texture plane of the source image
+     * @param textureId the target texture, of the size of the plane
+     * @param glFormat the OpenGL pixel format of the image data
+     * @param mipmaps generate the mipmaps of the texture after the upload
+     */
+    void upload(const Image& image, uint plane, uint textureId, uint glFormat,
+                bool mipmaps = true);
+
+    /**
+     * Generate the mipmaps of a texture uploaded without them.
+     * @param textureId the texture, with its base level uploaded
+     */
+    void generateMipmaps(uint textureId);
+
+    /** @return true if the context supports the format of CompressedImage. */
+    bool hasCompressedTextures() const;
+
+    /**
+     * Upload all the mipmap levels of a compressed image to a texture.
+     * @param image the source image, in a supported compressed format
+     * @param textureId the target texture, of the size and format of the image
+     */
+    void uploadCompressed(const Image& image, uint textureId);
+
+    /**
+     * Get the texture of an image plane uploaded by another context.
+     *
+     * The GPU of the current context waits for the upload to complete before
+     * sampling the texture.
+     * @param image the source image
+     * @param plane the texture plane of the source image
+     * @param mipmaps true if the texture must have mipmaps
+     * @return the OpenGL texture, referenced by the caller until it is
+     *         recycled, or 0 if there is none
+     */
+    uint acquireSharedTexture(const ImagePtr& image, uint plane, bool mipmaps);
+
+    /**
+     * Claim a texture before uploading a new image to it.
+     *
+     * The GPU of the current context waits for the other contexts which
+     * released the texture to stop sampling it.
+     * @param textureId the OpenGL texture, owned by the caller
+     * @return false if the texture is still used by another context, in which
+     *         case the caller should upload to a new texture instead.
+     */
+    bool claimTexture(uint textureId);
+
+    /**
+     * Make an uploaded image plane available to the other contexts.
+     * @param image the source image
+     * @param plane the texture plane of the source image
+     * @param textureId the OpenGL texture, owned by the caller
+     * @param mipmaps true if the mipmaps of the texture were generated
+     */
+    void shareTexture(const ImagePtr& image, uint plane, uint textureId,
+                      bool mipmaps);
+
+    /**
+     * Get a texture from the pool, or create it.
+     *
+     * Same as claimTexture(), a pooled texture is only written once the
+     * context which released it no longer samples it.
+     * @param size of the texture
+     * @param internalFormat of the texture (GL_R8, GL_RGBA8 or compressed)
+     * @return the OpenGL texture, owned by the caller
+     */
+    uint acquireTexture(const QSize& size, uint internalFormat);
+
+    /**
+     * Put a texture in the pool, deleting the oldest ones if it is full.
+     *
+     * A texture which is still used by another context is only released. When
+     * the contexts share textures, the release is fenced for the next writer.
+     * @param textureId the OpenGL texture, owned by the pool after the call
+     * @param size of the texture
+     * @param internalFormat of the texture (GL_R8, GL_RGBA8 or compressed)
+     */
+    void releaseTexture(uint textureId, const QSize& size, uint internalFormat);
+
+    /** @return the number of textures in the pool. */
+    size_t getPooledTexturesCount() const;
+
+    /** @return true if static tiles can be batched in texture arrays. */
+    bool hasTextureArrays() const;
+
+    /**
+     * Get a free layer in a texture array, creating a new array if needed.
+     *
+     * The GPU of the current context waits for the other contexts which
+     * released the layer to stop sampling it.
+     * @param size of the layer
+     * @param compressedFormat of the layer, 0 for RGBA
+     * @return the layer, returned to its array when destroyed
+     * @throw std::runtime_error if texture arrays are not supported
+     */
+    TextureLayerPtr acquireLayer(const QSize& size, uint compressedFormat = 0);
+
+    /**
+     * Upload an RGBA or compressed image to a layer of a texture array.
+     *
+     * The mipmaps of an RGBA layer are generated when its array is next bound,
+     * those of a compressed image are uploaded with it.
+     * @param image the source image, of the size of the layer
+     * @param layer the target layer
+     */
+    void uploadToLayer(const Image& image, const TextureLayer& layer);
+
+    /**
+     * Generate the mipmaps of the layers uploaded since the previous call.
+     *
+     * Each level is downsampled from the previous one with a framebuffer blit,
+     * so the other layers of the array are left untouched.
+     * @param array the RGBA texture array
+     */
+    void generateMipmaps(TextureArray& array);
+
+    /**
+     * Get the texture array layer of an image uploaded by another context.
+     *
+     * The GPU of the current context waits for the upload to complete before
+     * sampling the layer.
+     * @param image the source image
+     * @return the layer, or nullptr if there is none
+     */
+    TextureLayerPtr acquireSharedLayer(const ImagePtr& image);
+
+    /**
+     * Claim a layer before uploading a new image to it, see claimTexture().
+     * @param layer the layer
+     * @return false if the layer belongs to an array of another context or is
+     *         still used by another context, in which case the caller should
+     *         acquire a new layer instead.
+     */
+    bool claimLayer(const TextureLayer& layer);
+
+    /**
+     * Make an image uploaded to a layer available to the other contexts.
+     *
+     * The mipmaps of the layer are generated first, since the other contexts
+     * can not write the array.
+     * @param image the source image
+     * @param layer the layer, uploaded with uploadToLayer()
+     */
+    void shareLayer(const ImagePtr& image, const TextureLayer& layer);
+
+    /**
+     * Release a reference to a layer, called when a TextureLayer is destroyed.
+     *
+     * The layer returns to its array when no other context uses it. The
+     * release of the layer of another context's array is fenced.
+     * @param array the array of the layer
+     * @param index of the layer in the array
+     */
+    void releaseLayer(TextureArray& array, uint index);
+
+    /**
+     * Set the maximum number of bytes of static content uploaded per frame.
+     * @param bytes the budget, 0 for unlimited
+     */
+    void setFrameBudget(size_t bytes);
+
+    /**
+     * Set the frame budget of the uploaders created after this call.
+     * @param bytes the budget, 0 for unlimited
+     */
+    static void setDefaultFrameBudget(size_t bytes);
+
+    /**
+     * Request the budget to upload an image during the current frame.
+     *
+     * Dynamic content is always accepted, but consumes the budget. Visible
+     * content is accepted while the budget lasts, and at least one image per
+     * frame so that it always makes progress. Prefetched content is accepted
+     * while the budget lasts, but only if no visible content was deferred
+     * during this frame or the previous one. Images already uploaded by
+     * another context are always accepted without consuming the budget.
+     * @param image the image to upload
+     * @param priority of the upload
+     * @return true if the image can be uploaded now, false if it should be
+     *         deferred to a later frame.
+     */
+    bool acquireBudget(const Image& image, Priority priority);
+
+    /**
+     * Mark the end of a frame, allowing the ring to move to the next segment.
+     * @return the statistics of the uploads since the previous call.
+     */
+    Statistics endFrame();
+
+private:
+    struct GLFunctions;
+
+    QOpenGLContext* _context = nullptr;
+    std::unique_ptr<GLFunctions> _gl;
+
+    uint _buffer = 0;
+    uint8_t* _mappedData = nullptr;
+    const size_t _segmentSize;
+    std::vector<void*> _fences;
+    size_t _segment = 0;
+    size_t _offset = 0;
+    std::unique_ptr<QOpenGLBuffer> _fallbackPbo;
+
+    Statistics _statistics;
+
+    static size_t _defaultFrameBudget;
+    size_t _frameBudget;
+    size_t _budgetUsed = 0;
+    bool _visibleDeferred = false;
+    bool _visibleDeferredLastFrame = false;
+
+    bool _textureArraysEnabled = false;
+    bool _compressedTextures = false;
+    std::vector<TextureArrayPtr> _textureArrays;
+
+    bool _sharingEnabled = false;
+    std::shared_ptr<SharedTextures> _sharedTextures;
+
+    void _createRing(size_t segments);
+    void _destroy();
+    bool _reserve(size_t bytes, size_t& offset);
+    const void* _stage(const Image& image, uint plane);
+    void _nextSegment();
+    void _waitForSegment(size_t segment);
+    const void* _uploadToFallbackPbo(const Image& image, uint plane);
+    TextureArrayPtr _createTextureArray(const QSize& size,
+                                        uint compressedFormat);
+    void _collectTextureArrays();
+    void _deleteExpiredFences();
+    bool _sharesTextures() const;
+    void* _createReleaseFence();
+    void _waitForRelease(uint textureId, uint index = 0);
+};
+
+#endif
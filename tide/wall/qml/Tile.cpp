@@ -40,13 +40,15 @@
 #include "qml/Tile.h"
 
 #include "TextureNodeFactory.h"
+#include "TilePool.h"
+#include "WallWindow.h"
 #include "utils/log.h"
 
 #include <QSGNode>
 
 TilePtr Tile::create(const uint id, const QRect& rect, const TextureType type)
 {
-    return TilePtr{new Tile{id, rect, type}};
+    return TilePool::instance().acquire(id, rect, type);
 }
 
 // false-positive on qt signals for Q_PROPERTY notifiers
@@ -79,6 +81,7 @@ void Tile::setShowBorder(const bool set)
 
     _textureSwitcher.showBorder = set;
     emit showBorderChanged();
+    addDamage();
     QQuickItem::update();
 }
 
@@ -89,6 +92,7 @@ void Tile::update(const QRect& rect)
     if (_type == TextureType::dynamic)
         emit requestNextFrame(shared_from_this());
 
+    addDamage();
     QQuickItem::update();
 }
 
@@ -113,6 +117,7 @@ void Tile::updateBackTexture(ImagePtr image, TilePtr self)
     // There is no need to check for upload completion in _updateTextureNode.
     emit readyToSwap(std::move(self));
 
+    addDamage();
     QQuickItem::update();
 }
 
@@ -121,6 +126,15 @@ void Tile::setSizePolicy(const SizePolicy policy)
     _policy = policy;
 }
 
+void Tile::addDamage()
+{
+    if (auto wallWindow = qobject_cast<WallWindow*>(window()))
+    {
+        const auto rect = mapRectToScene(boundingRect());
+        wallWindow->addDamage(rect.united(_getNextSceneRect()));
+    }
+}
+
 void Tile::swapImage()
 {
     _textureSwitcher.requestSwap();
@@ -134,6 +148,7 @@ void Tile::swapImage()
         setSize(_nextCoord.size());
     }
 
+    addDamage();
     QQuickItem::update();
 }
 
@@ -142,8 +157,18 @@ QSGNode* Tile::updatePaintNode(QSGNode* node, QQuickItem::UpdatePaintNodeData*)
     auto textureNode =
         std::unique_ptr<TextureNode>(dynamic_cast<TextureNode*>(node));
 
+    const auto sceneRect = _getNextSceneRect();
+    _textureSwitcher.setScreenSize(sceneRect.size() *
+                                   window()->devicePixelRatio());
+
+    // Deferred uploads are retried in the next frames, which the WallWindow
+    // keeps rendering as long as the TextureUploader reports deferred uploads
+    const auto upload = _acquireUploadBudget(sceneRect);
+    if (!upload)
+        QMetaObject::invokeMethod(this, "update", Qt::QueuedConnection);
+
     TextureNodeFactoryImpl factory{*window(), _type};
-    _textureSwitcher.update(textureNode, factory);
+    _textureSwitcher.update(textureNode, factory, upload);
     if (!textureNode)
         return nullptr;
 
@@ -154,6 +179,58 @@ QSGNode* Tile::updatePaintNode(QSGNode* node, QQuickItem::UpdatePaintNodeData*)
     return dynamic_cast<QSGNode*>(textureNode.release());
 }
 
+QRectF Tile::_getNextSceneRect() const
+{
+    // Before the swap, AdjustToTexture tiles still have their previous size
+    if (_policy == AdjustToTexture && parentItem())
+        return parentItem()->mapRectToScene(_nextCoord);
+    return mapRectToScene(boundingRect());
+}
+
+TextureUploader::Priority Tile::_getUploadPriority(const QRectF& rect) const
+{
+    if (_type == TextureType::dynamic)
+        return TextureUploader::Priority::dynamic;
+
+    const auto windowRect = QRectF{QPointF(), window()->size()};
+    return rect.intersects(windowRect) ? TextureUploader::Priority::visible
+                                       : TextureUploader::Priority::prefetch;
+}
+
+bool Tile::_acquireUploadBudget(const QRectF& sceneRect) const
+{
+    const auto& image = _textureSwitcher.getNextImage();
+    if (!image)
+        return true;
+
+    auto& uploader = TextureUploader::current();
+    return uploader.acquireBudget(*image, _getUploadPriority(sceneRect));
+}
+
+void Tile::_reset(const uint id, const QRect& rect, const TextureType type)
+{
+    _tileId = id;
+    _type = type;
+    _policy = AdjustToTexture;
+    _firstImageUploaded = false;
+    _nextCoord = rect;
+
+    setVisible(false);
+    setPosition(QPointF());
+    setSize(QSizeF());
+}
+
+void Tile::_detach()
+{
+    setParentItem(nullptr);
+
+    disconnect(this, &Tile::requestNextFrame, nullptr, nullptr);
+    disconnect(this, &Tile::readyToSwap, nullptr, nullptr);
+    disconnect(this, &Tile::showBorderChanged, nullptr, nullptr);
+
+    _textureSwitcher.reset();
+}
+
 void Tile::_onParentChanged(QQuickItem* newParent)
 {
     if (!newParent)
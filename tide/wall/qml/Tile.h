@@ -43,6 +43,7 @@
 #include "types.h"
 
 #include "TextureBorderSwitcher.h"
+#include "TextureUploader.h"
 
 #include <QQuickItem> // parent
 #include <memory>     // std::enable_shared_from_this
@@ -67,7 +68,7 @@ public:
     };
 
     /**
-     * Create a shared Tile.
+     * Create a shared Tile, reusing a released one from the TilePool if any.
      * @param id the unique identifier for the tile
      * @param rect the nominal coordinates of the tile
      * @param type the type of texture (static/dynamic)
@@ -93,6 +94,9 @@ public:
      */
     void setSizePolicy(SizePolicy policy);
 
+    /** Damage the current and next area of the tile in its WallWindow. */
+    void addDamage();
+
 public slots:
     /**
      * Upload the given image to the back texture.
@@ -131,7 +135,9 @@ signals:
     void readyToSwap(TilePtr tile);
 
 private:
-    const uint _tileId = 0;
+    friend class TilePool;
+
+    uint _tileId = 0;
     TextureType _type = TextureType::static_;
     SizePolicy _policy = AdjustToTexture;
 
@@ -141,10 +147,21 @@ private:
 
     Tile(uint id, const QRect& rect, TextureType type);
 
+    /** Reinitialize a pooled tile to the state of a newly created one. */
+    void _reset(uint id, const QRect& rect, TextureType type);
+
+    /** Detach a released tile from the scene and free its pending image. */
+    void _detach();
+
     /** Called on the render thread to update the scene graph. */
     QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData*) final;
     void _onParentChanged(QQuickItem* newParent);
 
+    /** @return the area covered by the next texture in scene coordinates. */
+    QRectF _getNextSceneRect() const;
+    TextureUploader::Priority _getUploadPriority(const QRectF& rect) const;
+    bool _acquireUploadBudget(const QRectF& sceneRect) const;
+
     QMetaObject::Connection _widthConn;
     QMetaObject::Connection _heightConn;
 };
@@ -0,0 +1,120 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "TilePool.h"
+
+#include "qml/Tile.h"
+
+#include <QCoreApplication>
+#include <QThread>
+
+TilePool& TilePool::instance()
+{
+    static TilePool pool;
+    // Tiles are QObjects, delete them along with the application
+    static const bool cleanup = (qAddPostRoutine(&TilePool::_shutdown), true);
+    Q_UNUSED(cleanup);
+    return pool;
+}
+
+TilePool::TilePool(const size_t maxSize)
+    : _maxSize{maxSize}
+{
+}
+
+TilePool::~TilePool()
+{
+    clear();
+}
+
+TilePtr TilePool::acquire(const uint id, const QRect& rect,
+                          const TextureType type)
+{
+    auto deleter = [this](Tile* tile) { _release(tile); };
+
+    if (_tiles.empty())
+    {
+        ++_statistics.created;
+        return TilePtr{new Tile{id, rect, type}, deleter};
+    }
+
+    auto tile = _tiles.back().release();
+    _tiles.pop_back();
+    tile->_reset(id, rect, type);
+    ++_statistics.reused;
+    _statistics.pooled = _tiles.size();
+    return TilePtr{tile, deleter};
+}
+
+void TilePool::clear()
+{
+    _tiles.clear();
+    _statistics.pooled = 0;
+}
+
+TilePool::Statistics TilePool::getStatistics() const
+{
+    return _statistics;
+}
+
+void TilePool::_release(Tile* tile)
+{
+    if (QThread::currentThread() != tile->thread())
+    {
+        tile->deleteLater();
+        return;
+    }
+
+    if (!_enabled || _tiles.size() >= _maxSize)
+    {
+        delete tile;
+        return;
+    }
+
+    tile->_detach();
+    _tiles.emplace_back(tile);
+    _statistics.pooled = _tiles.size();
+}
+
+void TilePool::_shutdown()
+{
+    auto& pool = instance();
+    pool.clear();
+    pool._enabled = false;
+}
@@ -0,0 +1,112 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef TILEPOOL_H
+#define TILEPOOL_H
+
+#include "types.h"
+
+#include <QRect>
+
+#include <memory>
+#include <vector>
+
+/**
+ * Pool of Tile items reused across windows and contents.
+ *
+ * Panning across a large content creates and destroys many tiles, and
+ * creating QQuickItems is costly. The tiles returned by acquire() go back to
+ * the pool when their last TilePtr is released, to be reinitialized for
+ * another window or content. Each acquisition has a new shared ownership, so
+ * the weak pointers held by pending image loads expire on release even though
+ * the item itself is reused.
+ *
+ * The pool must only be used from the GUI thread. Tiles released from another
+ * thread are deleted later instead of being pooled.
+ */
+class TilePool
+{
+public:
+    /** Pool statistics, since the creation of the pool. */
+    struct Statistics
+    {
+        size_t created = 0;
+        size_t reused = 0;
+        size_t pooled = 0;
+    };
+
+    /** @return the pool shared by all the windows of the application. */
+    static TilePool& instance();
+
+    /**
+     * Create a pool.
+     * @param maxSize the maximum number of pooled tiles, released tiles
+     *        beyond it are deleted.
+     */
+    explicit TilePool(size_t maxSize = 1024);
+
+    /** Delete the pooled tiles, the pool must outlive the acquired ones. */
+    ~TilePool();
+
+    /**
+     * Get a tile from the pool, or create it.
+     * @param id the unique identifier for the tile
+     * @param rect the nominal coordinates of the tile
+     * @param type the type of texture (static/dynamic)
+     * @return a tile in the same state as a newly created one
+     */
+    TilePtr acquire(uint id, const QRect& rect, TextureType type);
+
+    /** Delete the pooled tiles. */
+    void clear();
+
+    /** @return the statistics of the pool. */
+    Statistics getStatistics() const;
+
+private:
+    const size_t _maxSize;
+    std::vector<std::unique_ptr<Tile>> _tiles;
+    Statistics _statistics;
+    bool _enabled = true;
+
+    void _release(Tile* tile);
+    static void _shutdown();
+};
+
+#endif
@@ -42,6 +42,7 @@
 #include "DataProvider.h"
 #include "DisplayGroupRenderer.h"
 #include "scene/Background.h"
+#include "scene/ContextMenu.h"
 #include "scene/CountdownStatus.h"
 #include "scene/DisplayGroup.h"
 #include "scene/Markers.h"
@@ -59,6 +60,9 @@ namespace
 {
 const QUrl QML_CONTROL_SURFACE_URL("qrc:/qml/wall/WallControlSurface.qml");
 const QUrl QML_BASIC_SURFACE_URL("qrc:/qml/wall/WallBasicSurface.qml");
+
+// Transition of the countdown overlay (countdownTransitionTime in style.js)
+const auto countdownTransitionTime = std::chrono::milliseconds{1500};
 }
 
 WallSurfaceRenderer::WallSurfaceRenderer(WallRenderContext context,
@@ -70,6 +74,7 @@ WallSurfaceRenderer::WallSurfaceRenderer(WallRenderContext context,
     , _options{Options::create()}
     , _screenLock{ScreenLock::create()}
     , _countdownStatus{new CountdownStatus}
+    , _damage{_context.screenRect}
 {
     _setContextProperties();
     _createSurfaceItem(parentItem);
@@ -82,6 +87,8 @@ WallSurfaceRenderer::~WallSurfaceRenderer()
 
 void WallSurfaceRenderer::setSurface(SurfacePtr surface)
 {
+    _addSurfaceDamage(*surface);
+
     _setBackground(surface->getBackground());
     _qmlContext.setContextProperty("contextmenu", &surface->getContextMenu());
     // SideControls need a displaygroup
@@ -96,12 +103,14 @@ void WallSurfaceRenderer::setMarkers(MarkersPtr markers)
     if (markers->getSurfaceIndex() != _context.surfaceIndex)
         return;
 
+    _damage.addChanges(*_markers, *markers);
     _qmlContext.setContextProperty("markers", markers.get());
     _markers = std::move(markers); // Retain the new Markers
 }
 
 void WallSurfaceRenderer::setRenderingOptions(OptionsPtr options)
 {
+    _damage.addScreenTransition();
     _qmlContext.setContextProperty("options", options.get());
     _surfaceItem->setVisible(!options->getShowTestPattern());
     _options = std::move(options); // Retain the new Options
@@ -109,19 +118,38 @@ void WallSurfaceRenderer::setRenderingOptions(OptionsPtr options)
 
 void WallSurfaceRenderer::setScreenLock(ScreenLockPtr lock)
 {
+    _damage.addScreenTransition();
     _qmlContext.setContextProperty("lock", lock.get());
     _screenLock = std::move(lock); // Retain the new ScreenLock
 }
 
 void WallSurfaceRenderer::setCountdownStatus(CountdownStatusPtr status)
 {
+    const auto duration = std::chrono::milliseconds{status->getDuration()};
+    _damage.addScreenTransition(duration + countdownTransitionTime);
     _qmlContext.setContextProperty("countdownStatus", status.get());
     _countdownStatus = std::move(status);
 }
 
 bool WallSurfaceRenderer::needRedraw() const
 {
-    return _options->getShowStatistics() || _options->getShowClock();
+    return _options->getShowStatistics() || _options->getShowClock() ||
+           _damage.hasTransitions();
+}
+
+bool WallSurfaceRenderer::isDamaged() const
+{
+    return needRedraw() || _damage.isDamaged();
+}
+
+void WallSurfaceRenderer::addDamage(const QRectF& area)
+{
+    _damage.add(area.translated(_context.screenRect.topLeft()));
+}
+
+void WallSurfaceRenderer::clearDamage()
+{
+    _damage.clear();
 }
 
 void WallSurfaceRenderer::updateRenderedFrames()
@@ -176,3 +204,23 @@ bool WallSurfaceRenderer::_hasBackgroundChanged(const QString& newUri) const
 {
     return newUri != _surface->getBackground().getUri();
 }
+
+void WallSurfaceRenderer::_addSurfaceDamage(Surface& surface)
+{
+    const auto& background = surface.getBackground();
+    const auto& oldBackground = _surface->getBackground();
+    const auto& menu = surface.getContextMenu();
+    const auto& oldMenu = _surface->getContextMenu();
+
+    if (background.getUri() != oldBackground.getUri() ||
+        background.getColor() != oldBackground.getColor() ||
+        background.getText() != oldBackground.getText() ||
+        menu.isVisible() != oldMenu.isVisible() ||
+        menu.getPosition() != oldMenu.getPosition() ||
+        menu.getCopiedUris() != oldMenu.getCopiedUris())
+    {
+        _damage.addScreenTransition();
+        return;
+    }
+    _damage.addChanges(_surface->getGroup(), surface.getGroup());
+}
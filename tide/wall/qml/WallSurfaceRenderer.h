@@ -44,6 +44,7 @@
 
 #include "BackgroundRenderer.h"
 #include "WallRenderContext.h"
+#include "tools/DamageTracker.h"
 
 #include <QObject>
 
@@ -83,9 +84,21 @@ public:
     /** Set countdown status used to display the inactivity timeout. */
     void setCountdownStatus(CountdownStatusPtr status);
 
-    /** @return true if the renderer requires a redraw. */
+    /**
+     * @return true if the renderer requires a redraw, which includes the
+     *         duration of the Qml transitions triggered by scene updates.
+     */
     bool needRedraw() const;
 
+    /** @return true if the next frame differs from the displayed one. */
+    bool isDamaged() const;
+
+    /** Damage an area of the screen, in window coordinates. */
+    void addDamage(const QRectF& area);
+
+    /** Clear the damage once a frame has been rendered. */
+    void clearDamage();
+
 public slots:
     /** Increment number of rendered/swapped frames for FPS display. */
     void updateRenderedFrames();
@@ -99,6 +112,7 @@ private:
     OptionsPtr _options;
     ScreenLockPtr _screenLock;
     CountdownStatusPtr _countdownStatus;
+    DamageTracker _damage;
 
     std::unique_ptr<QQuickItem> _surfaceItem;
     std::unique_ptr<BackgroundRenderer> _backgroundRenderer;
@@ -110,6 +124,7 @@ private:
 
     void _setBackground(const Background& background);
     bool _hasBackgroundChanged(const QString& newUri) const;
+    void _addSurfaceDamage(Surface& surface);
     void _adjustBackgroundTo(const DisplayGroup& displayGroup);
 };
 
@@ -42,6 +42,7 @@
 #include "WallConfiguration.h"
 #include "WallRenderContext.h"
 #include "qml/TestPattern.h"
+#include "qml/TextureUploader.h"
 #include "qml/WallSurfaceRenderer.h"
 #include "qml/qscreens.h"
 #include "scene/Background.h"
@@ -53,11 +54,19 @@
 
 #include <deflect/qt/QuickRenderer.h>
 
+#include <QOpenGLBuffer>
 #include <QOpenGLContext>
 #include <QOpenGLFunctions>
 #include <QQmlEngine>
 #include <QQuickRenderControl>
 #include <QThread>
+#include <QTimer>
+
+namespace
+{
+// Give the asynchronous readback about one frame to complete before mapping
+const int readbackDelayMs = 16;
+}
 
 WallWindowPtr WallWindow::create(const WallConfiguration& config,
                                  const uint windowIndex, DataProvider& provider)
@@ -138,17 +147,33 @@ bool WallWindow::isInitialized() const
 
 bool WallWindow::needRedraw() const
 {
-    return _surfaceRenderer->needRedraw();
+    // A grab deferred by a pending readback needs another frame
+    return _surfaceRenderer->needRedraw() || _uploadsDeferred || _grabImage;
 }
 
 void WallWindow::render(const bool grab)
 {
-    _grabImage = grab;
+    if (!grab && _canSkipFrame())
+    {
+        _skipFrame();
+        return;
+    }
+
+    // A grab which could not start yet is kept for the next frames
+    if (grab)
+        _grabImage = true;
+    _firstFrameRendered = true;
+    _surfaceRenderer->clearDamage();
 
     _renderControl->polishItems();
     _quickRenderer->render();
 }
 
+void WallWindow::addDamage(const QRectF& area)
+{
+    _surfaceRenderer->addDamage(area);
+}
+
 void WallWindow::setSurface(SurfacePtr surface)
 {
     setColor(surface->getBackground().getColor());
@@ -202,8 +227,31 @@ void WallWindow::_startQuickRenderer()
     _quickRendererThread->start();
     _quickRenderer->init();
 
+    // Screens only reuse each other's textures if their contexts are shared
+    const auto shareContext = QOpenGLContext::globalShareContext();
+    if (!shareContext ||
+        !QOpenGLContext::areSharing(_quickRenderer->context(), shareContext))
+    {
+        print_log(LOG_INFO, LOG_GENERAL,
+                  "%s: OpenGL context is not shared, textures will be "
+                  "uploaded separately for each screen",
+                  qPrintable(_quickRendererThread->objectName()));
+    }
+
+    // Measures the CPU time of the scene graph sync and render passes
+    connect(this, &QQuickWindow::beforeSynchronizing, this,
+            [this] { _sceneGraphTimer.start(); }, Qt::DirectConnection);
+
     connect(_quickRenderer.get(), &deflect::qt::QuickRenderer::afterRender,
             [this] {
+                _endUploadFrame();
+
+                if (_grabImage && !_readbackPending)
+                {
+                    _startReadback();
+                    _grabImage = false;
+                }
+
                 if (_synchronizer)
                     _synchronizer->globalBarrier(*this);
 
@@ -212,20 +260,143 @@ void WallWindow::_startQuickRenderer()
                 QMetaObject::invokeMethod(_surfaceRenderer.get(),
                                           "updateRenderedFrames",
                                           Qt::QueuedConnection);
-                if (_grabImage)
-                {
-                    emit imageGrabbed(_renderControl->grab(), _globalIndex);
-                    _grabImage = false;
-                }
             });
 
     connect(_quickRenderer.get(), &deflect::qt::QuickRenderer::stopping,
             [this] {
                 if (_synchronizer)
                     _synchronizer->exitBarrier(*this);
+
+                _quickRenderer->context()->makeCurrent(this);
+                _readbackBuffer.reset();
             });
 }
 
+bool WallWindow::_canSkipFrame() const
+{
+    if (!_firstFrameRendered || _uploadsDeferred || _grabImage ||
+        _surfaceRenderer->isDamaged())
+    {
+        return false;
+    }
+    return !_synchronizer || _synchronizer->canSkipSwap();
+}
+
+void WallWindow::_skipFrame()
+{
+    // The front buffer keeps displaying the last frame. The barrier must still
+    // be entered from the render thread, like the windows which render do.
+    if (_synchronizer)
+        QTimer::singleShot(0, _quickRenderer.get(),
+                           [this] { _synchronizer->globalBarrier(*this); });
+}
+
+void WallWindow::_endUploadFrame()
+{
+    auto uploader = TextureUploader::find();
+    if (!uploader)
+        return;
+
+    const auto stats = uploader->endFrame();
+    _uploadsDeferred = stats.deferred > 0;
+    print_log(LOG_VERBOSE, LOG_GENERAL,
+              "%s: scene graph %d us, %d tiles in %d texture arrays drawn "
+              "with %d draw calls",
+              qPrintable(_quickRendererThread->objectName()),
+              int(_sceneGraphTimer.nsecsElapsed() / 1000),
+              int(stats.arrayLayers), int(stats.textureArrays),
+              int(stats.arrayBinds));
+    if (stats.uploads > 0 || stats.deferred > 0)
+    {
+        print_log(LOG_VERBOSE, LOG_GENERAL,
+                  "%s: uploaded %d textures (%.2f MB), deferred %d, "
+                  "stalled %d us, mipmaps generated: %d skipped: %d",
+                  qPrintable(_quickRendererThread->objectName()),
+                  int(stats.uploads), stats.bytes / (1024.0 * 1024.0),
+                  int(stats.deferred), int(stats.stallTime.count()),
+                  int(stats.mipmapsGenerated), int(stats.mipmapsSkipped));
+    }
+    if (stats.uploadsSaved > 0)
+    {
+        print_log(LOG_VERBOSE, LOG_GENERAL,
+                  "%s: reused %d textures of other screens, saved %.2f MB "
+                  "of uploads",
+                  qPrintable(_quickRendererThread->objectName()),
+                  int(stats.uploadsSaved),
+                  stats.bytesSaved / (1024.0 * 1024.0));
+    }
+    if (stats.texturesCreated > 0 || stats.texturesReused > 0)
+    {
+        print_log(LOG_VERBOSE, LOG_GENERAL,
+                  "%s: texture pool: %d created, %d reused, %d pooled",
+                  qPrintable(_quickRendererThread->objectName()),
+                  int(stats.texturesCreated), int(stats.texturesReused),
+                  int(uploader->getPooledTexturesCount()));
+    }
+}
+
+void WallWindow::_startReadback()
+{
+    _readbackSize = size() * devicePixelRatio();
+    const auto bytes = _readbackSize.width() * _readbackSize.height() * 4;
+
+    if (!_readbackBuffer)
+    {
+        _readbackBuffer =
+            std::make_unique<QOpenGLBuffer>(QOpenGLBuffer::PixelPackBuffer);
+        _readbackBuffer->setUsagePattern(QOpenGLBuffer::StreamRead);
+        _readbackBuffer->create();
+    }
+    _readbackBuffer->bind();
+    if (_readbackBuffer->size() != bytes)
+        _readbackBuffer->allocate(bytes);
+
+    // Read the back buffer into the PBO before the swap; the transfer
+    // completes asynchronously and is only mapped after the next frames.
+    auto gl = _quickRenderer->context()->functions();
+    gl->glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    gl->glReadPixels(0, 0, _readbackSize.width(), _readbackSize.height(),
+                     GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    _readbackBuffer->release();
+
+    _readbackPending = true;
+    QTimer::singleShot(readbackDelayMs, _quickRenderer.get(),
+                       [this] { _finishReadback(); });
+}
+
+void WallWindow::_finishReadback()
+{
+    _readbackPending = false;
+    if (!_readbackBuffer)
+        return;
+
+    _quickRenderer->context()->makeCurrent(this);
+
+    const auto bytes = _readbackBuffer->size();
+    _readbackBuffer->bind();
+    const auto data = static_cast<const uchar*>(
+        _readbackBuffer->mapRange(0, bytes, QOpenGLBuffer::RangeRead));
+
+    QImage image;
+    if (data)
+    {
+        // OpenGL rows are bottom-up, mirrored() also detaches from the PBO
+        image = QImage{data, _readbackSize.width(), _readbackSize.height(),
+                       QImage::Format_RGBX8888}
+                    .mirrored();
+        _readbackBuffer->unmap();
+    }
+    _readbackBuffer->release();
+
+    if (image.isNull())
+    {
+        print_log(LOG_WARN, LOG_GENERAL,
+                  "could not map the readback buffer, using grab()");
+        image = _renderControl->grab();
+    }
+    emit imageGrabbed(image, _globalIndex);
+}
+
 void WallWindow::_setupScene(const WallConfiguration& config,
                              const uint windowIndex)
 {
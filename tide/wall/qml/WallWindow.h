@@ -44,8 +44,12 @@
 
 #include <deflect/qt/types.h>
 
+#include <QElapsedTimer>
 #include <QQuickWindow>
 
+#include <atomic>
+
+class QOpenGLBuffer;
 class QQuickRenderControl;
 class QQmlEngine;
 
@@ -89,15 +93,22 @@ public:
     void setSwapSynchronizer(SwapSynchronizer* synchronizer);
 
     bool isInitialized() const;
+
+    /** @return true if the content changed or texture uploads are pending. */
     bool needRedraw() const;
 
     /**
      * Synchronize scene objects with render thread and trigger frame rendering.
      *
+     * Frames without damage are skipped, the window only entering the swap
+     * barrier to stay synchronized with the others.
      * @param grab indicate that the frame should be grabbed after rendering.
      */
     void render(bool grab = false);
 
+    /** Damage an area of the window, which is redrawn in the next frame. */
+    void addDamage(const QRectF& area);
+
     /** Set new surface. */
     void setSurface(SurfacePtr surface);
 
@@ -114,7 +125,10 @@ public:
     void setRenderOptions(OptionsPtr options);
 
 signals:
-    /** Emitted after syncAndRender() has been called with grab set to true. */
+    /**
+     * Emitted after render() has been called with grab set to true, once the
+     * frame has been read back asynchronously from the GPU.
+     */
     void imageGrabbed(QImage image, QPoint index);
 
 private:
@@ -125,6 +139,11 @@ private:
     void exposeEvent(QExposeEvent* exposeEvent) final;
 
     void _startQuickRenderer();
+    bool _canSkipFrame() const;
+    void _skipFrame();
+    void _endUploadFrame();
+    void _startReadback();
+    void _finishReadback();
     void _setupScene(const WallConfiguration& config, uint windowIndex);
 
     DataProvider& _provider;
@@ -134,7 +153,13 @@ private:
 
     std::unique_ptr<QQuickRenderControl> _renderControl;
     SwapSynchronizer* _synchronizer = nullptr;
-    bool _grabImage = false;
+    std::atomic<bool> _grabImage{false};
+    bool _firstFrameRendered = false;
+    bool _readbackPending = false;
+    std::atomic<bool> _uploadsDeferred{false};
+    QElapsedTimer _sceneGraphTimer;
+    QSize _readbackSize;
+    std::unique_ptr<QOpenGLBuffer> _readbackBuffer;
 
     std::unique_ptr<deflect::qt::QuickRenderer> _quickRenderer;
     std::unique_ptr<QThread> _quickRendererThread;
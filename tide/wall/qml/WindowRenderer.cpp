@@ -82,8 +82,14 @@ WindowRenderer::~WindowRenderer()
     if (_zoomContextTile)
         _removeZoomContextTile();
 
+    // Tiles may be reused by other windows, disconnect them from this one
+    auto tilesParent = _getTilesParentItem();
     for (auto& tile : _tiles)
+    {
+        tile.second->disconnect(_synchronizer.get());
+        tilesParent->disconnect(tile.second.get());
         tile.second->setParentItem(nullptr);
+    }
     _tiles.clear();
 }
 
@@ -112,7 +118,7 @@ void WindowRenderer::_addTile(TilePtr tile, const uint zOrder)
 
     _tiles[tile->getId()] = tile;
 
-    auto item = _windowItem->findChild<QQuickItem*>(TILES_PARENT_OBJECT_NAME);
+    auto item = _getTilesParentItem();
     tile->setParentItem(item->childItems().at(zOrder));
 
     connect(item, SIGNAL(showTilesBordersValueChanged(bool)), tile.get(),
@@ -122,6 +128,11 @@ void WindowRenderer::_addTile(TilePtr tile, const uint zOrder)
     tile->requestNextFrame(tile);
 }
 
+QQuickItem* WindowRenderer::_getTilesParentItem() const
+{
+    return _windowItem->findChild<QQuickItem*>(TILES_PARENT_OBJECT_NAME);
+}
+
 QQuickItem* WindowRenderer::_getZoomContextParentItem() const
 {
     return _windowItem->findChild<QQuickItem*>(ZOOM_CONTEXT_PARENT_OBJECT_NAME);
@@ -170,6 +181,8 @@ void WindowRenderer::_removeTile(const uint tileIndex)
 
     auto& tile = tileIt->second;
     tile->disconnect(_synchronizer.get());
+    _getTilesParentItem()->disconnect(tile.get());
+    tile->addDamage();
     tile->setParentItem(nullptr);
     _tiles.erase(tileIt);
 }
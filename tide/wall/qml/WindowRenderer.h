@@ -79,6 +79,7 @@ private:
     TilePtr _zoomContextTile;
 
     void _addTile(TilePtr tile, uint lod);
+    QQuickItem* _getTilesParentItem() const;
     QQuickItem* _getZoomContextParentItem() const;
     void _updateZoomContextTile(bool visible);
     void _addZoomContextTile();
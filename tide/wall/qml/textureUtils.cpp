@@ -39,100 +39,153 @@
 
 #include "textureUtils.h"
 
-#include "data/Image.h"
+#include "TextureUploader.h"
+#include "data/CompressedImage.h"
+#include "data/QtImage.h"
 
-#include <QOpenGLBuffer>
-#include <QOpenGLContext>
 #include <QOpenGLFunctions>
 #include <QQuickWindow>
 #include <QSGTexture>
 
-#include <cstring> // std::memcpy
+#include <algorithm>
+
+namespace
+{
+// Linear filtering samples every texel down to a half-size minification
+const qreal mipmapScaleThreshold = 0.5;
+}
 
 namespace textureUtils
 {
-void upload(const Image& image, const uint srcTextureIdx, QOpenGLBuffer& pbo)
+bool needMipmaps(const QSize& imageSize, const QSizeF& screenSize,
+                 const bool dynamic)
 {
-    pbo.bind();
-    const auto size = image.getDataSize(srcTextureIdx);
-    if (size_t(pbo.size()) != size)
-        pbo.allocate(size);
-    auto pboData = pbo.map(QOpenGLBuffer::WriteOnly);
-    std::memcpy(pboData, image.getData(srcTextureIdx), size);
-    pbo.unmap();
-    pbo.release();
+    if (!dynamic || !screenSize.isValid() || imageSize.isEmpty())
+        return true;
+
+    const auto scaleX = screenSize.width() / imageSize.width();
+    const auto scaleY = screenSize.height() / imageSize.height();
+    return std::min(scaleX, scaleY) < mipmapScaleThreshold;
 }
 
-GLint _getUnpackAlignment(const uint textureWidth)
+void TextureRecycler::operator()(QSGTexture* texture) const
 {
-    if (textureWidth % 4 == 0)
-        return 4;
-    if (textureWidth % 2 == 0)
-        return 2;
-    return 1;
+    if (texture->textureId())
+    {
+        TextureUploader::recycle(texture->textureId(), texture->textureSize(),
+                                 internalFormat);
+    }
+    delete texture;
 }
 
-void copy(QOpenGLBuffer& pbo, QSGTexture& texture, const uint glTexFormat)
+TexturePtr createEmptyTexture(QQuickWindow& window)
 {
-    auto gl = QOpenGLContext::currentContext()->functions();
-
-    const auto textureSize = texture.textureSize();
-
-    gl->glPixelStorei(GL_UNPACK_ALIGNMENT,
-                      _getUnpackAlignment(textureSize.width()));
-
-    texture.bind();
-    pbo.bind();
-    gl->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, textureSize.width(),
-                        textureSize.height(), glTexFormat, GL_UNSIGNED_BYTE, 0);
-    pbo.release();
-    gl->glGenerateMipmap(GL_TEXTURE_2D);
+    return TexturePtr{window.createTextureFromId(0, QSize(1, 1))};
 }
 
-std::unique_ptr<QSGTexture> createTexture(const QSize& size,
-                                          QQuickWindow& window)
+TexturePtr createTexture(const QSize& size, QQuickWindow& window)
 {
-    auto gl = QOpenGLContext::currentContext()->functions();
+    auto& uploader = TextureUploader::current();
+    const auto textureID = uploader.acquireTexture(size, GL_R8);
+
+    // The GL texture is owned by the TextureRecycler
+    const auto textureFlags =
+        QQuickWindow::CreateTextureOptions(QQuickWindow::TextureHasMipmaps);
+    return TexturePtr{window.createTextureFromId(textureID, size, textureFlags),
+                      TextureRecycler{GL_R8}};
+}
 
-    auto textureID = GLuint{0};
-    gl->glGenTextures(1, &textureID);
-    gl->glBindTexture(GL_TEXTURE_2D, textureID);
-    gl->glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, size.width(), size.height(), 0,
-                     GL_RED, GL_UNSIGNED_BYTE, nullptr);
+TexturePtr createTextureRgba(const QSize& size, QQuickWindow& window)
+{
+    auto& uploader = TextureUploader::current();
+    const auto textureID = uploader.acquireTexture(size, GL_RGBA8);
 
+    // The GL texture is owned by the TextureRecycler
     const auto textureFlags = QQuickWindow::CreateTextureOptions(
-        QQuickWindow::TextureOwnsGLTexture | QQuickWindow::TextureHasMipmaps);
-    return std::unique_ptr<QSGTexture>{
-        window.createTextureFromId(textureID, size, textureFlags)};
+        QQuickWindow::TextureHasMipmaps | QQuickWindow::TextureHasAlphaChannel);
+    return TexturePtr{window.createTextureFromId(textureID, size, textureFlags),
+                      TextureRecycler{GL_RGBA8}};
 }
 
-std::unique_ptr<QSGTexture> createTextureRgba(const QSize& size,
-                                              QQuickWindow& window)
+TexturePtr createCompressedTexture(const QSize& size,
+                                   const uint compressedFormat,
+                                   QQuickWindow& window)
 {
-    auto gl = QOpenGLContext::currentContext()->functions();
+    auto& uploader = TextureUploader::current();
+    const auto textureID = uploader.acquireTexture(size, compressedFormat);
+
+    // The GL texture is owned by the TextureRecycler
+    const auto textureFlags =
+        QQuickWindow::CreateTextureOptions(QQuickWindow::TextureHasMipmaps);
+    return TexturePtr{window.createTextureFromId(textureID, size, textureFlags),
+                      TextureRecycler{compressedFormat}};
+}
 
-    auto textureID = GLuint{0};
-    gl->glActiveTexture(GL_TEXTURE0);
-    gl->glGenTextures(1, &textureID);
-    gl->glBindTexture(GL_TEXTURE_2D, textureID);
-    gl->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size.width(), size.height(), 0,
-                     GL_RGBA, GL_UNSIGNED_BYTE, 0);
-    gl->glBindTexture(GL_TEXTURE_2D, 0);
+TexturePtr acquireSharedTexture(const ImagePtr& image, const uint plane,
+                                const bool mipmaps, QQuickWindow& window)
+{
+    auto& uploader = TextureUploader::current();
+    const auto textureID = uploader.acquireSharedTexture(image, plane, mipmaps);
+    if (!textureID)
+        return TexturePtr();
+
+    // The reference to the GL texture is released by the TextureRecycler
+    auto textureFlags =
+        QQuickWindow::CreateTextureOptions(QQuickWindow::TextureHasMipmaps);
+    auto internalFormat = uint(GL_R8);
+    if (const auto compressedFormat = image->getGLCompressedFormat())
+    {
+        internalFormat = compressedFormat;
+    }
+    else if (image->getFormat() == TextureFormat::rgba)
+    {
+        textureFlags |= QQuickWindow::TextureHasAlphaChannel;
+        internalFormat = GL_RGBA8;
+    }
+    return TexturePtr{window.createTextureFromId(
+                          textureID, image->getTextureSize(plane),
+                          textureFlags),
+                      TextureRecycler{internalFormat}};
+}
 
-    const auto textureFlags = QQuickWindow::CreateTextureOptions(
-        QQuickWindow::TextureOwnsGLTexture | QQuickWindow::TextureHasMipmaps |
-        QQuickWindow::TextureHasAlphaChannel);
-    return std::unique_ptr<QSGTexture>{
-        window.createTextureFromId(textureID, size, textureFlags)};
+void addMipmaps(TexturePtr& texture, const ImagePtr& image, const uint plane,
+                QQuickWindow& window)
+{
+    auto& uploader = TextureUploader::current();
+    if (uploader.claimTexture(texture->textureId()))
+    {
+        uploader.generateMipmaps(texture->textureId());
+        uploader.shareTexture(image, plane, texture->textureId(), true);
+        return;
+    }
+
+    // Writing a texture sampled by another screen would race with it
+    if (auto shared = acquireSharedTexture(image, plane, true, window))
+    {
+        texture = std::move(shared);
+        return;
+    }
+
+    const auto size = image->getTextureSize(plane);
+    texture = image->getFormat() == TextureFormat::rgba
+                  ? createTextureRgba(size, window)
+                  : createTexture(size, window);
+    const auto textureId = texture->textureId();
+    uploader.upload(*image, plane, textureId, image->getGLPixelFormat(), true);
+    uploader.shareTexture(image, plane, textureId, true);
 }
 
-std::unique_ptr<QOpenGLBuffer> createPbo(const bool dynamic)
+ImagePtr toSupportedFormat(const ImagePtr& image)
 {
-    auto pbo =
-        std::make_unique<QOpenGLBuffer>(QOpenGLBuffer::PixelUnpackBuffer);
-    pbo->create();
-    pbo->setUsagePattern(dynamic ? QOpenGLBuffer::DynamicDraw
-                                 : QOpenGLBuffer::StaticDraw);
-    return pbo;
+    if (!image->getGLCompressedFormat() ||
+        TextureUploader::current().hasCompressedTextures())
+    {
+        return image;
+    }
+
+    const auto compressed = std::dynamic_pointer_cast<CompressedImage>(image);
+    if (!compressed)
+        throw std::runtime_error("unsupported compressed image");
+    return std::make_shared<QtImage>(compressed->decompress());
 }
 } // namespace textureUtils
@@ -42,7 +42,6 @@
 
 #include "types.h"
 
-class QOpenGLBuffer;
 class QSGTexture;
 class QQuickWindow;
 
@@ -52,49 +51,104 @@ class QQuickWindow;
 namespace textureUtils
 {
 /**
- * Create a 8-bit texture.
+ * Check if a texture needs mipmaps.
+ *
+ * Static textures are uploaded once and can later be displayed at any scale,
+ * they always need mipmaps. Dynamic textures are re-uploaded continuously and
+ * only need them when they are minified beyond what linear filtering handles
+ * without aliasing.
+ *
+ * @param imageSize the size of the displayed image area in pixels.
+ * @param screenSize the size of the image on screen in pixels, invalid if
+ *        unknown.
+ * @param dynamic true if the texture is updated continuously.
+ */
+bool needMipmaps(const QSize& imageSize, const QSizeF& screenSize,
+                 bool dynamic);
+
+/** Deleter returning the GL texture to the TextureUploader pool. */
+struct TextureRecycler
+{
+    uint internalFormat = 0; // of the GL texture, 0 for the empty texture
+    void operator()(QSGTexture* texture) const;
+};
+using TexturePtr = std::unique_ptr<QSGTexture, TextureRecycler>;
+
+/**
+ * Create an empty texture (id 0), which renders black.
+ *
+ * @param window the QQuickWindow needed to create a QSGTexture wrapper.
+ * @return a QSGTexture, or nullptr if the window has no scene graph.
+ */
+TexturePtr createEmptyTexture(QQuickWindow& window);
+
+/**
+ * Create a 8-bit texture, reusing a released one of the same size if possible.
  *
  * @param size in pixels.
  * @param window the QQuickWindow needed to create a QSGTexture wrapper.
- * @return a QSGTexture owning its GL texture.
+ * @return a QSGTexture returning its GL texture to the pool when deleted.
  */
-std::unique_ptr<QSGTexture> createTexture(const QSize& size,
-                                          QQuickWindow& window);
+TexturePtr createTexture(const QSize& size, QQuickWindow& window);
+
 /**
- * Create a 32-bit RGBA texture.
+ * Create a 32-bit RGBA texture, reusing a released one of the same size if
+ * possible.
  *
  * @param size in pixels.
  * @param window the QQuickWindow needed to create a QSGTexture wrapper.
- * @return a QSGTexture owning its GL texture.
+ * @return a QSGTexture returning its GL texture to the pool when deleted.
  */
-std::unique_ptr<QSGTexture> createTextureRgba(const QSize& size,
-                                              QQuickWindow& window);
+TexturePtr createTextureRgba(const QSize& size, QQuickWindow& window);
 
 /**
- * Create a Pixel Buffer Object.
+ * Create an opaque compressed texture with all its mipmap levels, reusing a
+ * released one of the same size and format if possible.
  *
- * @param dynamic true if the buffer is going to be updated frequently.
- * @return empty, ready-to-use pbo.
+ * @param size in pixels.
+ * @param compressedFormat the OpenGL compressed format of the texture.
+ * @param window the QQuickWindow needed to create a QSGTexture wrapper.
+ * @return a QSGTexture returning its GL texture to the pool when deleted.
  */
-std::unique_ptr<QOpenGLBuffer> createPbo(bool dynamic);
+TexturePtr createCompressedTexture(const QSize& size, uint compressedFormat,
+                                   QQuickWindow& window);
 
 /**
- * Upload an image to a PBO.
+ * Get an image that the current OpenGL context can upload.
  *
- * @param image the source image
- * @param srcTextureIdx the texture plane of the source image.
- * @param pbo the target PBO, will be resized to the image size.
+ * @param image the source image.
+ * @return the image, or a decompressed copy of it if the context does not
+ *         support its compressed format.
  */
-void upload(const Image& image, const uint srcTextureIdx, QOpenGLBuffer& pbo);
+ImagePtr toSupportedFormat(const ImagePtr& image);
 
 /**
- * Copy a PBO to a GPU texture.
+ * Get the texture of an image plane uploaded by another screen of the process.
  *
- * @param pbo the source PBO.
- * @param texture the target texture, must be of the same size as the PBO.
- * @param glTexFormat the format of the OpenGL texture.
+ * @param image the source image.
+ * @param plane the texture plane of the source image.
+ * @param mipmaps true if the texture must have mipmaps.
+ * @param window the QQuickWindow needed to create a QSGTexture wrapper.
+ * @return a QSGTexture releasing the shared GL texture when deleted, or
+ *         nullptr if the image plane has no shared texture.
+ */
+TexturePtr acquireSharedTexture(const ImagePtr& image, uint plane,
+                                bool mipmaps, QQuickWindow& window);
+
+/**
+ * Add mipmaps to the texture of an uncompressed image plane.
+ *
+ * The mipmaps are generated in place if no other screen samples the texture,
+ * which is then shared again with its mipmaps. Otherwise the texture is
+ * replaced by a copy with mipmaps, shared by another screen or uploaded.
+ *
+ * @param texture the texture, replaced by a copy if needed.
+ * @param image the source image of the texture.
+ * @param plane the texture plane of the source image.
+ * @param window the QQuickWindow needed to create a QSGTexture wrapper.
  */
-void copy(QOpenGLBuffer& pbo, QSGTexture& texture, uint glTexFormat);
+void addMipmaps(TexturePtr& texture, const ImagePtr& image, uint plane,
+                QQuickWindow& window);
 }
 
 #endif
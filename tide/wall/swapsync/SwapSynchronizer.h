@@ -57,6 +57,12 @@ public:
 
     /** Remove a window from the barrier, sequentially for each window. */
     virtual void exitBarrier(const QWindow& window) = 0;
+
+    /**
+     * @return true if a window may skip a frame by entering the barrier
+     *         without swapping its buffers.
+     */
+    virtual bool canSkipSwap() const = 0;
 };
 
 /**
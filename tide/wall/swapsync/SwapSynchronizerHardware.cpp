@@ -93,3 +93,9 @@ void SwapSynchronizerHardware::exitBarrier(const QWindow& window)
     if (_hardwareSwapGroup.size() == 0)
         _initialized = false;
 }
+
+bool SwapSynchronizerHardware::canSkipSwap() const
+{
+    // The swap group only releases the buffers once all its members swapped
+    return false;
+}
@@ -77,6 +77,7 @@ public:
 
     void globalBarrier(const QWindow& window) final;
     void exitBarrier(const QWindow& window) final;
+    bool canSkipSwap() const final;
 
 private:
     NetworkBarrier& _networkBarrier;
@@ -48,3 +48,8 @@ void SwapSynchronizerSoftware::exitBarrier(const QWindow&)
 {
     /* NOP */
 }
+
+bool SwapSynchronizerSoftware::canSkipSwap() const
+{
+    return true;
+}
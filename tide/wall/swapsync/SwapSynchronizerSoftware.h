@@ -54,6 +54,7 @@ public:
 
     void globalBarrier(const QWindow& window) final;
     void exitBarrier(const QWindow& window) final;
+    bool canSkipSwap() const final;
 };
 
 #endif
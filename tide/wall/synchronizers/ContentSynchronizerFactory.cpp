@@ -43,6 +43,7 @@
 #include "scene/Content.h"
 #include "scene/MultiChannelContent.h"
 
+#include "datasources/ImageTiler.h"
 #include "datasources/PixelStreamUpdater.h"
 #include "synchronizers/BasicSynchronizer.h"
 #include "synchronizers/LodSynchronizer.h"
@@ -101,6 +102,8 @@ std::unique_ptr<ContentSynchronizer> ContentSynchronizerFactory::create(
     }
     case ContentType::image:
     {
+        if (std::dynamic_pointer_cast<ImageTiler>(source))
+            return std::make_unique<LodSynchronizer>(source);
         return std::make_unique<BasicSynchronizer>(source, view);
     }
     default:
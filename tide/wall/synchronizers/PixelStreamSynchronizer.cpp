@@ -61,6 +61,7 @@ PixelStreamSynchronizer::PixelStreamSynchronizer(
 PixelStreamSynchronizer::~PixelStreamSynchronizer()
 {
     _updater->synchronizers.deregister(this);
+    _updater->setDisplayScale(this, 0.0);
 }
 
 void PixelStreamSynchronizer::update(const Window& window,
@@ -71,6 +72,8 @@ void PixelStreamSynchronizer::update(const Window& window,
     const auto visibleTilesArea =
         ZoomHelper{window}.toTilesArea(visibleArea, tilesSurface);
 
+    _updater->setDisplayScale(this, _computeDisplayScale(window));
+
     if (_visibleTilesArea == visibleTilesArea)
         return;
 
@@ -129,8 +132,19 @@ void PixelStreamSynchronizer::_setTilesArea(const QSize& tilesArea)
     emit tilesAreasChanged();
 }
 
+qreal PixelStreamSynchronizer::_computeDisplayScale(const Window& window) const
+{
+    const auto streamSize = window.getContent().getDimensions();
+    if (streamSize.isEmpty())
+        return 1.0;
+
+    const auto displaySize = ZoomHelper{window}.getContentRect().size();
+    return std::max(displaySize.width() / streamSize.width(),
+                    displaySize.height() / streamSize.height());
+}
+
 void PixelStreamSynchronizer::_onPictureUpdated()
 {
     markTilesDirty();
-    markExistingTilesDirty();
+    markExistingTilesDirty(_updater->getUnchangedTiles(_view));
 }
@@ -86,6 +86,7 @@ private:
     QSize _getTilesArea(uint lod) const final;
 
     void _setTilesArea(const QSize& tilesArea);
+    qreal _computeDisplayScale(const Window& window) const;
     void _onPictureUpdated();
 
     std::shared_ptr<PixelStreamUpdater> _updater;
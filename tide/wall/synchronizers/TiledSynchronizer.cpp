@@ -68,17 +68,20 @@ void TiledSynchronizer::updateTiles()
     const auto visibleSet = _computeVisibleTilesAndAddMissingOnes();
     const auto removedTiles = set_difference(_visibleSet, visibleSet);
 
+    // Visible tiles which are unchanged keep their current texture
+    const auto skippedTiles = set_intersection(_visibleSet, _unchangedTiles);
+
     if (_updateExistingTiles)
     {
         const auto currentTiles = set_difference(_visibleSet, removedTiles);
-        _updateTiles(currentTiles);
+        _updateTiles(set_difference(currentTiles, skippedTiles));
     }
 
     if (_policy == SwapTilesSynchronously)
     {
         if (_updateExistingTiles)
         {
-            _syncSet = visibleSet;
+            _syncSet = set_difference(visibleSet, skippedTiles);
             _syncSwapPending = true;
         }
         else
@@ -92,6 +95,7 @@ void TiledSynchronizer::updateTiles()
 
     _tilesDirty = false;
     _updateExistingTiles = false;
+    _unchangedTiles.clear();
 }
 
 bool TiledSynchronizer::canSwapTiles() const
@@ -127,6 +131,17 @@ void TiledSynchronizer::markTilesDirty()
 void TiledSynchronizer::markExistingTilesDirty()
 {
     _updateExistingTiles = true;
+    _unchangedTiles.clear();
+}
+
+void TiledSynchronizer::markExistingTilesDirty(const Indices& unchangedTiles)
+{
+    // Tiles must have been unchanged since the last update to be skipped
+    if (_updateExistingTiles)
+        _unchangedTiles = set_intersection(_unchangedTiles, unchangedTiles);
+    else
+        _unchangedTiles = unchangedTiles;
+    _updateExistingTiles = true;
 }
 
 Indices TiledSynchronizer::_computeVisibleTilesAndAddMissingOnes()
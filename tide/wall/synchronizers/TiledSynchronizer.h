@@ -89,6 +89,13 @@ protected:
     /** Update texture and coordinates of tiles which are already visible. */
     void markExistingTilesDirty();
 
+    /**
+     * Update texture and coordinates of tiles which are already visible,
+     * except for the given ones which are known to be identical.
+     * @param unchangedTiles which can keep their current texture.
+     */
+    void markExistingTilesDirty(const Indices& unchangedTiles);
+
     /** @return the channel used to obtain the list of visible tiles. */
     virtual uint getChannel() const { return 0; }
 private:
@@ -112,6 +119,7 @@ private:
     Indices _tilesReadySet;
     Indices _syncSet;
     Indices _removeLaterSet;
+    Indices _unchangedTiles;
 
     bool _tilesDirty = true;
     bool _updateExistingTiles = false;
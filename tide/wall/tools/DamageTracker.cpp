@@ -0,0 +1,196 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "DamageTracker.h"
+
+#include "scene/DisplayGroup.h"
+#include "scene/Markers.h"
+#include "scene/Window.h"
+
+#include <algorithm>
+
+namespace
+{
+// Longest Qml transition triggered by a scene change (focusTransitionTime in
+// style.js) with a margin for the frames in flight.
+const auto transitionTime = std::chrono::milliseconds{1000};
+
+// Extent of the decorations drawn around a window (title bar, borders, side
+// buttons and controls), in surface pixels.
+const qreal decorationsMargin = 256.0;
+
+// Extent of a touch point marker around its position, in surface pixels.
+const qreal markerMargin = 32.0;
+
+QRectF _getWindowArea(const Window& window)
+{
+    const auto m = decorationsMargin;
+    return window.getDisplayCoordinates().adjusted(-m, -m, m, m);
+}
+
+QRectF _getMarkerArea(const QPointF& position)
+{
+    const auto m = markerMargin;
+    return QRectF{position, position}.adjusted(-m, -m, m, m);
+}
+
+std::vector<QPointF> _getPositions(const Markers& markers)
+{
+    std::vector<QPointF> positions;
+    for (int i = 0; i < markers.rowCount(); ++i)
+    {
+        const auto index = markers.index(i);
+        positions.emplace_back(
+            markers.data(index, Markers::XPOSITION_ROLE).toReal(),
+            markers.data(index, Markers::YPOSITION_ROLE).toReal());
+    }
+    return positions;
+}
+}
+
+DamageTracker::DamageTracker(const QRect& screenRect)
+    : _screenRect{screenRect}
+{
+}
+
+void DamageTracker::add(const QRectF& area)
+{
+    const auto clipped = area.toAlignedRect() & _screenRect;
+    if (!clipped.isEmpty())
+        _damage += clipped;
+}
+
+void DamageTracker::addTransition(const QRectF& area)
+{
+    addTransition(area, transitionTime);
+}
+
+void DamageTracker::addTransition(const QRectF& area,
+                                  const std::chrono::milliseconds duration)
+{
+    const auto clipped = area.toAlignedRect() & _screenRect;
+    if (!clipped.isEmpty())
+        _transitions.push_back({clipped, clock::now() + duration});
+}
+
+void DamageTracker::addScreenTransition()
+{
+    addTransition(_screenRect, transitionTime);
+}
+
+void DamageTracker::addScreenTransition(
+    const std::chrono::milliseconds duration)
+{
+    addTransition(_screenRect, duration);
+}
+
+void DamageTracker::addChanges(const DisplayGroup& previous,
+                               const DisplayGroup& next)
+{
+    if (previous.getCoordinates() != next.getCoordinates() ||
+        previous.hasFocusedWindows() != next.hasFocusedWindows() ||
+        previous.hasFullscreenWindows() != next.hasFullscreenWindows() ||
+        previous.hasVisiblePanels() != next.hasVisiblePanels())
+    {
+        addScreenTransition();
+        return;
+    }
+
+    const auto& previousWindows = previous.getWindows();
+    const auto& windows = next.getWindows();
+    for (size_t i = 0; i < windows.size(); ++i)
+    {
+        const auto& window = *windows[i];
+        const auto oldWindow = previous.getWindow(window.getID());
+        if (!oldWindow)
+        {
+            addTransition(_getWindowArea(window));
+            continue;
+        }
+
+        const bool restacked = i >= previousWindows.size() ||
+                               previousWindows[i]->getID() != window.getID();
+        if (restacked || oldWindow->getVersion() != window.getVersion())
+        {
+            // Qml animates the windows between the two positions
+            addTransition(
+                _getWindowArea(*oldWindow).united(_getWindowArea(window)));
+        }
+    }
+
+    for (const auto& window : previousWindows)
+    {
+        if (!next.getWindow(window->getID()))
+            addTransition(_getWindowArea(*window));
+    }
+}
+
+void DamageTracker::addChanges(const Markers& previous, const Markers& next)
+{
+    for (const auto& position : _getPositions(previous))
+        add(_getMarkerArea(position));
+    for (const auto& position : _getPositions(next))
+        add(_getMarkerArea(position));
+}
+
+bool DamageTracker::isDamaged() const
+{
+    return !_damage.isEmpty() || hasTransitions();
+}
+
+bool DamageTracker::hasTransitions() const
+{
+    const auto now = clock::now();
+    return std::any_of(_transitions.begin(), _transitions.end(),
+                       [now](const Transition& transition) {
+                           return transition.end > now;
+                       });
+}
+
+void DamageTracker::clear()
+{
+    _damage = QRegion();
+
+    const auto now = clock::now();
+    _transitions.erase(std::remove_if(_transitions.begin(), _transitions.end(),
+                                      [now](const Transition& transition) {
+                                          return transition.end <= now;
+                                      }),
+                       _transitions.end());
+}
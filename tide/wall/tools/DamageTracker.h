@@ -0,0 +1,112 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef DAMAGETRACKER_H
+#define DAMAGETRACKER_H
+
+#include "types.h"
+
+#include <QRegion>
+
+#include <chrono>
+
+/**
+ * Accumulate the areas of a wall screen which must be redrawn.
+ *
+ * Scene changes damage their area until the Qml transitions they trigger have
+ * completed, while tile updates only damage the next frame. All areas are
+ * given in surface coordinates and clipped to the screen.
+ */
+class DamageTracker
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    /** @param screenRect the area of the surface covered by the screen. */
+    explicit DamageTracker(const QRect& screenRect);
+
+    /** Damage an area for the next frame only. */
+    void add(const QRectF& area);
+
+    /** Damage an area until the default Qml transitions have completed. */
+    void addTransition(const QRectF& area);
+
+    /** Damage an area for the given duration. */
+    void addTransition(const QRectF& area, std::chrono::milliseconds duration);
+
+    /** Damage the whole screen until the default transitions completed. */
+    void addScreenTransition();
+
+    /** Damage the whole screen for the given duration. */
+    void addScreenTransition(std::chrono::milliseconds duration);
+
+    /**
+     * Damage the windows which differ between two versions of a group.
+     *
+     * The windows are compared by version and stacking order; changes to the
+     * state of the group itself (focus, fullscreen, panels) damage the whole
+     * screen.
+     */
+    void addChanges(const DisplayGroup& previous, const DisplayGroup& next);
+
+    /** Damage the previous and next positions of touch point markers. */
+    void addChanges(const Markers& previous, const Markers& next);
+
+    /** @return true if the next frame has to be rendered. */
+    bool isDamaged() const;
+
+    /** @return true while transitions are in progress on the screen. */
+    bool hasTransitions() const;
+
+    /** Clear the damage once a frame has been rendered. */
+    void clear();
+
+private:
+    QRect _screenRect;
+    QRegion _damage;
+
+    struct Transition
+    {
+        QRect area;
+        clock::time_point end;
+    };
+    std::vector<Transition> _transitions;
+};
+
+#endif
@@ -0,0 +1,144 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Recycle shared objects once they are no longer referenced elsewhere.
+ *
+ * When the last reference to an object handed out by the pool is released,
+ * the object returns to the pool instead of being deleted. This avoids
+ * reallocating objects (and the buffers they hold) at every frame of dynamic
+ * contents.
+ *
+ * Objects must be acquired from a single thread, but they can be released from
+ * any thread. They are handed back under a mutex, so everything written to an
+ * object before its release is visible to the thread which acquires it next.
+ * Objects released after the destruction of the pool are deleted.
+ */
+template <typename T>
+class ObjectPool
+{
+public:
+    /**
+     * Create a pool.
+     * @param maxSize the maximum number of objects to keep for recycling.
+     */
+    explicit ObjectPool(const size_t maxSize)
+        : _maxSize{maxSize}
+        , _freeList{std::make_shared<FreeList>()}
+    {
+    }
+
+    /**
+     * Get an object which is not referenced outside of the pool.
+     *
+     * Recycled objects are returned in the state they were left, it is up to
+     * the caller to reset them if needed.
+     *
+     * @return a recycled object if available, otherwise a new one.
+     */
+    std::shared_ptr<T> acquire()
+    {
+        if (auto object = _freeList->take())
+        {
+            ++_hits;
+            return _handOut(std::move(object));
+        }
+
+        ++_misses;
+        if (_size >= _maxSize)
+            return std::make_shared<T>();
+        ++_size;
+        return _handOut(std::make_unique<T>());
+    }
+
+    /** @return the number of objects owned by the pool, in use or not. */
+    size_t getSize() const { return _size; }
+    /** @return the number of times a recycled object was returned. */
+    size_t getHits() const { return _hits; }
+    /** @return the number of times a new object had to be created. */
+    size_t getMisses() const { return _misses; }
+private:
+    struct FreeList
+    {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<T>> objects;
+
+        std::unique_ptr<T> take()
+        {
+            const std::lock_guard<std::mutex> lock{mutex};
+            if (objects.empty())
+                return nullptr;
+            auto object = std::move(objects.back());
+            objects.pop_back();
+            return object;
+        }
+
+        void give(std::unique_ptr<T> object)
+        {
+            const std::lock_guard<std::mutex> lock{mutex};
+            objects.push_back(std::move(object));
+        }
+    };
+
+    const size_t _maxSize;
+    const std::shared_ptr<FreeList> _freeList;
+    size_t _size = 0;
+    size_t _hits = 0;
+    size_t _misses = 0;
+
+    std::shared_ptr<T> _handOut(std::unique_ptr<T> object)
+    {
+        const auto freeList = std::weak_ptr<FreeList>{_freeList};
+        const auto recycle = [freeList](T* released) {
+            std::unique_ptr<T> ptr{released};
+            if (auto list = freeList.lock())
+                list->give(std::move(ptr));
+        };
+        return std::shared_ptr<T>{object.release(), recycle};
+    }
+};
+
+#endif
@@ -53,9 +53,10 @@ Indices _mapToGlobalIndices(const Indices& perChannelIndices,
 }
 }
 
-PixelStreamAssembler::PixelStreamAssembler(deflect::server::FramePtr frame)
+PixelStreamAssembler::PixelStreamAssembler(deflect::server::FramePtr frame,
+                                           const uint scaleDivider)
 {
-    if (!_parseChannels(frame))
+    if (!_parseChannels(frame, scaleDivider))
         throw std::runtime_error("This frame cannot be assembled");
 }
 
@@ -66,6 +67,34 @@ ImagePtr PixelStreamAssembler::getTileImage(
     return channel.assembler.getTileImage(tileIndex - channel.offset, decoder);
 }
 
+bool PixelStreamAssembler::setFrame(deflect::server::FramePtr frame)
+{
+    if (frame->tiles.empty() ||
+        frame->tiles.back().channel != _channels.size() - 1)
+    {
+        return false;
+    }
+
+    for (auto& channel : _channels)
+    {
+        if (!channel.assembler.setFrame(frame))
+            return false;
+    }
+    return true;
+}
+
+Indices PixelStreamAssembler::getUnchangedTiles() const
+{
+    Indices unchangedTiles;
+    for (const auto& channel : _channels)
+    {
+        const auto indices = channel.assembler.getUnchangedTiles();
+        const auto globalIndices = _mapToGlobalIndices(indices, channel.offset);
+        unchangedTiles.insert(globalIndices.begin(), globalIndices.end());
+    }
+    return unchangedTiles;
+}
+
 QRect PixelStreamAssembler::getTileRect(const uint tileIndex) const
 {
     const auto& channel = _getChannel(tileIndex);
@@ -89,7 +118,8 @@ size_t PixelStreamAssembler::getTilesCount() const
                            });
 }
 
-bool PixelStreamAssembler::_parseChannels(deflect::server::FramePtr frame)
+bool PixelStreamAssembler::_parseChannels(deflect::server::FramePtr frame,
+                                          const uint scaleDivider)
 {
     if (frame->tiles.empty())
         return false;
@@ -100,7 +130,8 @@ bool PixelStreamAssembler::_parseChannels(deflect::server::FramePtr frame)
         const auto channelIndex = tile.channel;
         if (channelIndex == _channels.size())
         {
-            _channels.emplace_back(frame, channelIndex, tileIndexOffset);
+            _channels.emplace_back(frame, channelIndex, tileIndexOffset,
+                                   scaleDivider);
             tileIndexOffset += _channels.back().tilesCount;
         }
         else if (channelIndex != _channels.size() - 1)
@@ -62,14 +62,23 @@ public:
     /**
      * Create an assembler for the frame.
      * @param frame to assemble with tiles sorted left-right + top-bottom.
+     * @param scaleDivider to decode and assemble the tiles at a reduced
+     *        resolution.
      * @throw std::runtime_error if the frame cannot be assembled.
      */
-    PixelStreamAssembler(deflect::server::FramePtr frame);
+    PixelStreamAssembler(deflect::server::FramePtr frame,
+                         uint scaleDivider = 1);
 
     /** @copydoc PixelStreamProcessor::getTileImage */
     ImagePtr getTileImage(uint tileIndex,
                           deflect::server::TileDecoder& decoder) final;
 
+    /** @copydoc PixelStreamProcessor::setFrame */
+    bool setFrame(deflect::server::FramePtr frame) final;
+
+    /** @copydoc PixelStreamProcessor::getUnchangedTiles */
+    Indices getUnchangedTiles() const final;
+
     /** @copydoc PixelStreamProcessor::getTileRect */
     QRect getTileRect(uint tileIndex) const final;
 
@@ -88,8 +97,8 @@ private:
         const size_t tilesCount = 0;
 
         Channel(deflect::server::FramePtr frame, const uint channel,
-                const size_t offset_)
-            : assembler(frame, channel)
+                const size_t offset_, const uint scaleDivider)
+            : assembler(frame, channel, scaleDivider)
             , offset{offset_}
             , tilesCount{assembler.getTilesCount()}
         {
@@ -97,7 +106,7 @@ private:
     };
     std::vector<Channel> _channels;
 
-    bool _parseChannels(deflect::server::FramePtr frame);
+    bool _parseChannels(deflect::server::FramePtr frame, uint scaleDivider);
     const Channel& _getChannel(uint tileIndex) const;
 };
 
@@ -42,14 +42,16 @@
 #include "data/StreamImage.h"
 #include "utils/log.h"
 
-#include <deflect/server/TileDecoder.h>
-
-#include <cmath> //std::ceil
+#include <algorithm> // std::min
+#include <cmath>     // std::ceil
 
 namespace
 {
 const uint32_t targetTileSize = 512;
 
+// One frame being assembled and two in use by rendering
+const size_t maxPooledFrames = 3;
+
 bool _isValidSize(const uint32_t size)
 {
     return size < targetTileSize && targetTileSize % size == 0;
@@ -76,19 +78,40 @@ std::pair<size_t, size_t> _findRange(const deflect::server::Tiles& sortedTiles,
 }
 
 PixelStreamChannelAssembler::PixelStreamChannelAssembler(
-    deflect::server::FramePtr frame, const uint channel)
+    deflect::server::FramePtr frame, const uint channel,
+    const uint scaleDivider)
     : _frame{frame}
     , _frameSize{_frame->computeDimensions(channel)}
     , _channel{channel}
+    , _scaleDivider{scaleDivider}
+    , _assembledFramesPool{maxPooledFrames}
 {
     std::tie(_begin, _end) = _findRange(_frame->tiles, _channel);
 
-    if (!_canAssemble())
+    if (!_buildGrid())
         throw std::runtime_error("This frame cannot be assembled");
 
     _initTargetFrame();
 }
 
+bool PixelStreamChannelAssembler::setFrame(deflect::server::FramePtr frame)
+{
+    const auto range = _findRange(frame->tiles, _channel);
+    if (!_matchesGrid(*frame, range.first, range.second))
+        return false;
+
+    _unchangedTiles = _findUnchangedTiles(*frame, range.first);
+    _frame = std::move(frame);
+    std::tie(_begin, _end) = range;
+    _initTargetFrame();
+    return true;
+}
+
+Indices PixelStreamChannelAssembler::getUnchangedTiles() const
+{
+    return _unchangedTiles;
+}
+
 ImagePtr PixelStreamChannelAssembler::getTileImage(
     const uint tileIndex, deflect::server::TileDecoder& decoder)
 {
@@ -97,7 +120,8 @@ ImagePtr PixelStreamChannelAssembler::getTileImage(
     _decodeSourceTiles(sourceTiles, decoder);
     _assembleTargetTile(tileIndex, sourceTiles);
 
-    return std::make_shared<StreamImage>(_assembledFrame, tileIndex);
+    return std::make_shared<StreamImage>(_assembledFrame, tileIndex,
+                                         _scaleDivider);
 }
 
 QRect PixelStreamChannelAssembler::getTileRect(const uint tileIndex) const
@@ -121,11 +145,24 @@ Indices PixelStreamChannelAssembler::computeVisibleSet(
     if (channel != _channel)
         throw std::logic_error("computeVisibleSet called with wrong channel");
 
+    const auto frameArea = QRectF{QPointF(), QSizeF(_frameSize)};
+    const auto area = visibleArea.intersected(frameArea);
+    if (area.isEmpty())
+        return Indices{};
+
+    // Tiles only touching the area on their edges are not visible, like with
+    // QRectF::intersects()
+    const uint tilesX = _getTilesX();
+    const uint firstX = area.left() / targetTileSize;
+    const uint firstY = area.top() / targetTileSize;
+    const uint lastX = std::ceil(area.right() / targetTileSize) - 1;
+    const uint lastY = std::ceil(area.bottom() / targetTileSize) - 1;
+
     Indices visibleSet;
-    for (uint tileIndex = 0; tileIndex < getTilesCount(); ++tileIndex)
+    for (auto y = firstY; y <= lastY; ++y)
     {
-        if (visibleArea.intersects(getTileRect(tileIndex)))
-            visibleSet.insert(tileIndex);
+        for (auto x = firstX; x <= lastX; ++x)
+            visibleSet.insert(y * tilesX + x);
     }
     return visibleSet;
 }
@@ -135,57 +172,47 @@ size_t PixelStreamChannelAssembler::getTilesCount() const
     return _getTilesX() * _getTilesY();
 }
 
-bool PixelStreamChannelAssembler::_canAssemble() const
+bool PixelStreamChannelAssembler::_buildGrid()
 {
-    const auto& sortedTiles = _frame->tiles;
-
     if (_end - _begin <= 1)
         return false;
 
-    const auto& firstTile = sortedTiles[_begin];
+    const auto& firstTile = _frame->tiles[_begin];
 
     if (!_isValidSubtile(firstTile))
         return false;
 
-    const auto tileWidth = firstTile.width;
-    const auto tileHeight = firstTile.height;
-
-    uint currentX = 0;
-    uint currentY = 0;
-    bool eol = false;
+    _grid.tileWidth = firstTile.width;
+    _grid.tileHeight = firstTile.height;
+    _grid.columns = std::ceil(float(_frameSize.width()) / _grid.tileWidth);
+    _grid.rows = std::ceil(float(_frameSize.height()) / _grid.tileHeight);
 
-    for (auto i = _begin; i < _end; ++i)
-    {
-        const auto& tile = sortedTiles[i];
-        if (tile.y != currentY)
-        {
-            if (!eol || tile.y != currentY + tileHeight)
-                return false;
-            // Next line
-            currentY = tile.y;
-            currentX = 0;
-            eol = false;
-        }
+    return _matchesGrid(*_frame, _begin, _end);
+}
 
-        if (tile.height != tileHeight)
-        {
-            if (currentY + tile.height != (uint)_frameSize.height())
-                return false;
-        }
+bool PixelStreamChannelAssembler::_matchesGrid(
+    const deflect::server::Frame& frame, const size_t begin,
+    const size_t end) const
+{
+    if (end - begin != size_t(_grid.columns) * _grid.rows)
+        return false;
 
-        if (tile.x != currentX)
-            return false;
+    const uint frameWidth = _frameSize.width();
+    const uint frameHeight = _frameSize.height();
 
-        if (tile.width != tileWidth ||
-            currentX + tileWidth >= (uint)_frameSize.width())
+    for (auto i = begin; i < end; ++i)
+    {
+        const auto& tile = frame.tiles[i];
+        const uint x = ((i - begin) % _grid.columns) * _grid.tileWidth;
+        const uint y = ((i - begin) / _grid.columns) * _grid.tileHeight;
+        const auto width = std::min(_grid.tileWidth, frameWidth - x);
+        const auto height = std::min(_grid.tileHeight, frameHeight - y);
+
+        if (tile.x != x || tile.y != y || tile.width != width ||
+            tile.height != height)
         {
-            if (tile.x + tile.width != (uint)_frameSize.width())
-                return false;
-
-            eol = true;
+            return false;
         }
-
-        currentX += tile.width;
     }
     return true;
 }
@@ -202,67 +229,119 @@ uint PixelStreamChannelAssembler::_getTilesY() const
 
 void PixelStreamChannelAssembler::_initTargetFrame()
 {
-    _assembledFrame.reset(new deflect::server::Frame);
+    // Release the current frame first so that it can be recycled immediately
+    // if it is not used for rendering
+    _assembledFrame.reset();
+    _assembledFrame = _assembledFramesPool.acquire();
 
+    // The layout is fixed for the lifetime of the assembler, recycled tiles
+    // keep their geometry and image buffers.
     const auto tilesCount = getTilesCount();
     auto& tiles = _assembledFrame->tiles;
-    tiles.resize(tilesCount);
-    for (size_t i = 0; i < tilesCount; ++i)
+    if (tiles.size() != tilesCount)
     {
-        const auto tileRect = getTileRect(i);
-        tiles[i].width = tileRect.width();
-        tiles[i].height = tileRect.height();
-        tiles[i].x = tileRect.x();
-        tiles[i].y = tileRect.y();
+        tiles.resize(tilesCount);
+        for (size_t i = 0; i < tilesCount; ++i)
+        {
+            const auto tileRect = getTileRect(i);
+            tiles[i].width = tileRect.width();
+            tiles[i].height = tileRect.height();
+            tiles[i].x = tileRect.x();
+            tiles[i].y = tileRect.y();
+        }
     }
+    _isAssembled.assign(tilesCount, false);
 }
 
-Indices PixelStreamChannelAssembler::_findSourceTiles(
-    const uint tileIndex) const
+Indices PixelStreamChannelAssembler::_findUnchangedTiles(
+    const deflect::server::Frame& frame, const size_t begin) const
 {
-    Indices indices;
-    const auto tileRect = getTileRect(tileIndex);
-    for (auto i = _begin; i < _end; ++i)
+    const auto isSourceUnchanged = [&](const uint column, const uint row) {
+        const auto offset = row * _grid.columns + column;
+        return isUnchanged(_frame->tiles[_begin + offset],
+                           frame.tiles[begin + offset]);
+    };
+
+    Indices unchangedTiles;
+    for (uint i = 0; i < getTilesCount(); ++i)
     {
-        if (tileRect.intersects(toRect(_frame->tiles.at(i))))
-            indices.insert(i);
+        const auto sourceTiles = _findSourceTiles(i);
+        bool unchanged = true;
+        for (int row = sourceTiles.top();
+             unchanged && row <= sourceTiles.bottom(); ++row)
+        {
+            for (int col = sourceTiles.left();
+                 unchanged && col <= sourceTiles.right(); ++col)
+            {
+                unchanged = isSourceUnchanged(col, row);
+            }
+        }
+        if (unchanged)
+            unchangedTiles.insert(unchangedTiles.end(), i);
     }
-    return indices;
+    return unchangedTiles;
+}
+
+QRect PixelStreamChannelAssembler::_findSourceTiles(
+    const uint tileIndex) const
+{
+    const uint ratioX = targetTileSize / _grid.tileWidth;
+    const uint ratioY = targetTileSize / _grid.tileHeight;
+    const uint x = tileIndex % _getTilesX();
+    const uint y = tileIndex / _getTilesX();
+
+    const uint firstColumn = x * ratioX;
+    const uint firstRow = y * ratioY;
+    const uint lastColumn = std::min((x + 1) * ratioX, _grid.columns) - 1;
+    const uint lastRow = std::min((y + 1) * ratioY, _grid.rows) - 1;
+
+    return QRect{QPoint(firstColumn, firstRow), QPoint(lastColumn, lastRow)};
+}
+
+size_t PixelStreamChannelAssembler::_getSourceIndex(const uint column,
+                                                    const uint row) const
+{
+    return _begin + row * _grid.columns + column;
 }
 
 void PixelStreamChannelAssembler::_decodeSourceTiles(
-    const Indices& indices, deflect::server::TileDecoder& decoder)
+    const QRect& sourceTiles, deflect::server::TileDecoder& decoder)
 {
-    for (auto i : indices)
+    for (int row = sourceTiles.top(); row <= sourceTiles.bottom(); ++row)
     {
-        auto& tile = _frame->tiles.at(i);
-
-        if (tile.format == deflect::Format::jpeg)
-#ifndef DEFLECT_USE_LEGACY_LIBJPEGTURBO
-            decoder.decodeToYUV(tile);
-#else
-            decoder.decode(tile);
-#endif
+        for (int col = sourceTiles.left(); col <= sourceTiles.right(); ++col)
+        {
+            auto& tile = _frame->tiles.at(_getSourceIndex(col, row));
+            decode(tile, decoder, _scaleDivider);
+        }
     }
 }
 
 void PixelStreamChannelAssembler::_assembleTargetTile(const uint tileIndex,
-                                                      const Indices& indices)
+                                                      const QRect& sourceTiles)
 {
-    auto& target = _assembledFrame->tiles[tileIndex];
-    if (!target.imageData.isEmpty())
+    if (_isAssembled[tileIndex])
         return;
 
-    const auto format = _frame->tiles[*indices.begin()].format;
+    auto& target = _assembledFrame->tiles[tileIndex];
+
+    const auto firstSourceTile =
+        _getSourceIndex(sourceTiles.left(), sourceTiles.top());
+    const auto format = _frame->tiles[firstSourceTile].format;
 
-    StreamImage image{_assembledFrame, tileIndex};
+    StreamImage image{_assembledFrame, tileIndex, _scaleDivider};
     target.format = format;
     const auto dataSize =
         image.getDataSize(0) + image.getDataSize(1) + image.getDataSize(2);
-    target.imageData.resize(dataSize);
-    for (auto i : indices)
+    target.imageData.resize(dataSize); // no-op for recycled tiles
+    for (int row = sourceTiles.top(); row <= sourceTiles.bottom(); ++row)
     {
-        const auto tile = StreamImage{_frame, (uint)i};
-        image.copy(tile, tile.getPosition() - image.getPosition());
+        for (int col = sourceTiles.left(); col <= sourceTiles.right(); ++col)
+        {
+            const auto index = _getSourceIndex(col, row);
+            const auto tile = StreamImage{_frame, (uint)index, _scaleDivider};
+            image.copy(tile, tile.getPosition() - image.getPosition());
+        }
     }
+    _isAssembled[tileIndex] = true;
 }
@@ -42,6 +42,7 @@
 
 #include "types.h"
 
+#include "ObjectPool.h"
 #include "PixelStreamProcessor.h"
 
 #include <deflect/server/Frame.h>
@@ -54,6 +55,12 @@
  * The tile indices returned by computeVisibleSet() and taken by getTileRect() /
  * getTileImage() are specific to the current channel, i.e. they are in the
  * range [0; getTilesCount()-1].
+ *
+ * The source tiles must form a regular grid, which is indexed once when the
+ * assembler is created. Finding the source tiles of a target tile and the
+ * visible set are then simple arithmetic. Subsequent frames with the same
+ * layout can be processed by the same assembler using setFrame(), which
+ * recycles the buffers of previously assembled frames once they are released.
  */
 class PixelStreamChannelAssembler : public PixelStreamProcessor
 {
@@ -63,9 +70,29 @@ public:
      * @param frame to assemble with tiles sorted by channel and in left-right +
      *        top-bottom order.
      * @param channel target channel to assemble.
+     * @param scaleDivider to decode and assemble the tiles at a reduced
+     *        resolution. The assembled images are smaller than the rectangle
+     *        of their tile by this factor.
      * @throw std::runtime_error if the frame's channel cannot be assembled.
      */
-    PixelStreamChannelAssembler(deflect::server::FramePtr frame, uint channel);
+    PixelStreamChannelAssembler(deflect::server::FramePtr frame, uint channel,
+                                uint scaleDivider = 1);
+
+    /**
+     * Process a new frame, reusing the grid index of the previous one.
+     * @param frame to assemble with tiles sorted by channel and in left-right +
+     *        top-bottom order.
+     * @return false if the layout of the channel changed, in which case the
+     *         assembler is left unmodified and a new one must be created.
+     */
+    bool setFrame(deflect::server::FramePtr frame);
+
+    /**
+     * @copydoc PixelStreamProcessor::getUnchangedTiles
+     *
+     * A target tile is unchanged if all of its source tiles are unchanged.
+     */
+    Indices getUnchangedTiles() const final;
 
     /** @copydoc PixelStreamProcessor::getTileImage */
     ImagePtr getTileImage(uint tileIndex,
@@ -82,23 +109,42 @@ public:
     size_t getTilesCount() const final;
 
 private:
+    /** Regular grid formed by the source tiles of the channel. */
+    struct Grid
+    {
+        uint tileWidth = 0;
+        uint tileHeight = 0;
+        uint columns = 0;
+        uint rows = 0;
+    };
+
     deflect::server::FramePtr _frame;
     QSize _frameSize;
     uint _channel;
+    uint _scaleDivider;
     size_t _begin, _end;
+    Grid _grid;
+    ObjectPool<deflect::server::Frame> _assembledFramesPool;
     deflect::server::FramePtr _assembledFrame;
+    std::vector<char> _isAssembled;
+    Indices _unchangedTiles;
 
-    bool _canAssemble() const;
+    bool _buildGrid();
+    bool _matchesGrid(const deflect::server::Frame& frame, size_t begin,
+                      size_t end) const;
 
     uint _getTilesX() const;
     uint _getTilesY() const;
 
     void _initTargetFrame();
 
-    Indices _findSourceTiles(uint tileIndex) const;
-    void _decodeSourceTiles(const Indices& indices,
+    Indices _findUnchangedTiles(const deflect::server::Frame& frame,
+                                size_t begin) const;
+    QRect _findSourceTiles(uint tileIndex) const;
+    size_t _getSourceIndex(uint column, uint row) const;
+    void _decodeSourceTiles(const QRect& sourceTiles,
                             deflect::server::TileDecoder& decoder);
-    void _assembleTargetTile(uint tileIndex, const Indices& indices);
+    void _assembleTargetTile(uint tileIndex, const QRect& sourceTiles);
 };
 
 #endif
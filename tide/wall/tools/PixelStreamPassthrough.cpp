@@ -42,26 +42,41 @@
 #include "data/StreamImage.h"
 
 #include <deflect/server/Frame.h>
-#include <deflect/server/TileDecoder.h>
 
-PixelStreamPassthrough::PixelStreamPassthrough(deflect::server::FramePtr frame)
+PixelStreamPassthrough::PixelStreamPassthrough(deflect::server::FramePtr frame,
+                                               const uint scaleDivider)
     : _frame{std::move(frame)}
+    , _scaleDivider{scaleDivider}
 {
 }
 
 ImagePtr PixelStreamPassthrough::getTileImage(
     const uint tileIndex, deflect::server::TileDecoder& decoder)
 {
-    auto& tile = _frame->tiles.at(tileIndex);
-    if (tile.format == deflect::Format::jpeg)
+    decode(_frame->tiles.at(tileIndex), decoder, _scaleDivider);
+    return std::make_shared<StreamImage>(_frame, tileIndex, _scaleDivider);
+}
+
+bool PixelStreamPassthrough::setFrame(deflect::server::FramePtr frame)
+{
+    // Recreate the processor if the layout changed, in case the new frame can
+    // be assembled
+    if (!_hasSameLayout(*frame))
+        return false;
+
+    _unchangedTiles.clear();
+    for (size_t i = 0; i < frame->tiles.size(); ++i)
     {
-#ifndef DEFLECT_USE_LEGACY_LIBJPEGTURBO
-        decoder.decodeToYUV(tile);
-#else
-        decoder.decode(tile);
-#endif
+        if (isUnchanged(_frame->tiles[i], frame->tiles[i]))
+            _unchangedTiles.insert(_unchangedTiles.end(), i);
     }
-    return std::make_shared<StreamImage>(_frame, tileIndex);
+    _frame = std::move(frame);
+    return true;
+}
+
+Indices PixelStreamPassthrough::getUnchangedTiles() const
+{
+    return _unchangedTiles;
 }
 
 QRect PixelStreamPassthrough::getTileRect(const uint tileIndex) const
@@ -86,3 +101,22 @@ size_t PixelStreamPassthrough::getTilesCount() const
 {
     return _frame->tiles.size();
 }
+
+bool PixelStreamPassthrough::_hasSameLayout(
+    const deflect::server::Frame& frame) const
+{
+    if (frame.tiles.size() != _frame->tiles.size())
+        return false;
+
+    for (size_t i = 0; i < frame.tiles.size(); ++i)
+    {
+        const auto& tile = frame.tiles[i];
+        const auto& previous = _frame->tiles[i];
+        if (toRect(tile) != toRect(previous) ||
+            tile.channel != previous.channel)
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -51,13 +51,21 @@ public:
     /**
      * Construct a processor that does not modify the pixel stream.
      * @param frame to decode and expose.
+     * @param scaleDivider to decode the jpeg tiles at a reduced resolution.
      */
-    PixelStreamPassthrough(deflect::server::FramePtr frame);
+    PixelStreamPassthrough(deflect::server::FramePtr frame,
+                           uint scaleDivider = 1);
 
     /** @copydoc PixelStreamProcessor::getTileImage */
     ImagePtr getTileImage(uint tileIndex,
                           deflect::server::TileDecoder& decoder) final;
 
+    /** @copydoc PixelStreamProcessor::setFrame */
+    bool setFrame(deflect::server::FramePtr frame) final;
+
+    /** @copydoc PixelStreamProcessor::getUnchangedTiles */
+    Indices getUnchangedTiles() const final;
+
     /** @copydoc PixelStreamProcessor::getTileRect */
     QRect getTileRect(uint tileIndex) const final;
 
@@ -70,6 +78,10 @@ public:
 
 private:
     deflect::server::FramePtr _frame;
+    const uint _scaleDivider;
+    Indices _unchangedTiles;
+
+    bool _hasSameLayout(const deflect::server::Frame& frame) const;
 };
 
 #endif
@@ -39,7 +39,13 @@
 
 #include "PixelStreamProcessor.h"
 
+#if TIDE_USE_LIBJPEGTURBO
+#include "ScaledTileDecoder.h"
+#include <QThreadStorage>
+#endif
+
 #include <deflect/server/Tile.h>
+#include <deflect/server/TileDecoder.h>
 
 PixelStreamProcessor::~PixelStreamProcessor()
 {
@@ -49,3 +55,36 @@ QRect PixelStreamProcessor::toRect(const deflect::server::Tile& tile) const
 {
     return QRect(tile.x, tile.y, tile.width, tile.height);
 }
+
+void PixelStreamProcessor::decode(deflect::server::Tile& tile,
+                                  deflect::server::TileDecoder& decoder,
+                                  const uint scaleDivider) const
+{
+    if (tile.format != deflect::Format::jpeg)
+        return;
+
+    if (scaleDivider > 1)
+    {
+#if TIDE_USE_LIBJPEGTURBO
+        // turbojpeg handles need to be per thread
+        static QThreadStorage<ScaledTileDecoder> scaledDecoders;
+        scaledDecoders.localData().decode(tile, scaleDivider);
+        return;
+#else
+        throw std::logic_error("scaled jpeg decoding is not available");
+#endif
+    }
+
+#ifndef DEFLECT_USE_LEGACY_LIBJPEGTURBO
+    decoder.decodeToYUV(tile);
+#else
+    decoder.decode(tile);
+#endif
+}
+
+bool PixelStreamProcessor::isUnchanged(const deflect::server::Tile& previous,
+                                       const deflect::server::Tile& tile) const
+{
+    return previous.imageData.constData() == tile.imageData.constData() &&
+           toRect(previous) == toRect(tile) && previous.channel == tile.channel;
+}
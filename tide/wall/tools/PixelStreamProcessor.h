@@ -62,6 +62,21 @@ public:
     virtual ImagePtr getTileImage(uint tileIndex,
                                   deflect::server::TileDecoder& decoder) = 0;
 
+    /**
+     * Process a new frame with the same layout as the current one.
+     *
+     * @param frame the new frame to process.
+     * @return false if the processor can't be reused for this frame, in which
+     *         case it must be discarded.
+     */
+    virtual bool setFrame(deflect::server::FramePtr frame) = 0;
+
+    /**
+     * @return the tiles which are identical in the current frame and in the
+     *         previous one passed to setFrame().
+     */
+    virtual Indices getUnchangedTiles() const = 0;
+
     /** @return the rectangle of the tile. */
     virtual QRect getTileRect(uint tileIndex) const = 0;
 
@@ -75,6 +90,25 @@ public:
 protected:
     /** @return the coordinates of the tile as a QRect. */
     QRect toRect(const deflect::server::Tile& tile) const;
+
+    /**
+     * Decode a jpeg tile in place, other formats are left unmodified.
+     *
+     * @param tile to decode.
+     * @param decoder for full resolution jpeg decompression.
+     * @param scaleDivider to decode the tile at a reduced resolution.
+     * @throw std::runtime_error on tile decoding error.
+     */
+    void decode(deflect::server::Tile& tile,
+                deflect::server::TileDecoder& decoder,
+                uint scaleDivider) const;
+
+    /**
+     * @return true if the tile is the same as the previous one, i.e. they share
+     *         the same image data buffer and geometry.
+     */
+    bool isUnchanged(const deflect::server::Tile& previous,
+                     const deflect::server::Tile& tile) const;
 };
 
 #endif
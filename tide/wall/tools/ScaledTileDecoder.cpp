@@ -0,0 +1,164 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "ScaledTileDecoder.h"
+
+#include <deflect/server/Tile.h>
+
+#include <turbojpeg.h>
+
+#include <QString>
+
+#include <atomic>
+
+namespace
+{
+// Tiles decoded by a thread for the frames in flight; further tiles get
+// buffers of their own which are not recycled.
+const size_t maxRecycledBuffers = 128;
+
+int _scaled(const int size, const uint divider)
+{
+    return TJSCALED(size, (tjscalingfactor{1, int(divider)}));
+}
+
+#ifndef DEFLECT_USE_LEGACY_LIBJPEGTURBO
+deflect::Format _getFormat(const int subsampling)
+{
+    switch (subsampling)
+    {
+    case TJSAMP_444:
+        return deflect::Format::yuv444;
+    case TJSAMP_422:
+        return deflect::Format::yuv422;
+    case TJSAMP_420:
+        return deflect::Format::yuv420;
+    default:
+        throw std::runtime_error("unsupported jpeg chroma subsampling");
+    }
+}
+#endif
+
+void _throwError(const QString& message)
+{
+    throw std::runtime_error(
+        QString("%1: %2").arg(message, tjGetErrorStr()).toStdString());
+}
+}
+
+ScaledTileDecoder::ScaledTileDecoder()
+    : _handle{tjInitDecompress()}
+{
+    if (!_handle)
+        _throwError("libjpeg-turbo initialization failed");
+}
+
+ScaledTileDecoder::~ScaledTileDecoder()
+{
+    tjDestroy(_handle);
+}
+
+void ScaledTileDecoder::decode(deflect::server::Tile& tile, const uint divider)
+{
+    if (tile.format != deflect::Format::jpeg)
+        throw std::runtime_error("tile is not in jpeg format");
+
+    auto jpegData = (unsigned char*)tile.imageData.data();
+    const auto jpegSize = (unsigned long)tile.imageData.size();
+
+    int width = 0;
+    int height = 0;
+    int subsampling = 0;
+    if (tjDecompressHeader2(_handle, jpegData, jpegSize, &width, &height,
+                            &subsampling) != 0)
+    {
+        _throwError("reading jpeg header failed");
+    }
+
+    const auto scaledWidth = _scaled(width, divider);
+    const auto scaledHeight = _scaled(height, divider);
+
+#ifndef DEFLECT_USE_LEGACY_LIBJPEGTURBO
+    const auto format = _getFormat(subsampling);
+    const auto size =
+        tjBufSizeYUV2(scaledWidth, 1, scaledHeight, subsampling);
+    auto& decodedData = _getBuffer(int(size));
+    if (tjDecompressToYUV2(_handle, jpegData, jpegSize,
+                           (unsigned char*)decodedData.data(), scaledWidth, 1,
+                           scaledHeight, 0) != 0)
+    {
+        _throwError("scaled jpeg decoding failed");
+    }
+#else
+    const auto format = deflect::Format::rgba;
+    auto& decodedData = _getBuffer(scaledWidth * scaledHeight * 4);
+    if (tjDecompress2(_handle, jpegData, jpegSize,
+                      (unsigned char*)decodedData.data(), scaledWidth, 0,
+                      scaledHeight, TJPF_RGBX, 0) != 0)
+    {
+        _throwError("scaled jpeg decoding failed");
+    }
+#endif
+
+    tile.imageData = decodedData;
+    tile.format = format;
+}
+
+QByteArray& ScaledTileDecoder::_getBuffer(const int size)
+{
+    for (auto& buffer : _buffers)
+    {
+        // The buffer is free once the tiles which shared it are released
+        if (!buffer.isDetached())
+            continue;
+
+        // Pairs with the release of the last reference by the other thread
+        std::atomic_thread_fence(std::memory_order_acquire);
+        buffer.resize(size); // only reallocates if the size grows
+        return buffer;
+    }
+
+    if (_buffers.size() < maxRecycledBuffers)
+    {
+        _buffers.emplace_back(size, Qt::Uninitialized);
+        return _buffers.back();
+    }
+    _unrecycledBuffer = QByteArray(size, Qt::Uninitialized);
+    return _unrecycledBuffer;
+}
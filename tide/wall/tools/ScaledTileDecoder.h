@@ -0,0 +1,91 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef SCALEDTILEDECODER_H
+#define SCALEDTILEDECODER_H
+
+#include "types.h"
+
+#include <QByteArray>
+
+#include <vector>
+
+/**
+ * Decode jpeg tiles at a reduced resolution.
+ *
+ * The downscaling is done by libjpeg-turbo in the DCT domain, which is much
+ * faster than decoding the tiles at full resolution.
+ *
+ * The geometry of the decoded tiles is left unchanged, their image has a size
+ * of ceil(width / divider) x ceil(height / divider).
+ *
+ * The decoded images are written to buffers which the decoder recycles once
+ * the tiles sharing them are released, so that decoding a stream only
+ * allocates memory when the scaled size of its tiles grows.
+ *
+ * Not threadsafe, use one decoder per thread.
+ */
+class ScaledTileDecoder
+{
+public:
+    /** Create a decoder. @throw std::runtime_error on initialization error. */
+    ScaledTileDecoder();
+
+    /** Destructor. */
+    ~ScaledTileDecoder();
+
+    /**
+     * Decode a jpeg tile in place.
+     *
+     * The tile is decoded to YUV, or to RGBA with legacy libjpeg-turbo.
+     * @param tile to decode.
+     * @param divider the scale divider: 1, 2, 4 or 8.
+     * @throw std::runtime_error if the tile could not be decoded.
+     */
+    void decode(deflect::server::Tile& tile, uint divider);
+
+private:
+    void* _handle = nullptr;
+    std::vector<QByteArray> _buffers;
+    QByteArray _unrecycledBuffer;
+
+    QByteArray& _getBuffer(int size);
+};
+
+#endif
@@ -79,6 +79,8 @@ public:
         ++_version;
     }
 
+    /** @return true if the back object is waiting to be synchronized. */
+    bool hasPendingUpdate() const { return _frontObject != _backObject; }
     /** Synchronize the object. */
     bool sync(const SyncFunction& syncFunc)
     {
@@ -0,0 +1,212 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "TileDiskCache.h"
+
+#include "utils/log.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+
+#include <utime.h>
+
+namespace
+{
+// Stop evicting files when the cache is back below this ratio of its size
+const qreal evictionTarget = 0.9;
+
+// Qt maps PNG quality 80 to zlib level 2. Tiles are written once but read
+// many times, so a bit more encoding time buys smaller files and thus more
+// tiles within the size limit of the cache.
+const int pngQuality = 80;
+
+const QString fileSuffix = ".png";
+
+std::unique_ptr<TileDiskCache> _instance;
+
+QFileInfoList _listFiles(const QDir& dir)
+{
+    return dir.entryInfoList(QStringList{"*" + fileSuffix}, QDir::Files,
+                             QDir::Time);
+}
+
+qint64 _computeSize(const QFileInfoList& files)
+{
+    qint64 size = 0;
+    for (const auto& info : files)
+        size += info.size();
+    return size;
+}
+}
+
+TileDiskCache::TileDiskCache(const QString& directory, const qint64 maxSize)
+    : _dir{directory}
+    , _maxSize{maxSize}
+{
+    if (!_dir.mkpath("."))
+        throw std::runtime_error("cannot create tile cache directory: " +
+                                 directory.toStdString());
+    _diskUsage = _computeSize(_listFiles(_dir));
+}
+
+void TileDiskCache::configure(const QString& directory, const uint maxSizeMB)
+{
+    _instance.reset();
+    if (directory.isEmpty() || maxSizeMB == 0)
+        return;
+
+    try
+    {
+        const auto maxSize = qint64(maxSizeMB) * 1024 * 1024;
+        _instance = std::make_unique<TileDiskCache>(directory, maxSize);
+    }
+    catch (const std::runtime_error& e)
+    {
+        print_log(LOG_WARN, LOG_GENERAL, "Tile cache disabled: %s", e.what());
+    }
+}
+
+TileDiskCache* TileDiskCache::getInstance()
+{
+    return _instance.get();
+}
+
+QString TileDiskCache::makeKey(const QString& uri, const QSize& size,
+                               const uint tileId, const deflect::View view)
+{
+    const QFileInfo file{uri};
+    if (!file.exists())
+        return QString();
+
+    const auto id = QString("%1|%2|%3x%4|%5|%6")
+                        .arg(file.absoluteFilePath())
+                        .arg(file.lastModified().toMSecsSinceEpoch())
+                        .arg(size.width())
+                        .arg(size.height())
+                        .arg(tileId)
+                        .arg(int(view));
+    return QCryptographicHash::hash(id.toUtf8(), QCryptographicHash::Sha1)
+        .toHex();
+}
+
+QImage TileDiskCache::load(const QString& key)
+{
+    const auto filename = _getFilename(key);
+
+    QImage image;
+    if (!image.load(filename, "PNG"))
+    {
+        ++_misses;
+        return QImage();
+    }
+    ++_hits;
+
+    // Mark as recently used for the eviction
+    ::utime(QFile::encodeName(filename).constData(), nullptr);
+    return image;
+}
+
+void TileDiskCache::store(const QString& key, const QImage& image)
+{
+    const auto filename = _getFilename(key);
+    const auto tmpFilename = QString("%1.%2.%3")
+                                 .arg(filename)
+                                 .arg(QCoreApplication::applicationPid())
+                                 .arg(quintptr(QThread::currentThreadId()));
+
+    // Write to a temporary file first so that other processes never read a
+    // partially written tile
+    if (!image.save(tmpFilename, "PNG", pngQuality))
+    {
+        print_log(LOG_WARN, LOG_GENERAL, "could not write cache file: %s",
+                  tmpFilename.toLocal8Bit().constData());
+        QFile::remove(tmpFilename);
+        return;
+    }
+    const auto fileSize = QFileInfo{tmpFilename}.size();
+
+    // Fails if another process stored the same tile in the meantime
+    if (!QFile::rename(tmpFilename, filename))
+    {
+        QFile::remove(tmpFilename);
+        return;
+    }
+
+    const QMutexLocker lock(&_mutex);
+    _diskUsage += fileSize;
+    if (_diskUsage > _maxSize)
+        _evict();
+}
+
+TileCacheStatistics TileDiskCache::getStatistics() const
+{
+    TileCacheStatistics stats;
+    stats.hits = _hits;
+    stats.misses = _misses;
+    {
+        const QMutexLocker lock(&_mutex);
+        stats.diskUsage = uint64_t(_diskUsage);
+    }
+    return stats;
+}
+
+QString TileDiskCache::_getFilename(const QString& key) const
+{
+    return _dir.filePath(key + fileSuffix);
+}
+
+void TileDiskCache::_evict()
+{
+    // Other processes may have added or removed files, start from the current
+    // content of the directory (most recently used first).
+    const auto files = _listFiles(_dir);
+    auto size = _computeSize(files);
+
+    const auto target = qint64(_maxSize * evictionTarget);
+    for (auto it = files.rbegin(); it != files.rend() && size > target; ++it)
+    {
+        if (QFile::remove(it->absoluteFilePath()))
+            size -= it->size();
+    }
+    _diskUsage = size;
+}
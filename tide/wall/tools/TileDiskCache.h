@@ -0,0 +1,126 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                          Raphael Dumusc <raphael.dumusc@epfl.ch>  */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef TILEDISKCACHE_H
+#define TILEDISKCACHE_H
+
+#include "data/TileCacheStatistics.h"
+#include "types.h"
+
+#include <QDir>
+#include <QImage>
+#include <QMutex>
+
+#include <atomic>
+
+/**
+ * Persistent cache of rendered tiles, shared by the processes of a host.
+ *
+ * Tiles are stored as individual files named after a key which identifies the
+ * content (path, modification time and size) and the tile. Files are written
+ * atomically so that several processes can use the same directory. When the
+ * cache grows beyond its maximum size, the least recently used files are
+ * removed based on their modification time, which is updated on every hit.
+ */
+class TileDiskCache
+{
+public:
+    /**
+     * Create a cache.
+     * @param directory where to store the tiles, created if needed
+     * @param maxSize maximum size of the directory in bytes
+     * @throw std::runtime_error if the directory can't be created
+     */
+    TileDiskCache(const QString& directory, qint64 maxSize);
+
+    /**
+     * Enable or disable the cache used by the data sources of this process.
+     * @param directory where to store the tiles, empty to disable the cache
+     * @param maxSizeMB maximum size of the directory in megabytes
+     */
+    static void configure(const QString& directory, uint maxSizeMB);
+
+    /** @return the cache used by the data sources, nullptr if disabled. */
+    static TileDiskCache* getInstance();
+
+    /**
+     * Get the key of a tile.
+     * @param uri of the content, which must be a local file
+     * @param size of the content at the highest resolution
+     * @param tileId unique identifier of the tile in the content (includes the
+     *        page and lod for multi-page, multi-lod contents)
+     * @param view of the tile
+     * @return the key to use for load and store, empty if the file does not
+     *         exist.
+     */
+    static QString makeKey(const QString& uri, const QSize& size, uint tileId,
+                           deflect::View view);
+
+    /**
+     * Load a tile from the cache, threadsafe.
+     * @param key of the tile
+     * @return the tile image, or a null image on cache miss.
+     */
+    QImage load(const QString& key);
+
+    /**
+     * Store a tile in the cache, threadsafe.
+     * @param key of the tile
+     * @param image to store
+     */
+    void store(const QString& key, const QImage& image);
+
+    /** @return the statistics of this cache instance, threadsafe. */
+    TileCacheStatistics getStatistics() const;
+
+private:
+    const QDir _dir;
+    const qint64 _maxSize;
+
+    std::atomic<uint64_t> _hits{0};
+    std::atomic<uint64_t> _misses{0};
+
+    mutable QMutex _mutex;
+    qint64 _diskUsage = 0;
+
+    QString _getFilename(const QString& key) const;
+    void _evict();
+};
+
+#endif
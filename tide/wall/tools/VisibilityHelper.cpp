@@ -42,6 +42,96 @@
 #include "scene/DisplayGroup.h"
 #include "scene/Window.h"
 
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace
+{
+const int maxGridCells = 64;
+
+bool _isOccluder(const Window& window, const bool alphaBlending)
+{
+    return !window.isHidden() &&
+           (!alphaBlending || !window.getContent().hasTransparency());
+}
+
+/**
+ * Uniform grid over the visible area which stores the indices of the windows
+ * that overlap each of its cells.
+ */
+class OcclusionGrid
+{
+public:
+    OcclusionGrid(const WindowPtrs& windows, const QRect& area,
+                  const bool alphaBlending)
+        : _area{area}
+    {
+        if (_area.isEmpty())
+            return;
+
+        const auto cells = int(std::ceil(std::sqrt(windows.size())));
+        _gridSize = std::max(1, std::min(cells, maxGridCells));
+        _cellSize = QSizeF(_area.width(), _area.height()) / _gridSize;
+        _cells.resize(_gridSize * _gridSize);
+
+        for (size_t i = 0; i < windows.size(); ++i)
+        {
+            if (!_isOccluder(*windows[i], alphaBlending))
+                continue;
+
+            const auto& coords = windows[i]->getDisplayCoordinates();
+            const auto range = _getCellRange(coords);
+            for (auto y = range.top(); y <= range.bottom(); ++y)
+                for (auto x = range.left(); x <= range.right(); ++x)
+                    _cells[y * _gridSize + x].push_back(i);
+        }
+    }
+
+    /** @return the sorted indices of the windows which may overlap rect. */
+    std::vector<size_t> getCandidates(const QRectF& rect) const
+    {
+        std::vector<size_t> candidates;
+        const auto range = _getCellRange(rect);
+        for (auto y = range.top(); y <= range.bottom(); ++y)
+        {
+            for (auto x = range.left(); x <= range.right(); ++x)
+            {
+                const auto& cell = _cells[y * _gridSize + x];
+                candidates.insert(candidates.end(), cell.begin(), cell.end());
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                         candidates.end());
+        return candidates;
+    }
+
+private:
+    QRectF _area;
+    int _gridSize = 0;
+    QSizeF _cellSize;
+    std::vector<std::vector<size_t>> _cells;
+
+    QRect _getCellRange(const QRectF& rect) const
+    {
+        const auto overlap = rect.intersected(_area);
+        if (overlap.isEmpty() || _cells.empty())
+            return QRect();
+
+        const auto toCell = [this](const qreal pos, const qreal cellSize) {
+            return std::max(0, std::min(int(pos / cellSize), _gridSize - 1));
+        };
+        const auto topLeft = overlap.topLeft() - _area.topLeft();
+        const auto bottomRight = overlap.bottomRight() - _area.topLeft();
+        return QRect(QPoint(toCell(topLeft.x(), _cellSize.width()),
+                            toCell(topLeft.y(), _cellSize.height())),
+                     QPoint(toCell(bottomRight.x(), _cellSize.width()),
+                            toCell(bottomRight.y(), _cellSize.height())));
+    }
+};
+}
+
 VisibilityHelper::VisibilityHelper(const DisplayGroup& displayGroup,
                                    const QRect& visibleArea,
                                    const bool alphaBlending)
@@ -91,6 +181,42 @@ QRectF _globalToWindowCoordinates(const QRectF& area, const QRectF& window)
 }
 
 QRectF VisibilityHelper::getVisibleArea(const Window& window) const
+{
+    const auto& windows = _displayGroup.getWindows();
+    const auto it = std::find_if(windows.begin(), windows.end(),
+                                 [&window](const WindowPtr& win) {
+                                     return win->getID() == window.getID();
+                                 });
+    const auto index = size_t(std::distance(windows.begin(), it));
+
+    return _getVisibleArea(window, index, [&windows](const QRectF&) {
+        auto candidates = std::vector<size_t>(windows.size());
+        std::iota(candidates.begin(), candidates.end(), 0);
+        return candidates;
+    });
+}
+
+std::vector<QRectF> VisibilityHelper::getVisibleAreas() const
+{
+    const auto& windows = _displayGroup.getWindows();
+    const auto grid = OcclusionGrid{windows, _visibleArea, _alphaBlending};
+
+    std::vector<QRectF> areas;
+    areas.reserve(windows.size());
+    for (size_t i = 0; i < windows.size(); ++i)
+    {
+        areas.push_back(
+            _getVisibleArea(*windows[i], i, [&grid](const QRectF& area) {
+                return grid.getCandidates(area);
+            }));
+    }
+    return areas;
+}
+
+template <typename GetCandidates>
+QRectF VisibilityHelper::_getVisibleArea(const Window& window,
+                                         const size_t index,
+                                         GetCandidates getCandidates) const
 {
     const auto& windowCoords = window.getDisplayCoordinates();
 
@@ -107,22 +233,22 @@ QRectF VisibilityHelper::getVisibleArea(const Window& window) const
     if (window.isFocused())
         return _globalToWindowCoordinates(area, windowCoords);
 
-    auto winIsAbove = false;
-    for (const auto& win : _displayGroup.getWindows())
+    // Windows which do not overlap the initial area can never cut it, so only
+    // the candidates are processed (in stacking order, like all windows).
+    const auto& windows = _displayGroup.getWindows();
+    for (const auto i : getCandidates(area))
     {
-        if (win->getID() == window.getID())
-        {
-            winIsAbove = !window.isPanel(); // panels are above regular windows
+        if (i == index)
             continue;
-        }
-        if (win->isHidden())
+
+        const auto& win = *windows[i];
+        if (!_isOccluder(win, _alphaBlending))
             continue;
 
-        if ((winIsAbove || win->isFocused()) &&
-            (!_alphaBlending || !win->getContent().hasTransparency()))
-        {
-            area = _cutOverlap(area, win->getDisplayCoordinates());
-        }
+        // panels are above regular windows
+        const auto winIsAbove = i > index && !window.isPanel();
+        if (winIsAbove || win.isFocused())
+            area = _cutOverlap(area, win.getDisplayCoordinates());
 
         if (area.isEmpty())
             return QRectF();
@@ -51,12 +51,26 @@ public:
     VisibilityHelper(const DisplayGroup& displayGroup, const QRect& visibleArea,
                      bool alphaBlending);
 
+    /** @return the visible area of a single window, in window coordinates. */
     QRectF getVisibleArea(const Window& window) const;
 
+    /**
+     * Get the visible areas of all windows of the group in a single pass.
+     *
+     * The occluding windows are indexed in a spatial grid so that each window
+     * is only tested against its neighbours instead of all windows above it.
+     * @return the visible areas in the order of DisplayGroup::getWindows().
+     */
+    std::vector<QRectF> getVisibleAreas() const;
+
 private:
     const DisplayGroup& _displayGroup;
     const QRect& _visibleArea;
     bool _alphaBlending = false;
+
+    template <typename GetCandidates>
+    QRectF _getVisibleArea(const Window& window, size_t index,
+                           GetCandidates getCandidates) const;
 };
 
 #endif